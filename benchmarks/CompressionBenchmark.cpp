@@ -0,0 +1,93 @@
+/*
+ * Copyright 2020 WolkAbout Technology s.r.o.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "utilities/Gzip.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <iomanip>
+#include <iostream>
+#include <random>
+#include <string>
+
+namespace
+{
+const std::size_t COMPRESSED_BYTES_PER_RUN = 50 * 1024 * 1024;
+
+// Mirrors payload of JsonProtocol for sensor readings of several references
+std::string sensorReadingsPayload(std::size_t readings)
+{
+    std::mt19937 generator{42};
+    std::normal_distribution<double> noise{0.0, 0.5};
+
+    std::string payload = "{";
+    const std::size_t references = 10;
+    for (std::size_t reference = 0; reference < references; ++reference)
+    {
+        payload += (reference == 0 ? "\"" : ",\"") + std::string{"REF"} + std::to_string(reference) + "\":[";
+        for (std::size_t i = reference; i < readings; i += references)
+        {
+            payload += (i == reference ? "" : ",");
+            payload += "{\"utc\":" + std::to_string(1600000000000ull + i * 100) +
+                       ",\"data\":\"" + std::to_string(20.0 + reference + noise(generator)) + "\"}";
+        }
+        payload += "]";
+    }
+
+    return payload + "}";
+}
+}    // namespace
+
+int main()
+{
+    std::cout << "Gzip compression of sensor reading payloads" << std::endl;
+    std::cout << std::setw(10) << "readings" << std::setw(8) << "level" << std::setw(12) << "bytes" << std::setw(12)
+              << "compressed" << std::setw(8) << "ratio" << std::setw(14) << "us/message" << std::setw(18)
+              << "saved MB/cpu s" << std::endl;
+
+    for (std::size_t readings : {10u, 50u, 200u, 1000u})
+    {
+        const auto payload = sensorReadingsPayload(readings);
+        const auto runs = std::max<std::size_t>(1, COMPRESSED_BYTES_PER_RUN / payload.size() / 10);
+
+        for (int level : {1, wolkabout::Gzip::DEFAULT_LEVEL, 9})
+        {
+            std::string compressed;
+            std::size_t compressedSize = 0;
+
+            const auto start = std::chrono::steady_clock::now();
+            for (std::size_t run = 0; run < runs; ++run)
+            {
+                wolkabout::Gzip::compress(payload, compressed, level);
+                compressedSize += compressed.size();
+            }
+            const auto elapsed = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+            const auto averageSize = static_cast<double>(compressedSize) / runs;
+            const auto saved = static_cast<double>(payload.size()) * runs - static_cast<double>(compressedSize);
+
+            std::cout << std::setw(10) << readings << std::setw(8) << level << std::setw(12) << payload.size()
+                      << std::setw(12) << std::fixed << std::setprecision(0) << averageSize << std::setw(7)
+                      << std::setprecision(1) << payload.size() / averageSize << "x" << std::setw(14)
+                      << std::setprecision(1) << elapsed * 1e6 / runs << std::setw(18) << saved / elapsed / 1e6
+                      << std::endl;
+        }
+    }
+
+    return 0;
+}
@@ -0,0 +1,110 @@
+/*
+ * Copyright 2020 WolkAbout Technology s.r.o.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "model/Message.h"
+#include "model/SensorReading.h"
+#include "protocol/DataProtocol.h"
+#include "protocol/cbor/CborProtocol.h"
+#include "protocol/json/JsonProtocol.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <iomanip>
+#include <iostream>
+#include <memory>
+#include <random>
+#include <string>
+#include <vector>
+
+namespace
+{
+const std::size_t READINGS_PER_RUN = 2000000;
+
+std::vector<std::shared_ptr<wolkabout::SensorReading>> sensorReadings(std::size_t count, std::size_t references)
+{
+    std::mt19937 generator{42};
+    std::normal_distribution<double> noise{0.0, 0.5};
+
+    std::vector<std::shared_ptr<wolkabout::SensorReading>> readings;
+    readings.reserve(count);
+    for (std::size_t i = 0; i < count; ++i)
+    {
+        const auto reference = i % references;
+
+        // Two decimals, like most sensors report
+        const auto value = static_cast<double>(static_cast<long long>((20.0 + reference + noise(generator)) * 100));
+        readings.push_back(std::make_shared<wolkabout::SensorReading>(
+          std::to_string(value / 100).substr(0, 5), "REF" + std::to_string(reference), 1600000000000ull + i * 100));
+    }
+
+    return readings;
+}
+
+struct Result
+{
+    double readingsPerSecond;
+    double bytesPerReading;
+};
+
+Result measure(const wolkabout::DataProtocol& protocol,
+               const std::vector<std::shared_ptr<wolkabout::SensorReading>>& readings)
+{
+    const auto runs = std::max<std::size_t>(1, READINGS_PER_RUN / readings.size());
+
+    std::size_t bytes = 0;
+    const auto start = std::chrono::steady_clock::now();
+    for (std::size_t run = 0; run < runs; ++run)
+    {
+        const auto message = protocol.makeMessage("DEVICE_KEY", readings);
+        bytes += message->getContent().size();
+    }
+    const auto elapsed = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+    return {static_cast<double>(runs * readings.size()) / elapsed,
+            static_cast<double>(bytes) / static_cast<double>(runs * readings.size())};
+}
+}    // namespace
+
+int main()
+{
+    const wolkabout::JsonProtocol json;
+    const wolkabout::CborProtocol cbor;
+
+    std::cout << "Sensor reading messages, " << READINGS_PER_RUN << " readings per run" << std::endl;
+    std::cout << std::setw(10) << "readings" << std::setw(12) << "references" << std::setw(16) << "JSON/s"
+              << std::setw(16) << "CBOR/s" << std::setw(14) << "JSON B/item" << std::setw(14) << "CBOR B/item"
+              << std::endl;
+
+    for (std::size_t count : {10u, 50u, 500u})
+    {
+        for (std::size_t references : {1u, 10u})
+        {
+            const auto readings = sensorReadings(count, references);
+
+            const auto jsonResult = measure(json, readings);
+            const auto cborResult = measure(cbor, readings);
+
+            std::cout << std::setw(10) << count << std::setw(12) << references << std::setw(16) << std::fixed
+                      << std::setprecision(0) << jsonResult.readingsPerSecond << std::setw(16)
+                      << cborResult.readingsPerSecond << std::setw(14) << std::setprecision(1)
+                      << jsonResult.bytesPerReading << std::setw(14) << cborResult.bytesPerReading << std::endl;
+        }
+    }
+
+    return 0;
+}
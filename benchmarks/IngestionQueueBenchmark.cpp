@@ -0,0 +1,166 @@
+/*
+ * Copyright 2020 WolkAbout Technology s.r.o.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "ingestion/IngestionQueue.h"
+#include "model/ReadingValue.h"
+#include "utilities/CommandBuffer.h"
+#include "utilities/ReferenceRegistry.h"
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <functional>
+#include <iomanip>
+#include <iostream>
+#include <memory>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace
+{
+const std::uint64_t READINGS_PER_RUN = 400000;
+
+struct Sink
+{
+    std::atomic<std::uint64_t> consumed{0};
+    std::atomic<std::uint64_t> checksum{0};
+
+    void consume(const std::string& reference, const std::string& value, unsigned long long rtc)
+    {
+        checksum.fetch_add(reference.size() + value.size() + rtc, std::memory_order_relaxed);
+        consumed.fetch_add(1, std::memory_order_release);
+    }
+
+    void consume(wolkabout::ReferenceHandle handle, const wolkabout::ReadingValue& value, unsigned long long rtc)
+    {
+        checksum.fetch_add(handle.id + value.size() + rtc, std::memory_order_relaxed);
+        consumed.fetch_add(1, std::memory_order_release);
+    }
+
+    void waitFor(std::uint64_t count)
+    {
+        while (consumed.load(std::memory_order_acquire) < count)
+        {
+            std::this_thread::yield();
+        }
+    }
+};
+
+template <typename Producer> double measure(unsigned int producers, Producer produce, Sink& sink)
+{
+    const std::uint64_t perProducer = READINGS_PER_RUN / producers;
+
+    const auto start = std::chrono::steady_clock::now();
+
+    std::vector<std::thread> threads;
+    for (unsigned int i = 0; i < producers; ++i)
+    {
+        threads.emplace_back([=] {
+            for (std::uint64_t reading = 0; reading < perProducer; ++reading)
+            {
+                produce(i, reading);
+            }
+        });
+    }
+
+    for (auto& thread : threads)
+    {
+        thread.join();
+    }
+
+    sink.waitFor(perProducer * producers);
+
+    const auto elapsed = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    return static_cast<double>(perProducer * producers) / elapsed;
+}
+
+double commandBufferThroughput(unsigned int producers)
+{
+    Sink sink;
+    wolkabout::CommandBuffer commandBuffer;
+
+    const auto result = measure(
+      producers,
+      [&](unsigned int producer, std::uint64_t reading) {
+          const std::string reference = "REF" + std::to_string(producer);
+          const std::string value = std::to_string(reading);
+          const unsigned long long rtc = reading;
+
+          // Mirrors Wolk::addSensorReading prior to the ingestion queue and typed readings
+          std::function<void()> command = [=, &sink] { sink.consume(reference, value, rtc); };
+          commandBuffer.pushCommand(std::make_shared<std::function<void()>>(command));
+      },
+      sink);
+
+    commandBuffer.stop();
+    return result;
+}
+
+double ingestionQueueThroughput(unsigned int producers)
+{
+    Sink sink;
+    wolkabout::IngestionQueue queue{[&](std::vector<wolkabout::IngestionRecord>& records) {
+        for (const auto& record : records)
+        {
+            sink.consume(record.handle, record.value, record.rtc);
+        }
+    }};
+
+    // Mirrors Wolk::addSensorReading, which interns each reference once and then enqueues its handle
+    wolkabout::ReferenceRegistry registry;
+    std::vector<wolkabout::ReferenceHandle> handles;
+    for (unsigned int producer = 0; producer < producers; ++producer)
+    {
+        handles.push_back(registry.intern("REF" + std::to_string(producer)));
+    }
+
+    const auto result = measure(
+      producers,
+      [&](unsigned int producer, std::uint64_t reading) {
+          wolkabout::IngestionRecord record;
+          record.type = wolkabout::IngestionRecord::Type::SENSOR_READING;
+          record.handle = handles[producer];
+          record.value = wolkabout::ReadingValue{reading};
+          record.rtc = reading;
+
+          queue.push(std::move(record));
+      },
+      sink);
+
+    queue.stop();
+    return result;
+}
+}    // namespace
+
+int main()
+{
+    std::cout << "Sensor readings per second, " << READINGS_PER_RUN << " readings per run" << std::endl;
+    std::cout << std::setw(10) << "producers" << std::setw(18) << "CommandBuffer" << std::setw(18) << "IngestionQueue"
+              << std::setw(10) << "speedup" << std::endl;
+
+    for (unsigned int producers : {1u, 4u, 16u})
+    {
+        const auto baseline = commandBufferThroughput(producers);
+        const auto queue = ingestionQueueThroughput(producers);
+
+        std::cout << std::setw(10) << producers << std::setw(18) << std::fixed << std::setprecision(0) << baseline
+                  << std::setw(18) << queue << std::setw(9) << std::setprecision(2) << queue / baseline << "x"
+                  << std::endl;
+    }
+
+    return 0;
+}
@@ -0,0 +1,137 @@
+/*
+ * Copyright 2020 WolkAbout Technology s.r.o.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "model/Message.h"
+#include "model/SensorReading.h"
+#include "protocol/DataProtocol.h"
+#include "protocol/json/JsonProtocol.h"
+#include "protocol/json/StreamingJsonProtocol.h"
+
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <cstdlib>
+#include <iomanip>
+#include <iostream>
+#include <memory>
+#include <new>
+#include <string>
+#include <vector>
+
+namespace
+{
+std::atomic<std::uint64_t> allocations{0};
+}    // namespace
+
+void* operator new(std::size_t size)
+{
+    allocations.fetch_add(1, std::memory_order_relaxed);
+    if (void* memory = std::malloc(size == 0 ? 1 : size))
+    {
+        return memory;
+    }
+
+    throw std::bad_alloc();
+}
+
+void operator delete(void* memory) noexcept
+{
+    std::free(memory);
+}
+
+void operator delete(void* memory, std::size_t) noexcept
+{
+    std::free(memory);
+}
+
+namespace
+{
+const std::size_t MESSAGES_PER_RUN = 20000;
+
+std::vector<std::shared_ptr<wolkabout::SensorReading>> sensorReadings(std::size_t count, std::size_t references)
+{
+    std::vector<std::shared_ptr<wolkabout::SensorReading>> readings;
+    readings.reserve(count);
+    for (std::size_t i = 0; i < count; ++i)
+    {
+        readings.push_back(std::make_shared<wolkabout::SensorReading>(
+          std::to_string(20 + i % 10) + "." + std::to_string(i % 100), "REFERENCE" + std::to_string(i % references),
+          1600000000000ull + i * 100));
+    }
+
+    return readings;
+}
+
+struct Result
+{
+    double microsecondsPerMessage;
+    double allocationsPerMessage;
+    std::string payload;
+};
+
+Result measure(const wolkabout::DataProtocol& protocol,
+               const std::vector<std::shared_ptr<wolkabout::SensorReading>>& readings)
+{
+    // Warm up reusable buffers
+    auto message = protocol.makeMessage("DEVICE_KEY", readings);
+    const auto payload = message->getContent();
+    message.reset();
+
+    const auto allocationsBefore = allocations.load();
+    const auto start = std::chrono::steady_clock::now();
+    for (std::size_t i = 0; i < MESSAGES_PER_RUN; ++i)
+    {
+        message = protocol.makeMessage("DEVICE_KEY", readings);
+    }
+    const auto elapsed = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    const auto allocationsAfter = allocations.load();
+
+    return {elapsed * 1e6 / MESSAGES_PER_RUN,
+            static_cast<double>(allocationsAfter - allocationsBefore) / MESSAGES_PER_RUN, payload};
+}
+}    // namespace
+
+int main()
+{
+    const wolkabout::JsonProtocol json;
+    const wolkabout::StreamingJsonProtocol streaming;
+
+    std::cout << "Sensor reading message serialization, " << MESSAGES_PER_RUN << " messages per run" << std::endl;
+    std::cout << std::setw(10) << "readings" << std::setw(12) << "references" << std::setw(14) << "JSON us"
+              << std::setw(14) << "stream us" << std::setw(14) << "JSON allocs" << std::setw(14) << "stream allocs"
+              << std::setw(11) << "identical" << std::endl;
+
+    for (std::size_t count : {1u, 10u, 50u, 200u})
+    {
+        for (std::size_t references : {1u, 10u})
+        {
+            const auto readings = sensorReadings(count, references);
+
+            const auto jsonResult = measure(json, readings);
+            const auto streamingResult = measure(streaming, readings);
+
+            std::cout << std::setw(10) << count << std::setw(12) << references << std::setw(14) << std::fixed
+                      << std::setprecision(2) << jsonResult.microsecondsPerMessage << std::setw(14)
+                      << streamingResult.microsecondsPerMessage << std::setw(14) << std::setprecision(1)
+                      << jsonResult.allocationsPerMessage << std::setw(14) << streamingResult.allocationsPerMessage
+                      << std::setw(11) << (jsonResult.payload == streamingResult.payload ? "yes" : "NO")
+                      << std::endl;
+        }
+    }
+
+    return 0;
+}
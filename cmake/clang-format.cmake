@@ -17,6 +17,7 @@ add_custom_target(format
                                                                        ${FULL_EXAMPLE_HEADER_FILES} ${FULL_EXAMPLE_SOURCE_FILES}
                                                                        ${SIMPLE_EXAMPLE_HEADER_FILES} ${SIMPLE_EXAMPLE_SOURCE_FILES}
                                                                        ${TEST_HEADER_FILES} ${TEST_SOURCE_FILES}
+                                                                       ${BENCHMARK_SOURCE_FILES}
                   WORKING_DIRECTORY "${CMAKE_BINARY_DIR}"
                   COMMENT "[Formatting source code]"
                   VERBATIM)
@@ -34,18 +34,30 @@
 #include "service/keep_alive/KeepAliveService.h"
 #include "utilities/Logger.h"
 
+#include <algorithm>
+#include <future>
 #include <initializer_list>
 #include <memory>
 #include <sstream>
 #include <string>
-#include <thread>
 #include <utility>
 
 namespace wolkabout
 {
 const constexpr std::chrono::seconds Wolk::KEEP_ALIVE_INTERVAL;
 
-Wolk::~Wolk() = default;
+const std::string Wolk::ACTUATOR_SYNC_KEY_PREFIX = "actuator/";
+const std::string Wolk::CONFIGURATION_SYNC_KEY = "configuration";
+
+Wolk::~Wolk()
+{
+    // lanes hand work to each other, so all of them are stopped before any of them is destroyed
+    m_connectionManager.reset();
+
+    m_ingestionQueue->stop();
+    m_egressQueue->stop();
+    m_controlQueue->stop();
+}
 
 WolkBuilder Wolk::newBuilder(Device device)
 {
@@ -53,17 +65,86 @@ WolkBuilder Wolk::newBuilder(Device device)
 }
 
 void Wolk::addSensorReading(const std::string& reference, std::string value, unsigned long long rtc)
+{
+    addSensorReading(reference, ReadingValue{std::move(value)}, rtc);
+}
+
+void Wolk::addSensorReading(const std::string& reference, const std::vector<std::string> values,
+                            unsigned long long int rtc)
+{
+    if (values.empty())
+    {
+        return;
+    }
+
+    addSensorReading(reference, ReadingValue{values}, rtc);
+}
+
+void Wolk::addSensorReading(const std::string& reference, ReadingValue value, unsigned long long int rtc)
 {
     if (rtc == 0)
     {
         rtc = Wolk::currentRtc();
     }
 
-    addToCommandBuffer([=]() -> void { m_dataService->addSensorReading(reference, value, rtc); });
+    addSensorReading(internReference(reference), std::move(value), rtc);
 }
 
-void Wolk::addSensorReading(const std::string& reference, const std::vector<std::string> values,
-                            unsigned long long int rtc)
+void Wolk::addSensorReading(ReferenceHandle handle, ReadingValue value, unsigned long long int rtc)
+{
+    if (rtc == 0)
+    {
+        rtc = Wolk::currentRtc();
+    }
+
+    if (!acceptReading(handle, value, rtc))
+    {
+        return;
+    }
+
+    IngestionRecord record;
+    record.type = IngestionRecord::Type::SENSOR_READING;
+    record.handle = handle;
+    record.value = std::move(value);
+    record.rtc = rtc;
+
+    addToCommandBuffer(std::move(record));
+}
+
+void Wolk::addSensorReadings(std::vector<ReadingEntry> readings)
+{
+    unsigned long long int rtc = 0;
+    for (auto& reading : readings)
+    {
+        if (reading.rtc == 0)
+        {
+            rtc = rtc == 0 ? Wolk::currentRtc() : rtc;
+            reading.rtc = rtc;
+        }
+    }
+
+    if (m_deadbandFilter || m_bufferLimiter)
+    {
+        readings.erase(std::remove_if(readings.begin(), readings.end(),
+                                      [this](const ReadingEntry& reading) {
+                                          return !acceptReading(reading.reference, reading.value, reading.rtc);
+                                      }),
+                       readings.end());
+    }
+
+    if (readings.empty())
+    {
+        return;
+    }
+
+    IngestionRecord record;
+    record.type = IngestionRecord::Type::SENSOR_READINGS;
+    record.readings = std::move(readings);
+
+    addToCommandBuffer(std::move(record));
+}
+
+void Wolk::addSnapshot(unsigned long long int rtc, const std::map<std::string, ReadingValue>& values)
 {
     if (values.empty())
     {
@@ -75,43 +156,194 @@ void Wolk::addSensorReading(const std::string& reference, const std::vector<std:
         rtc = Wolk::currentRtc();
     }
 
-    addToCommandBuffer([=]() -> void { m_dataService->addSensorReading(reference, values, rtc); });
+    std::vector<ReadingEntry> readings;
+    readings.reserve(values.size());
+    for (const auto& value : values)
+    {
+        if (acceptReading(value.first, value.second, rtc))
+        {
+            readings.emplace_back(value.first, value.second, rtc);
+        }
+    }
+
+    if (readings.empty())
+    {
+        return;
+    }
+
+    IngestionRecord record;
+    record.type = IngestionRecord::Type::SENSOR_READINGS;
+    record.readings = std::move(readings);
+
+    addToCommandBuffer(std::move(record));
 }
 
 void Wolk::addAlarm(const std::string& reference, bool active, unsigned long long rtc)
+{
+    addAlarm(internReference(reference), active, rtc);
+}
+
+void Wolk::addAlarm(ReferenceHandle handle, bool active, unsigned long long int rtc)
 {
     if (rtc == 0)
     {
         rtc = Wolk::currentRtc();
     }
 
-    addToCommandBuffer([=]() -> void { m_dataService->addAlarm(reference, active, rtc); });
+    IngestionRecord record;
+    record.type = IngestionRecord::Type::ALARM;
+    record.handle = handle;
+    record.active = active;
+    record.rtc = rtc;
+
+    addToCommandBuffer(std::move(record));
+}
+
+DropStatistics Wolk::getDropStatistics() const
+{
+    return m_bufferLimiter ? m_bufferLimiter->getDropStatistics() : DropStatistics{};
+}
+
+SuppressedPublishes Wolk::getSuppressedPublishes() const
+{
+    return m_dataService->getSuppressedPublishes();
+}
+
+CommandLatency Wolk::getCommandLatency() const
+{
+    CommandLatency latency;
+
+    latency.control = m_controlQueue->getLatency(IngestionQueue::Priority::CONTROL);
+    latency.control += m_egressQueue->getLatency(IngestionQueue::Priority::CONTROL);
+    latency.control += m_ingestionQueue->getLatency(IngestionQueue::Priority::CONTROL);
+
+    latency.data = m_ingestionQueue->getLatency(IngestionQueue::Priority::BULK);
+    latency.data += m_egressQueue->getLatency(IngestionQueue::Priority::BULK);
+
+    return latency;
+}
+
+ReferenceHandle Wolk::registerReference(const std::string& reference)
+{
+    const auto handle = m_dataService->registerReference(reference);
+    if (m_deadbandFilter)
+    {
+        m_deadbandFilter->bind(handle, reference);
+    }
+
+    if (m_windowAggregator)
+    {
+        addToCommandBuffer([=] { m_windowAggregator->bind(handle, reference); });
+    }
+
+    return handle;
+}
+
+ReferenceHandle Wolk::internReference(const std::string& reference)
+{
+    // Registering binds deadband filter and window aggregator as well, so it is done once per reference
+    {
+        std::lock_guard<std::mutex> lock{m_internedReferencesMutex};
+
+        const auto it = m_internedReferences.find(reference);
+        if (it != m_internedReferences.end())
+        {
+            return it->second;
+        }
+    }
+
+    const auto handle = registerReference(reference);
+
+    std::lock_guard<std::mutex> lock{m_internedReferencesMutex};
+    m_internedReferences.emplace(reference, handle);
+    return handle;
 }
 
 void Wolk::publishActuatorStatus(const std::string& reference)
 {
-    addToCommandBuffer([=]() -> void {
-        const ActuatorStatus actuatorStatus = [&]() -> ActuatorStatus {
+    publishActuatorStatuses({reference});
+}
+
+void Wolk::publishActuatorStatuses(const std::vector<std::string>& references)
+{
+    publishActuatorStatuses(references, false);
+}
+
+void Wolk::publishActuatorStatuses(const std::vector<std::string>& references, bool changedOnly)
+{
+    if (references.empty())
+    {
+        return;
+    }
+
+    addToControlQueue([=]() -> void {
+        const std::vector<ActuatorStatus> actuatorStatuses = [&]() -> std::vector<ActuatorStatus> {
             if (auto provider = m_actuatorStatusProvider.lock())
             {
-                return provider->getActuatorStatus(reference);
+                return provider->getActuatorStatuses(references);
             }
-            else if (m_actuatorStatusProviderLambda)
+
+            std::vector<ActuatorStatus> statuses;
+            for (const auto& reference : references)
             {
-                return m_actuatorStatusProviderLambda(reference);
+                statuses.push_back(m_actuatorStatusProviderLambda ? m_actuatorStatusProviderLambda(reference) :
+                                                                    ActuatorStatus());
             }
 
-            return ActuatorStatus();
+            return statuses;
         }();
 
-        m_dataService->addActuatorStatus(reference, actuatorStatus.getValue(), actuatorStatus.getState());
-        flushActuatorStatuses();
+        if (actuatorStatuses.size() != references.size())
+        {
+            LOG(ERROR) << "Actuator status provider returned " << actuatorStatuses.size() << " statuses for "
+                       << references.size() << " references";
+        }
+
+        std::vector<std::pair<std::string, std::size_t>> added;
+        for (std::size_t i = 0; i < std::min(references.size(), actuatorStatuses.size()); ++i)
+        {
+            const auto& actuatorStatus = actuatorStatuses[i];
+
+            const auto key = ACTUATOR_SYNC_KEY_PREFIX + references[i];
+            const auto hash = SyncState::hash(
+              {actuatorStatus.getValue(), std::to_string(static_cast<int>(actuatorStatus.getState()))});
+            if (changedOnly && !m_syncState.hasChanged(key, hash))
+            {
+                continue;
+            }
+
+            m_dataService->addActuatorStatus(references[i], actuatorStatus.getValue(), actuatorStatus.getState());
+            added.emplace_back(key, hash);
+        }
+
+        if (added.empty())
+        {
+            return;
+        }
+
+        addToEgressQueue(
+          [=] {
+              const auto counts = flushActuatorStatuses();
+              if (counts.remaining == 0 && !counts.suppressed)
+              {
+                  for (const auto& item : added)
+                  {
+                      m_syncState.acknowledged(item.first, item.second);
+                  }
+              }
+          },
+          IngestionQueue::Priority::CONTROL);
     });
 }
 
 void Wolk::publishConfiguration()
 {
-    addToCommandBuffer([=]() -> void {
+    publishConfiguration(false);
+}
+
+void Wolk::publishConfiguration(bool changedOnly)
+{
+    addToControlQueue([=]() -> void {
         const auto configuration = [=]() -> std::vector<ConfigurationItem> {
             if (auto provider = m_configurationProvider.lock())
             {
@@ -125,8 +357,32 @@ void Wolk::publishConfiguration()
             return std::vector<ConfigurationItem>();
         }();
 
+        std::vector<std::string> values;
+        for (const auto& item : configuration)
+        {
+            const auto& itemValues = item.getValues();
+
+            values.push_back(item.getReference());
+            values.push_back(std::to_string(itemValues.size()));
+            values.insert(values.end(), itemValues.begin(), itemValues.end());
+        }
+
+        const auto hash = SyncState::hash(values);
+        if (changedOnly && !m_syncState.hasChanged(CONFIGURATION_SYNC_KEY, hash))
+        {
+            return;
+        }
+
         m_dataService->addConfiguration(configuration);
-        flushConfiguration();
+        addToEgressQueue(
+          [=] {
+              const auto counts = flushConfiguration();
+              if (counts.remaining == 0 && !counts.suppressed)
+              {
+                  m_syncState.acknowledged(CONFIGURATION_SYNC_KEY, hash);
+              }
+          },
+          IngestionQueue::Priority::CONTROL);
     });
 }
 
@@ -141,27 +397,109 @@ long long Wolk::getLastTimestamp()
 
 void Wolk::connect()
 {
-    tryConnect(true);
+    m_connectionManager->connect();
 }
 
 void Wolk::disconnect()
 {
-    addToCommandBuffer([=]() -> void {
-        m_connectivityService->disconnect();
-        notifyDisonnected();
-    });
+    m_connectionManager->disconnect();
+
+    addToEgressQueue(
+      [=]() -> void {
+          m_connectivityService->disconnect();
+          notifyDisonnected();
+      },
+      IngestionQueue::Priority::CONTROL);
 }
 
 void Wolk::publish()
 {
+    publish(nullptr);
+}
+
+void Wolk::publish(std::function<void(const PublishResult&)> callback)
+{
+    // data added before the call is stored first, and then published from the egress lane
     addToCommandBuffer([=]() -> void {
-        flushActuatorStatuses();
-        flushAlarms();
-        flushSensorReadings();
-        flushConfiguration();
+        closeAggregationWindows();
+        if (m_flushScheduler)
+        {
+            m_flushScheduler->readingsFlushed();
+            m_flushScheduler->alarmsFlushed();
+        }
+
+        addToEgressQueue([=]() -> void {
+            const auto start = std::chrono::steady_clock::now();
+
+            auto result = std::make_shared<PublishResult>();
+            flushPriorityData(*result);
+            result->elapsed =
+              std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - start);
+
+            drainSensorReadings(result, callback);
+        });
     });
 }
 
+void Wolk::flushPriorityData(PublishResult& result)
+{
+    const auto accumulate = [](PublishCounts& total, const PublishCounts& counts) {
+        total += counts;
+        total.remaining = counts.remaining;
+    };
+
+    // strict priority, so a backlog of one type does not hold up the types ahead of it
+    accumulate(result.alarms, flushAlarms());
+    accumulate(result.actuatorStatuses, flushActuatorStatuses());
+    accumulate(result.configuration, flushConfiguration());
+}
+
+void Wolk::drainSensorReadings(std::shared_ptr<PublishResult> result,
+                               std::function<void(const PublishResult&)> callback)
+{
+    const auto start = std::chrono::steady_clock::now();
+
+    const auto counts = flushSensorReadings();
+    result->sensorReadings += counts;
+    result->sensorReadings.remaining = counts.remaining;
+    result->sensorReadings.yielded = counts.yielded;
+
+    // data added while readings were being published goes out before the next slice of readings
+    if (counts.preempted)
+    {
+        flushPriorityData(*result);
+    }
+
+    result->elapsed +=
+      std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - start);
+
+    if (counts.yielded)
+    {
+        continueSensorReadingsFlush(result, callback);
+    }
+    else if (callback)
+    {
+        callback(*result);
+    }
+}
+
+void Wolk::continueSensorReadingsFlush(std::shared_ptr<PublishResult> result,
+                                       std::function<void(const PublishResult&)> callback)
+{
+    // queued behind commands which arrived meanwhile, so they are not held up by the backlog
+    addToEgressQueue([=]() -> void { drainSensorReadings(result, callback); });
+}
+
+std::future<PublishResult> Wolk::publishWithResult()
+{
+    auto promise = std::make_shared<std::promise<PublishResult>>();
+    auto future = promise->get_future();
+
+    publish([promise](const PublishResult& result) { promise->set_value(result); });
+
+    return future;
+}
+
 Wolk::Wolk(Device device)
 : m_device(device)
 , m_actuationHandlerLambda(nullptr)
@@ -170,12 +508,165 @@ Wolk::Wolk(Device device)
 , m_configurationProviderLambda(nullptr)
 , m_fileRepository(nullptr)
 {
-    m_commandBuffer = std::unique_ptr<CommandBuffer>(new CommandBuffer());
+    m_ingestionQueue = std::unique_ptr<IngestionQueue>(
+      new IngestionQueue([=](std::vector<IngestionRecord>& records) { processIngestionRecords(records); }));
+    // each publish command may take a while, so control commands are checked for after every one of them
+    m_egressQueue = std::unique_ptr<IngestionQueue>(
+      new IngestionQueue(&Wolk::processCommands, IngestionQueue::DEFAULT_CAPACITY, 1));
+    m_controlQueue = std::unique_ptr<IngestionQueue>(new IngestionQueue(&Wolk::processCommands));
 }
 
 void Wolk::addToCommandBuffer(std::function<void()> command)
 {
-    m_commandBuffer->pushCommand(std::make_shared<std::function<void()>>(command));
+    IngestionRecord record;
+    record.type = IngestionRecord::Type::COMMAND;
+    record.command = std::move(command);
+
+    addToCommandBuffer(std::move(record));
+}
+
+void Wolk::addToCommandBuffer(IngestionRecord record)
+{
+    m_ingestionQueue->push(std::move(record));
+}
+
+void Wolk::addToEgressQueue(std::function<void()> command, IngestionQueue::Priority priority)
+{
+    IngestionRecord record;
+    record.type = IngestionRecord::Type::COMMAND;
+    record.command = std::move(command);
+
+    m_egressQueue->push(std::move(record), priority);
+}
+
+void Wolk::addToControlQueue(std::function<void()> command)
+{
+    IngestionRecord record;
+    record.type = IngestionRecord::Type::COMMAND;
+    record.command = std::move(command);
+
+    m_controlQueue->push(std::move(record), IngestionQueue::Priority::CONTROL);
+}
+
+void Wolk::processCommands(std::vector<IngestionRecord>& records)
+{
+    for (auto& record : records)
+    {
+        if (record.type == IngestionRecord::Type::COMMAND && record.command)
+        {
+            record.command();
+        }
+    }
+}
+
+bool Wolk::admitReading()
+{
+    return !m_bufferLimiter || m_bufferLimiter->admit();
+}
+
+bool Wolk::acceptReading(const std::string& reference, const ReadingValue& value, unsigned long long int rtc)
+{
+    if (m_deadbandFilter)
+    {
+        return m_deadbandFilter->pass(reference, value, rtc, [this] { return admitReading(); });
+    }
+
+    return admitReading();
+}
+
+bool Wolk::acceptReading(ReferenceHandle handle, const ReadingValue& value, unsigned long long int rtc)
+{
+    if (m_deadbandFilter)
+    {
+        return m_deadbandFilter->pass(handle, value, rtc, [this] { return admitReading(); });
+    }
+
+    return admitReading();
+}
+
+void Wolk::processIngestionRecords(std::vector<IngestionRecord>& records)
+{
+    std::size_t readingsCount = 0;
+    std::size_t readingsBytes = 0;
+    std::size_t alarmsCount = 0;
+
+    std::vector<ReadingEntry> aggregated;
+
+    for (auto& record : records)
+    {
+        switch (record.type)
+        {
+        case IngestionRecord::Type::SENSOR_READINGS:
+            if (m_windowAggregator)
+            {
+                record.readings.erase(std::remove_if(record.readings.begin(), record.readings.end(),
+                                                     [&](const ReadingEntry& reading) {
+                                                         return m_windowAggregator->add(reading.reference,
+                                                                                        reading.value, reading.rtc,
+                                                                                        aggregated);
+                                                     }),
+                                      record.readings.end());
+
+                if (record.readings.empty())
+                {
+                    break;
+                }
+            }
+
+            m_dataService->addSensorReadings(record.readings);
+            readingsCount += record.readings.size();
+            for (const auto& reading : record.readings)
+            {
+                readingsBytes += reading.reference.size() + reading.value.byteSize();
+            }
+            break;
+        case IngestionRecord::Type::SENSOR_READING:
+            if (m_windowAggregator && m_windowAggregator->add(record.handle, record.value, record.rtc, aggregated))
+            {
+                break;
+            }
+
+            m_dataService->addSensorReading(record.handle, record.value, record.rtc);
+            ++readingsCount;
+            readingsBytes += sizeof(ReferenceHandle) + record.value.byteSize();
+            break;
+        case IngestionRecord::Type::ALARM:
+            m_dataService->addAlarm(record.handle, record.active, record.rtc);
+            ++alarmsCount;
+            break;
+        case IngestionRecord::Type::COMMAND:
+            if (record.command)
+            {
+                record.command();
+            }
+            break;
+        case IngestionRecord::Type::NONE:
+            break;
+        }
+    }
+
+    if (!aggregated.empty())
+    {
+        m_dataService->addSensorReadings(aggregated);
+        readingsCount += aggregated.size();
+        for (const auto& reading : aggregated)
+        {
+            readingsBytes += reading.reference.size() + reading.value.byteSize();
+        }
+    }
+
+    if (m_flushScheduler)
+    {
+        m_flushScheduler->readingsAdded(readingsCount, readingsBytes);
+        m_flushScheduler->alarmsAdded(alarmsCount);
+
+        flushDueData();
+    }
+
+    if (m_directPublish && m_dataService->hasDirectItems())
+    {
+        publishDirectly();
+    }
 }
 
 unsigned long long Wolk::currentRtc()
@@ -184,31 +675,129 @@ unsigned long long Wolk::currentRtc()
     return static_cast<unsigned long long>(std::chrono::duration_cast<std::chrono::milliseconds>(duration).count());
 }
 
-void Wolk::flushActuatorStatuses()
+PublishCounts Wolk::flushActuatorStatuses()
+{
+    return m_dataService->publishActuatorStatuses();
+}
+
+PublishCounts Wolk::flushAlarms()
+{
+    return m_dataService->publishAlarms();
+}
+
+PublishCounts Wolk::flushSensorReadings()
+{
+    return m_dataService->publishSensorReadings();
+}
+
+PublishCounts Wolk::flushConfiguration()
+{
+    return m_dataService->publishConfiguration();
+}
+
+void Wolk::closeAggregationWindows()
+{
+    if (!m_windowAggregator)
+    {
+        return;
+    }
+
+    std::vector<ReadingEntry> closed;
+    m_windowAggregator->closeExpired(Wolk::currentRtc(), closed);
+
+    if (!closed.empty())
+    {
+        m_dataService->addSensorReadings(closed);
+    }
+}
+
+void Wolk::flushDueData()
 {
-    m_dataService->publishActuatorStatuses();
+    // scheduler and aggregation windows are only used from the ingestion lane, and publishing is handed off
+    const bool alarmsDue = m_flushScheduler->alarmsDue();
+    if (alarmsDue)
+    {
+        m_flushScheduler->alarmsFlushed();
+    }
+
+    const bool readingsDue = m_flushScheduler->readingsDue();
+    if (readingsDue)
+    {
+        closeAggregationWindows();
+        m_flushScheduler->readingsFlushed();
+    }
+
+    if (!alarmsDue && !readingsDue)
+    {
+        return;
+    }
+
+    addToEgressQueue([=] {
+        if (alarmsDue)
+        {
+            flushAlarms();
+        }
+
+        if (readingsDue)
+        {
+            drainSensorReadings(std::make_shared<PublishResult>(), nullptr);
+        }
+    });
 }
 
-void Wolk::flushAlarms()
+void Wolk::startFlushTimer()
 {
-    m_dataService->publishAlarms();
+    const auto interval = m_flushScheduler->getTickInterval();
+    if (interval.count() == 0)
+    {
+        return;
+    }
+
+    m_flushTimer.run(interval, [=] {
+        if (m_flushScheduler->hasPending())
+        {
+            addToCommandBuffer([=] { flushDueData(); });
+        }
+    });
 }
 
-void Wolk::flushSensorReadings()
+void Wolk::startConnectionManager(ReconnectPolicy policy)
 {
-    m_dataService->publishSensorReadings();
+    // connecting blocks only the thread of the manager, while established connection is reported in order with data
+    m_connectionManager.reset(new ConnectionManager(
+      policy, [=] { return m_connectivityService->connect(); },
+      [=] { addToEgressQueue([=] { notifyConnected(); }, IngestionQueue::Priority::CONTROL); }));
 }
 
-void Wolk::flushConfiguration()
+void Wolk::publishDirectly()
 {
-    m_dataService->publishConfiguration();
+    // items added until publish is done by the egress lane, or within the window, are coalesced into same messages
+    if (m_directPublishScheduled.exchange(true))
+    {
+        return;
+    }
+
+    const auto publish = [=] {
+        addToEgressQueue([=] {
+            m_directPublishScheduled = false;
+            m_dataService->publishDirectly();
+        });
+    };
+
+    if (m_directPublishWindow.count() == 0)
+    {
+        publish();
+        return;
+    }
+
+    m_directPublishTimer.start(m_directPublishWindow, publish);
 }
 
 void Wolk::handleActuatorSetCommand(const std::string& reference, const std::string& value)
 {
     LOG(INFO) << "Received actuation: " << reference << ", " << value;
 
-    addToCommandBuffer([=] {
+    addToControlQueue([=] {
         if (auto provider = m_actuationHandler.lock())
         {
             provider->handleActuation(reference, value);
@@ -233,7 +822,7 @@ void Wolk::handleConfigurationSetCommand(const ConfigurationSetCommand& command)
 {
     LOG(INFO) << "Received configuration";
 
-    addToCommandBuffer([=]() -> void {
+    addToControlQueue([=]() -> void {
         if (auto handler = m_configurationHandler.lock())
         {
             handler->handleConfiguration(command.getValues());
@@ -263,38 +852,44 @@ void Wolk::publishFirmwareStatus()
     }
 }
 
-void Wolk::publishFileList()
+void Wolk::publishFileList(bool changedOnly)
 {
-    if (m_fileDownloadService)
+    if (!m_fileDownloadService)
+    {
+        return;
+    }
+
+    if (changedOnly)
+    {
+        m_fileDownloadService->syncFileList();
+    }
+    else
     {
         m_fileDownloadService->sendFileList();
     }
 }
 
-void Wolk::tryConnect(bool firstTime)
+void Wolk::resyncState()
 {
-    addToCommandBuffer([=]() -> void {
-        if (firstTime)
-            LOG(INFO) << "Connecting...";
-
-        if (!m_connectivityService->connect())
-        {
-            if (firstTime)
-                LOG(INFO) << "Failed to connect";
-
-            std::this_thread::sleep_for(std::chrono::milliseconds(1000));
-            tryConnect(false);
-            return;
-        }
-
-        notifyConnected();
-    });
+    // runs on the lane which publishes, along with acknowledgements of state published before it
+    addToEgressQueue(
+      [=] {
+          m_syncState.invalidate();
+
+          publishFirmwareStatus();
+          publishActuatorStatuses(m_device.getActuatorReferences(), false);
+          publishConfiguration(false);
+          publishFileList(false);
+      },
+      IngestionQueue::Priority::CONTROL);
 }
 
 void Wolk::notifyConnected()
 {
     LOG(INFO) << "Connection established";
 
+    m_dataService->setConnected(true);
+
     if (m_keepAliveService)
     {
         m_keepAliveService->connected();
@@ -302,15 +897,14 @@ void Wolk::notifyConnected()
 
     publishFirmwareStatus();
 
-    for (const std::string& actuatorReference : m_device.getActuatorReferences())
-    {
-        publishActuatorStatus(actuatorReference);
-    }
+    // state which did not change while disconnected is not sent again, see resyncState
+    publishActuatorStatuses(m_device.getActuatorReferences(), true);
 
-    publishConfiguration();
+    publishConfiguration(true);
 
-    publishFileList();
+    publishFileList(true);
 
+    // drains data stored while offline
     publish();
 }
 
@@ -318,6 +912,9 @@ void Wolk::notifyDisonnected()
 {
     LOG(INFO) << "Connection lost";
 
+    // held items are put into persistence by the lane which publishes them
+    addToEgressQueue([=] { m_dataService->setConnected(false); }, IngestionQueue::Priority::CONTROL);
+
     if (m_keepAliveService)
     {
         m_keepAliveService->disconnected();
@@ -18,17 +18,32 @@
 #define WOLK_H
 
 #include "WolkBuilder.h"
+#include "connectivity/ConnectionManager.h"
 #include "connectivity/ConnectivityService.h"
+#include "ingestion/BufferLimiter.h"
+#include "ingestion/DeadbandFilter.h"
+#include "ingestion/FlushScheduler.h"
+#include "ingestion/IngestionQueue.h"
+#include "ingestion/WindowAggregator.h"
 #include "model/ActuatorStatus.h"
 #include "model/Device.h"
-#include "utilities/CommandBuffer.h"
+#include "model/PublishResult.h"
+#include "model/ReadingEntry.h"
+#include "model/ReadingValue.h"
+#include "utilities/ReferenceRegistry.h"
 #include "utilities/StringUtils.h"
+#include "utilities/SyncState.h"
+#include "utilities/Timer.h"
 
-#include <algorithm>
+#include <atomic>
 #include <functional>
+#include <future>
 #include <initializer_list>
+#include <map>
 #include <memory>
+#include <mutex>
 #include <string>
+#include <unordered_map>
 #include <vector>
 
 namespace wolkabout
@@ -157,6 +172,67 @@ public:
     void addSensorReading(const std::string& reference, const std::vector<std::string> values,
                           unsigned long long int rtc = 0);
 
+    /**
+     * @brief Publishes batch of sensor readings to WolkAbout IoT Cloud<br>
+     *        Whole batch is enqueued, and stored, at once.<br>
+     *        This method is thread safe, and can be called from multiple thread simultaneously
+     * @param readings Sensor readings<br>
+     *                 Current POSIX time is adopted for readings which have rtc set to 0
+     */
+    void addSensorReadings(std::vector<ReadingEntry> readings);
+
+    /**
+     * @brief Publishes values of multiple sensors, sampled at the same time, to WolkAbout IoT Cloud<br>
+     *        Whole snapshot is enqueued, and stored, at once.<br>
+     *        This method is thread safe, and can be called from multiple thread simultaneously
+     * @param rtc POSIX time at which sensors were sampled - Number of milliseconds since 01/01/1970<br>
+     *            If 0 current POSIX time is adopted
+     * @param values Sensor values, mapped by sensor reference
+     */
+    void addSnapshot(unsigned long long int rtc, const std::map<std::string, ReadingValue>& values);
+
+    /**
+     * @brief Registers sensor, or alarm, reference, so readings and alarms can be published by handle.<br>
+     *        Publishing by handle avoids copying and comparing reference strings for every reading.<br>
+     *        Registering the same reference again returns the same handle.<br>
+     *        This method is thread safe, and can be called from multiple thread simultaneously
+     * @param reference Sensor, or alarm, reference
+     * @return Handle standing in for the reference
+     */
+    ReferenceHandle registerReference(const std::string& reference);
+
+    /**
+     * @brief Publishes sensor reading to WolkAbout IoT Cloud<br>
+     *        This method is thread safe, and can be called from multiple thread simultaneously
+     * @param handle Sensor handle obtained from registerReference
+     * @param value Sensor value, of any type supported by addSensorReading with sensor reference
+     * @param rtc Reading POSIX time - Number of seconds since 01/01/1970<br>
+     *            If omitted current POSIX time is adopted
+     */
+    template <typename T> void addSensorReading(ReferenceHandle handle, T value, unsigned long long int rtc = 0);
+
+    /**
+     * @brief Publishes multi-value sensor reading to WolkAbout IoT Cloud<br>
+     *        This method is thread safe, and can be called from multiple thread simultaneously
+     * @param handle Sensor handle obtained from registerReference
+     * @param values Multi-value sensor values, of any type supported by addSensorReading with sensor reference
+     * @param rtc Reading POSIX time - Number of seconds since 01/01/1970<br>
+     *            If omitted current POSIX time is adopted
+     */
+    template <typename T>
+    void addSensorReading(ReferenceHandle handle, std::initializer_list<T> values, unsigned long long int rtc = 0);
+
+    /**
+     * @brief Publishes multi-value sensor reading to WolkAbout IoT Cloud<br>
+     *        This method is thread safe, and can be called from multiple thread simultaneously
+     * @param handle Sensor handle obtained from registerReference
+     * @param values Multi-value sensor values, of any type supported by addSensorReading with sensor reference
+     * @param rtc Reading POSIX time - Number of seconds since 01/01/1970<br>
+     *            If omitted current POSIX time is adopted
+     */
+    template <typename T>
+    void addSensorReading(ReferenceHandle handle, const std::vector<T> values, unsigned long long int rtc = 0);
+
     /**
      * @brief Publishes alarm to WolkAbout IoT Cloud<br>
      *        This method is thread safe, and can be called from multiple thread simultaneously
@@ -167,6 +243,16 @@ public:
      */
     void addAlarm(const std::string& reference, bool active, unsigned long long int rtc = 0);
 
+    /**
+     * @brief Publishes alarm to WolkAbout IoT Cloud<br>
+     *        This method is thread safe, and can be called from multiple thread simultaneously
+     * @param handle Alarm handle obtained from registerReference
+     * @param active Is alarm active or not
+     * @param rtc POSIX time at which event occurred - Number of seconds since 01/01/1970<br>
+     *            If omitted current POSIX time is adopted
+     */
+    void addAlarm(ReferenceHandle handle, bool active, unsigned long long int rtc = 0);
+
     /**
      * @brief Invokes ActuatorStatusProvider to obtain actuator status, and the publishes it.<br>
      *        This method is thread safe, and can be called from multiple thread simultaneously
@@ -174,12 +260,38 @@ public:
      */
     void publishActuatorStatus(const std::string& reference);
 
+    /**
+     * @brief Invokes ActuatorStatusProvider once to obtain statuses of all given actuators, and then publishes them,
+     *        packed into as few messages as wolkabout::DataProtocol in use allows.<br>
+     *        This method is thread safe, and can be called from multiple thread simultaneously
+     * @param Actuator references
+     */
+    void publishActuatorStatuses(const std::vector<std::string>& references);
+
     /**
      * @brief Invokes ConfigurationProvider to obtain device configuration, and the publishes it.<br>
      *        This method is thread safe, and can be called from multiple thread simultaneously
      */
     void publishConfiguration();
 
+    /**
+     * @brief Returns number of sensor readings dropped because buffered readings reached the limits
+     *        set with wolkabout::WolkBuilder::withBufferLimits, per overflow policy which dropped them
+     */
+    DropStatistics getDropStatistics() const;
+
+    /**
+     * @brief Returns number of publish calls skipped while not connected, per item type.<br>
+     *        Data left in persistence meanwhile is published once connection is established
+     */
+    SuppressedPublishes getSuppressedPublishes() const;
+
+    /**
+     * @brief Returns time commands spent queued before being executed, per class.<br>
+     *        Control commands are executed ahead of any queued data
+     */
+    CommandLatency getCommandLatency() const;
+
     /**
      * @brief Invokes keepAliveServices method of fetching the last received timestamp in pong.
      */
@@ -195,27 +307,85 @@ public:
      */
     void disconnect();
 
+    /**
+     * @brief Republishes firmware status, statuses of all actuators, configuration and file list,
+     *        including state the platform already acknowledged.<br>
+     *        On reconnect only state which changed since it was last published successfully is sent.<br>
+     *        State is republished asynchronously, ahead of queued sensor readings
+     */
+    void resyncState();
+
     /**
      * @brief Publishes data
      */
     void publish();
 
+    /**
+     * @brief Publishes data, and reports the outcome once publishing is done<br>
+     *        If sensor readings are published within a budget, remaining readings are published in further
+     *        steps, queued behind commands which arrive in the meantime, and outcome is reported after the last one.
+     *        Callback is invoked from the thread on which data is published
+     * @param callback Invoked with number of items sent and left unpublished, per item type
+     */
+    void publish(std::function<void(const PublishResult&)> callback);
+
+    /**
+     * @brief Publishes data
+     * @return Future which becomes ready, with number of items sent and left unpublished per item type,
+     *         once publishing is done
+     */
+    std::future<PublishResult> publishWithResult();
+
 private:
     class ConnectivityFacade;
 
-    static const constexpr unsigned int PUBLISH_BATCH_ITEMS_COUNT = 50;
     static const constexpr std::chrono::seconds KEEP_ALIVE_INTERVAL{60};
 
+    static const std::string ACTUATOR_SYNC_KEY_PREFIX;
+    static const std::string CONFIGURATION_SYNC_KEY;
+
     Wolk(Device device);
 
+    void addSensorReading(const std::string& reference, ReadingValue value, unsigned long long int rtc);
+    void addSensorReading(ReferenceHandle handle, ReadingValue value, unsigned long long int rtc);
+
+    ReferenceHandle internReference(const std::string& reference);
+
+    bool admitReading();
+    bool acceptReading(const std::string& reference, const ReadingValue& value, unsigned long long int rtc);
+    bool acceptReading(ReferenceHandle handle, const ReadingValue& value, unsigned long long int rtc);
+
     void addToCommandBuffer(std::function<void()> command);
+    void addToCommandBuffer(IngestionRecord record);
+    void addToEgressQueue(std::function<void()> command,
+                          IngestionQueue::Priority priority = IngestionQueue::Priority::BULK);
+    void addToControlQueue(std::function<void()> command);
+
+    void processIngestionRecords(std::vector<IngestionRecord>& records);
+    static void processCommands(std::vector<IngestionRecord>& records);
 
     static unsigned long long int currentRtc();
 
-    void flushActuatorStatuses();
-    void flushAlarms();
-    void flushSensorReadings();
-    void flushConfiguration();
+    PublishCounts flushActuatorStatuses();
+    PublishCounts flushAlarms();
+    PublishCounts flushSensorReadings();
+    PublishCounts flushConfiguration();
+
+    // alarms, actuator statuses and configuration, which are published ahead of sensor readings
+    void flushPriorityData(PublishResult& result);
+
+    // publishes a slice of sensor readings, and continues from the egress queue until they are drained
+    void drainSensorReadings(std::shared_ptr<PublishResult> result,
+                             std::function<void(const PublishResult&)> callback);
+
+    void continueSensorReadingsFlush(std::shared_ptr<PublishResult> result,
+                                     std::function<void(const PublishResult&)> callback);
+
+    void closeAggregationWindows();
+    void flushDueData();
+    void startFlushTimer();
+    void startConnectionManager(ReconnectPolicy policy);
+    void publishDirectly();
 
     void handleActuatorSetCommand(const std::string& reference, const std::string& value);
     void handleActuatorGetCommand(const std::string& reference);
@@ -223,10 +393,13 @@ private:
     void handleConfigurationSetCommand(const ConfigurationSetCommand& command);
     void handleConfigurationGetCommand();
 
+    // changedOnly skips state which is the same as the one last published successfully
+    void publishActuatorStatuses(const std::vector<std::string>& references, bool changedOnly);
+    void publishConfiguration(bool changedOnly);
+
     void publishFirmwareStatus();
-    void publishFileList();
+    void publishFileList(bool changedOnly);
 
-    void tryConnect(bool firstTime = false);
     void notifyConnected();
     void notifyDisonnected();
 
@@ -265,7 +438,33 @@ private:
     std::function<std::vector<ConfigurationItem>()> m_configurationProviderLambda;
     std::weak_ptr<ConfigurationProvider> m_configurationProvider;
 
-    std::unique_ptr<CommandBuffer> m_commandBuffer;
+    std::shared_ptr<BufferLimiter> m_bufferLimiter;
+    std::shared_ptr<DeadbandFilter> m_deadbandFilter;
+    std::shared_ptr<WindowAggregator> m_windowAggregator;
+
+    // references added by string, already registered and bound to deadband filter and window aggregator
+    std::mutex m_internedReferencesMutex;
+    std::unordered_map<std::string, ReferenceHandle> m_internedReferences;
+
+    std::unique_ptr<FlushScheduler> m_flushScheduler;
+
+    // state published successfully, so it is not sent again on reconnect unless it changed
+    SyncState m_syncState;
+
+    // Data is stored, published, and handed to user handlers on separate lanes, so none of them holds up the others
+    std::unique_ptr<IngestionQueue> m_ingestionQueue;
+    std::unique_ptr<IngestionQueue> m_egressQueue;
+    std::unique_ptr<IngestionQueue> m_controlQueue;
+
+    // declared after everything it uses, so its thread is stopped first
+    std::unique_ptr<ConnectionManager> m_connectionManager;
+
+    Timer m_flushTimer;
+
+    bool m_directPublish = false;
+    std::chrono::milliseconds m_directPublishWindow{0};
+    std::atomic_bool m_directPublishScheduled{false};
+    Timer m_directPublishTimer;
 
     class ConnectivityFacade : public ConnectivityServiceListener
     {
@@ -284,7 +483,7 @@ private:
 
 template <typename T> void Wolk::addSensorReading(const std::string& reference, T value, unsigned long long rtc)
 {
-    addSensorReading(reference, StringUtils::toString(value), rtc);
+    addSensorReading(reference, ReadingValue{value}, rtc);
 }
 
 template <typename T>
@@ -296,11 +495,34 @@ void Wolk::addSensorReading(const std::string& reference, std::initializer_list<
 template <typename T>
 void Wolk::addSensorReading(const std::string& reference, const std::vector<T> values, unsigned long long int rtc)
 {
-    std::vector<std::string> stringifiedValues(values.size());
-    std::transform(values.cbegin(), values.cend(), stringifiedValues.begin(),
-                   [&](const T& value) -> std::string { return StringUtils::toString(value); });
+    if (values.empty())
+    {
+        return;
+    }
+
+    addSensorReading(reference, ReadingValue{values}, rtc);
+}
+
+template <typename T> void Wolk::addSensorReading(ReferenceHandle handle, T value, unsigned long long rtc)
+{
+    addSensorReading(handle, ReadingValue{value}, rtc);
+}
+
+template <typename T>
+void Wolk::addSensorReading(ReferenceHandle handle, std::initializer_list<T> values, unsigned long long int rtc)
+{
+    addSensorReading(handle, std::vector<T>(values), rtc);
+}
+
+template <typename T>
+void Wolk::addSensorReading(ReferenceHandle handle, const std::vector<T> values, unsigned long long int rtc)
+{
+    if (values.empty())
+    {
+        return;
+    }
 
-    addSensorReading(reference, stringifiedValues, rtc);
+    addSensorReading(handle, ReadingValue{values}, rtc);
 }
 }    // namespace wolkabout
 
@@ -22,12 +22,16 @@
 #include "connectivity/ConnectivityService.h"
 #include "connectivity/mqtt/MqttConnectivityService.h"
 #include "connectivity/mqtt/WolkPahoMqttClient.h"
-#include "persistence/inmemory/InMemoryPersistence.h"
+#include "persistence/LockingPersistence.h"
+#include "persistence/TypedPersistence.h"
+#include "persistence/inmemory/InMemoryTypedPersistence.h"
+#include "protocol/cbor/CborProtocol.h"
+#include "protocol/gzip/GzipDataProtocol.h"
 #include "protocol/json/JsonDFUProtocol.h"
 #include "protocol/json/JsonDownloadProtocol.h"
-#include "protocol/json/JsonProtocol.h"
 #include "protocol/json/JsonSingleReferenceProtocol.h"
 #include "protocol/json/JsonStatusProtocol.h"
+#include "protocol/json/StreamingJsonProtocol.h"
 #include "repository/SQLiteFileRepository.h"
 #include "service/data/DataService.h"
 #include "service/file/FileDownloadService.h"
@@ -38,6 +42,21 @@
 
 namespace wolkabout
 {
+namespace
+{
+// JSON protocols name the actuator in the channel of its status, so only protocols whose payload carries
+// the reference of each status can pack statuses of different actuators into one message
+bool carriesActuatorStatusReferences(const DataProtocol& protocol)
+{
+    if (const auto gzip = dynamic_cast<const GzipDataProtocol*>(&protocol))
+    {
+        return carriesActuatorStatusReferences(gzip->getProtocol());
+    }
+
+    return dynamic_cast<const CborProtocol*>(&protocol) != nullptr;
+}
+}    // namespace
+
 WolkBuilder& WolkBuilder::host(const std::string& host)
 {
     m_host = host;
@@ -145,6 +164,118 @@ WolkBuilder& WolkBuilder::withFirmwareUpdate(std::shared_ptr<FirmwareInstaller>
     return *this;
 }
 
+WolkBuilder& WolkBuilder::withBufferLimits(BufferLimits limits)
+{
+    if (limits.maxReadings == 0 && limits.maxBytes == 0)
+    {
+        throw std::logic_error("Buffer limits require maximum number or size of buffered readings.");
+    }
+
+    if (limits.policy == OverflowPolicy::SAMPLE && limits.sampleStride == 0)
+    {
+        throw std::logic_error("Sampling overflow policy requires non-zero sample stride.");
+    }
+
+    if (limits.policy == OverflowPolicy::BLOCK && limits.blockTimeout.count() <= 0)
+    {
+        throw std::logic_error("Blocking overflow policy requires positive block timeout.");
+    }
+
+    m_bufferLimiter = std::make_shared<BufferLimiter>(limits);
+    return *this;
+}
+
+WolkBuilder& WolkBuilder::withFlushPolicy(FlushPolicy policy)
+{
+    m_flushPolicy = policy;
+    m_flushPolicyEnabled = true;
+    return *this;
+}
+
+WolkBuilder& WolkBuilder::withDeadband(const std::string& reference, Deadband deadband)
+{
+    if (!m_deadbandFilter)
+    {
+        m_deadbandFilter = std::make_shared<DeadbandFilter>();
+    }
+
+    m_deadbandFilter->setDeadband(reference, deadband);
+    return *this;
+}
+
+WolkBuilder& WolkBuilder::withAggregation(const std::string& reference, Aggregation aggregation)
+{
+    if (aggregation.window.count() <= 0)
+    {
+        throw std::logic_error("Aggregation of '" + reference + "' requires positive window.");
+    }
+
+    if (aggregation.statistics.empty())
+    {
+        throw std::logic_error("Aggregation of '" + reference + "' requires at least one statistic.");
+    }
+
+    if (aggregation.statistics.size() > ReadingValue::MAX_NUMERIC_VALUES)
+    {
+        throw std::logic_error("Aggregation of '" + reference + "' has more statistics than a reading can hold.");
+    }
+
+    if (!m_windowAggregator)
+    {
+        m_windowAggregator = std::make_shared<WindowAggregator>();
+    }
+
+    m_windowAggregator->setAggregation(reference, std::move(aggregation));
+    return *this;
+}
+
+WolkBuilder& WolkBuilder::withPublishBatchSize(std::size_t itemsPerMessage)
+{
+    m_publishBatchSize = itemsPerMessage;
+    return *this;
+}
+
+WolkBuilder& WolkBuilder::withMaxPayloadSize(std::size_t bytes, std::shared_ptr<PayloadSizeEstimator> estimator)
+{
+    m_maxPayloadSize = bytes;
+    m_payloadSizeEstimator = std::move(estimator);
+    return *this;
+}
+
+WolkBuilder& WolkBuilder::withPublishWindow(std::size_t messages, std::chrono::milliseconds ackTimeout)
+{
+    m_publishWindow = messages;
+    m_ackTimeout = ackTimeout;
+    return *this;
+}
+
+WolkBuilder& WolkBuilder::withPublishBudget(PublishBudget budget)
+{
+    m_publishBudget = budget;
+    return *this;
+}
+
+WolkBuilder& WolkBuilder::withCompression(std::size_t threshold, int level)
+{
+    m_compressionEnabled = true;
+    m_compressionThreshold = threshold;
+    m_compressionLevel = level;
+    return *this;
+}
+
+WolkBuilder& WolkBuilder::withDirectPublish(std::chrono::milliseconds coalescingWindow)
+{
+    m_directPublishEnabled = true;
+    m_directPublishWindow = coalescingWindow;
+    return *this;
+}
+
+WolkBuilder& WolkBuilder::withReconnectPolicy(ReconnectPolicy policy)
+{
+    m_reconnectPolicy = policy;
+    return *this;
+}
+
 WolkBuilder& WolkBuilder::withoutKeepAlive()
 {
     m_keepAliveEnabled = false;
@@ -183,14 +314,43 @@ std::unique_ptr<Wolk> WolkBuilder::build()
         throw std::logic_error("Both ConfigurationPRovider and ConfigurationHandler must be set.");
     }
 
+    auto typedPersistence = std::dynamic_pointer_cast<TypedPersistence>(m_persistence);
+    if (m_bufferLimiter && !typedPersistence)
+    {
+        throw std::logic_error("Buffer limits require persistence which implements TypedPersistence.");
+    }
+
     auto wolk = std::unique_ptr<Wolk>(new Wolk(m_device));
 
+    const bool singleReferenceProtocol = dynamic_cast<JsonSingleReferenceProtocol*>(m_dataProtocol.get());
+    if (m_compressionEnabled)
+    {
+        m_dataProtocol.reset(
+          new GzipDataProtocol(std::move(m_dataProtocol), m_compressionThreshold, m_compressionLevel));
+    }
+
     wolk->m_dataProtocol.reset(m_dataProtocol.release());
     wolk->m_fileDownloadProtocol = std::unique_ptr<JsonDownloadProtocol>(new JsonDownloadProtocol(false));
     wolk->m_firmwareUpdateProtocol = std::unique_ptr<JsonDFUProtocol>(new JsonDFUProtocol(false));
     wolk->m_statusProtocol = std::unique_ptr<StatusProtocol>(new JsonStatusProtocol());
 
-    wolk->m_persistence = m_persistence;
+    if (typedPersistence)
+    {
+        wolk->m_persistence = m_persistence;
+    }
+    else
+    {
+        wolk->m_persistence = std::make_shared<LockingPersistence>(m_persistence);
+    }
+
+    if (m_bufferLimiter)
+    {
+        typedPersistence->setBufferLimiter(m_bufferLimiter);
+        wolk->m_bufferLimiter = m_bufferLimiter;
+    }
+
+    wolk->m_deadbandFilter = m_deadbandFilter;
+    wolk->m_windowAggregator = m_windowAggregator;
 
     auto mqttClient = std::make_shared<WolkPahoMqttClient>();
     wolk->m_connectivityService = std::unique_ptr<MqttConnectivityService>(
@@ -201,7 +361,7 @@ std::unique_ptr<Wolk> WolkBuilder::build()
 
     wolk->m_connectivityManager = std::make_shared<Wolk::ConnectivityFacade>(*wolk->m_inboundMessageHandler, [&] {
         wolk->notifyDisonnected();
-        wolk->connect();
+        wolk->m_connectionManager->connectionLost();
     });
 
     wolk->m_actuationHandlerLambda = m_actuationHandlerLambda;
@@ -226,6 +386,29 @@ std::unique_ptr<Wolk> WolkBuilder::build()
       [&](const ConfigurationSetCommand& command) { wolk->handleConfigurationSetCommand(command); },
       [&]() { wolk->handleConfigurationGetCommand(); });
 
+    std::size_t publishBatchSize = m_publishBatchSize;
+    if (publishBatchSize == 0)
+    {
+        publishBatchSize = m_maxPayloadSize != 0 ? m_maxPayloadSize / PayloadSizeEstimator::MIN_ITEM_SIZE :
+                                                   DataService::PUBLISH_BATCH_ITEMS_COUNT;
+    }
+    wolk->m_dataService->setPublishBatching(publishBatchSize, !singleReferenceProtocol);
+    wolk->m_dataService->setActuatorStatusBatching(carriesActuatorStatusReferences(*wolk->m_dataProtocol));
+    wolk->m_dataService->setMaxPayloadSize(m_maxPayloadSize, m_payloadSizeEstimator);
+    wolk->m_dataService->setPublishWindow(m_publishWindow, m_ackTimeout);
+    wolk->m_dataService->setPublishBudget(m_publishBudget);
+
+    // control commands queued on the egress lane stop a drain of readings, which then continues behind them
+    Wolk* const instance = wolk.get();
+    wolk->m_dataService->setPreemptionCheck([instance] { return instance->m_egressQueue->hasPendingControl(); });
+    wolk->m_dataService->setDirectPublish(m_directPublishEnabled);
+
+    // data is kept in persistence, without attempts to publish it, until connection is established
+    wolk->m_dataService->setConnected(false);
+
+    wolk->m_directPublish = m_directPublishEnabled;
+    wolk->m_directPublishWindow = m_directPublishWindow;
+
     wolk->m_inboundMessageHandler->addListener(wolk->m_dataService);
 
     // Setup file repository
@@ -264,6 +447,14 @@ std::unique_ptr<Wolk> WolkBuilder::build()
 
     wolk->m_connectivityService->setListener(wolk->m_connectivityManager);
 
+    if (m_flushPolicyEnabled)
+    {
+        wolk->m_flushScheduler.reset(new FlushScheduler(m_flushPolicy));
+        wolk->startFlushTimer();
+    }
+
+    wolk->startConnectionManager(m_reconnectPolicy);
+
     return wolk;
 }
 
@@ -280,13 +471,22 @@ WolkBuilder::WolkBuilder(Device device)
 : m_host{WOLK_DEMO_HOST}
 , m_ca_cert_path{TRUST_STORE}
 , m_device{std::move(device)}
-, m_persistence{new InMemoryPersistence()}
-, m_dataProtocol{new JsonProtocol()}
+, m_persistence{new InMemoryTypedPersistence()}
+, m_dataProtocol{new StreamingJsonProtocol()}
 , m_maxPacketSize{0}
 , m_fileDownloadDirectory{""}
 , m_firmwareInstaller{nullptr}
 , m_firmwareVersionProvider{nullptr}
 , m_keepAliveEnabled{true}
+, m_publishBatchSize{0}
+, m_maxPayloadSize{0}
+, m_publishWindow{1}
+, m_ackTimeout{DataService::DEFAULT_ACK_TIMEOUT}
+, m_compressionEnabled{false}
+, m_compressionThreshold{GzipDataProtocol::DEFAULT_THRESHOLD}
+, m_compressionLevel{Gzip::DEFAULT_LEVEL}
+, m_directPublishEnabled{false}
+, m_directPublishWindow{0}
 {
 }
 }    // namespace wolkabout
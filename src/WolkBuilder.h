@@ -24,10 +24,21 @@
 #include "api/FirmwareInstaller.h"
 #include "api/FirmwareVersionProvider.h"
 #include "api/UrlFileDownloader.h"
+#include "connectivity/ConnectionManager.h"
+#include "ingestion/BufferLimiter.h"
+#include "ingestion/DeadbandFilter.h"
+#include "ingestion/FlushScheduler.h"
+#include "ingestion/WindowAggregator.h"
 #include "model/Device.h"
 #include "persistence/Persistence.h"
 #include "protocol/DataProtocol.h"
+#include "protocol/gzip/GzipDataProtocol.h"
+#include "service/data/DataService.h"
+#include "service/data/PayloadSizeEstimator.h"
+#include "utilities/Gzip.h"
 
+#include <chrono>
+#include <cstddef>
 #include <cstdint>
 #include <functional>
 #include <memory>
@@ -126,14 +137,21 @@ public:
 
     /**
      * @brief Sets underlying persistence mechanism to be used<br>
-     *        Sample in-memory persistence is used as default
+     *        Sample in-memory persistence is used as default<br>
+     *        Implementations of wolkabout::TypedPersistence store sensor readings without formatting their values,
+     *        and must be thread safe, as persistence is written and read from different lanes<br>
+     *        Other wolkabout::Persistence implementations are wrapped in wolkabout::LockingPersistence,
+     *        which serializes all calls to them
      * @param persistence std::shared_ptr to wolkabout::Persistence implementation
      * @return Reference to current wolkabout::WolkBuilder instance (Provides fluent interface)
      */
     WolkBuilder& withPersistence(std::shared_ptr<Persistence> persistence);
 
     /**
-     * @brief withDataProtocol Defines which data protocol to use
+     * @brief withDataProtocol Defines which data protocol to use<br>
+     *        wolkabout::StreamingJsonProtocol is used as default.<br>
+     *        wolkabout::CborProtocol encodes more compact payloads, but is experimental: it publishes on its own
+     *        d2p/cbor and p2d/cbor channels, which the platform has to be set up to accept
      * @param Protocol unique_ptr to wolkabout::DataProtocol implementation
      * @return Reference to current wolkabout::WolkBuilder instance (Provides
      * fluent interface)
@@ -170,6 +188,108 @@ public:
     WolkBuilder& withFirmwareUpdate(std::shared_ptr<FirmwareInstaller> installer,
                                     std::shared_ptr<FirmwareVersionProvider> provider);
 
+    /**
+     * @brief Limits sensor readings buffered while they wait to be published<br>
+     *        Requires persistence which implements wolkabout::TypedPersistence, such as the default one
+     * @param limits Maximum number, and size, of buffered readings, and policy applied once they are reached
+     * @return Reference to current wolkabout::WolkBuilder instance (Provides fluent interface)
+     * @throws std::logic_error if neither limit is set, or the sample stride or block timeout of the policy is zero
+     */
+    WolkBuilder& withBufferLimits(BufferLimits limits);
+
+    /**
+     * @brief Publishes sensor readings and alarms on their own once thresholds of the policy are reached,
+     *        in addition to publishing requested through wolkabout::Wolk::publish
+     * @param policy Maximum number, size and age of unsent sensor readings, and maximum age of unsent alarms
+     * @return Reference to current wolkabout::WolkBuilder instance (Provides fluent interface)
+     */
+    WolkBuilder& withFlushPolicy(FlushPolicy policy);
+
+    /**
+     * @brief Drops sensor readings of reference which do not change enough since the last one sent,
+     *        before they are stored
+     * @param reference Sensor reference
+     * @param deadband Minimum absolute, or relative, change of value, and interval after which reading is sent anyway
+     * @return Reference to current wolkabout::WolkBuilder instance (Provides fluent interface)
+     */
+    WolkBuilder& withDeadband(const std::string& reference, Deadband deadband);
+
+    /**
+     * @brief Stores statistics of numeric sensor readings of reference, for each window,
+     *        instead of the readings themselves
+     * @param reference Sensor reference
+     * @param aggregation Length of window, and statistics sent for it
+     * @return Reference to current wolkabout::WolkBuilder instance (Provides fluent interface)
+     * @throws std::logic_error if the window is not positive, or there are no statistics,
+     *         or more than ReadingValue::MAX_NUMERIC_VALUES of them
+     */
+    WolkBuilder& withAggregation(const std::string& reference, Aggregation aggregation);
+
+    /**
+     * @brief Sets maximum number of sensor readings, or alarms, published in a single message.<br>
+     *        Sensor readings of different references are packed into the same message, unless
+     *        wolkabout::JsonSingleReferenceProtocol is used
+     * @param itemsPerMessage Maximum number of items in a message
+     * @return Reference to current wolkabout::WolkBuilder instance (Provides fluent interface)
+     */
+    WolkBuilder& withPublishBatchSize(std::size_t itemsPerMessage);
+
+    /**
+     * @brief Limits payload size of sensor reading, and alarm, messages.<br>
+     *        Unless set by withPublishBatchSize, number of items in a message is then limited by payload size only
+     * @param bytes Maximum payload size in bytes
+     * @param estimator Estimator of encoded size of items, matching data protocol in use<br>
+     *        If omitted, estimator of JSON protocols is used
+     * @return Reference to current wolkabout::WolkBuilder instance (Provides fluent interface)
+     */
+    WolkBuilder& withMaxPayloadSize(std::size_t bytes, std::shared_ptr<PayloadSizeEstimator> estimator = nullptr);
+
+    /**
+     * @brief Publishes multiple sensor reading messages without waiting for each one to be acknowledged.<br>
+     *        Readings are removed from persistence once acknowledged, so they are still delivered at least once
+     * @param messages Maximum number of messages in flight
+     * @param ackTimeout Time after which message which is not acknowledged is published again, on next publish
+     * @return Reference to current wolkabout::WolkBuilder instance (Provides fluent interface)
+     */
+    WolkBuilder& withPublishWindow(std::size_t messages,
+                                   std::chrono::milliseconds ackTimeout = DataService::DEFAULT_ACK_TIMEOUT);
+
+    /**
+     * @brief Bounds time spent, and number of sensor readings sent, by a single publishing step.<br>
+     *        Remaining readings are published in further steps, so other commands are not held up by a backlog
+     * @param budget Time and number of readings per step, and readings sent per reference in a turn
+     * @return Reference to current wolkabout::WolkBuilder instance (Provides fluent interface)
+     */
+    WolkBuilder& withPublishBudget(PublishBudget budget);
+
+    /**
+     * @brief Compresses payloads of data messages with gzip.<br>
+     *        Payloads are sent uncompressed if they are smaller than threshold, or do not get smaller
+     * @param threshold Size of payload, in bytes, below which it is not compressed
+     * @param level zlib compression level, 1 (fastest) to 9 (smallest)
+     * @return Reference to current wolkabout::WolkBuilder instance (Provides fluent interface)
+     */
+    WolkBuilder& withCompression(std::size_t threshold = GzipDataProtocol::DEFAULT_THRESHOLD,
+                                 int level = Gzip::DEFAULT_LEVEL);
+
+    /**
+     * @brief Publishes sensor readings and alarms as they are added, without storing them in persistence,
+     *        while connected and no readings, or alarms respectively, wait to be published.<br>
+     *        Persistence is used only for items which fail to publish, and for items added while they are stored
+     * @param coalescingWindow Time items added are held before they are published together,
+     *        0 to publish items of each ingestion batch right away
+     * @return Reference to current wolkabout::WolkBuilder instance (Provides fluent interface)
+     */
+    WolkBuilder& withDirectPublish(std::chrono::milliseconds coalescingWindow = std::chrono::milliseconds{0});
+
+    /**
+     * @brief Sets delays between connection attempts, made on a dedicated thread.<br>
+     *        By default delay starts at 1 second and doubles up to 1 minute, with full jitter
+     * @param policy Initial and maximum delay, growth factor, and whether jitter is applied
+     * @return Reference to current wolkabout::WolkBuilder instance (Provides fluent interface)
+     */
+    WolkBuilder& withReconnectPolicy(ReconnectPolicy policy);
+
     /**
      * @brief withoutKeepAlive Disables ping mechanism used to notify WolkAbout IOT Platform
      * that device is still connected
@@ -184,6 +304,8 @@ public:
      * @throws std::logic_error if device key is not present in wolkabout::Device
      * @throws std::logic_error if actuator status provider is not set, and wolkabout::Device has actuator references
      * @throws std::logic_error if actuation handler is not set, and wolkabout::Device has actuator references
+     * @throws std::logic_error if buffer limits are set, and persistence does not implement
+     *         wolkabout::TypedPersistence
      */
     std::unique_ptr<Wolk> build();
 
@@ -224,6 +346,32 @@ private:
 
     bool m_keepAliveEnabled;
 
+    std::shared_ptr<BufferLimiter> m_bufferLimiter;
+
+    std::shared_ptr<DeadbandFilter> m_deadbandFilter;
+    std::shared_ptr<WindowAggregator> m_windowAggregator;
+
+    std::size_t m_publishBatchSize;
+    std::size_t m_maxPayloadSize;
+    std::shared_ptr<PayloadSizeEstimator> m_payloadSizeEstimator;
+
+    std::size_t m_publishWindow;
+    std::chrono::milliseconds m_ackTimeout;
+
+    PublishBudget m_publishBudget;
+
+    bool m_compressionEnabled;
+    std::size_t m_compressionThreshold;
+    int m_compressionLevel;
+
+    bool m_directPublishEnabled;
+    std::chrono::milliseconds m_directPublishWindow;
+
+    ReconnectPolicy m_reconnectPolicy;
+
+    bool m_flushPolicyEnabled = false;
+    FlushPolicy m_flushPolicy;
+
     static const constexpr char* WOLK_DEMO_HOST = "ssl://api-demo.wolkabout.com:8883";
     static const constexpr char* TRUST_STORE = "ca.crt";
     static const constexpr char* DATABASE = "fileRepository.db";
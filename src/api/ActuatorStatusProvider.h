@@ -20,6 +20,7 @@
 #include "model/ActuatorStatus.h"
 
 #include <string>
+#include <vector>
 
 namespace wolkabout
 {
@@ -35,6 +36,26 @@ public:
      */
     virtual ActuatorStatus getActuatorStatus(const std::string& reference) = 0;
 
+    /**
+     * @brief Batched actuator status provider callback, invoked once for all actuators on connect<br>
+     *        By default invokes getActuatorStatus for each reference<br>
+     *        Must be implemented as non blocking<br>
+     *        Must be implemented as thread safe
+     * @param references Actuator references
+     * @return ActuatorStatus of each requested actuator, in order of references
+     */
+    virtual std::vector<ActuatorStatus> getActuatorStatuses(const std::vector<std::string>& references)
+    {
+        std::vector<ActuatorStatus> actuatorStatuses;
+        actuatorStatuses.reserve(references.size());
+        for (const auto& reference : references)
+        {
+            actuatorStatuses.push_back(getActuatorStatus(reference));
+        }
+
+        return actuatorStatuses;
+    }
+
     virtual ~ActuatorStatusProvider() = default;
 };
 }    // namespace wolkabout
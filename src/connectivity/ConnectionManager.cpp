@@ -0,0 +1,222 @@
+/*
+ * Copyright 2020 WolkAbout Technology s.r.o.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "connectivity/ConnectionManager.h"
+
+#include "utilities/Logger.h"
+
+#include <algorithm>
+#include <utility>
+
+namespace
+{
+wolkabout::ReconnectPolicy validate(wolkabout::ReconnectPolicy policy)
+{
+    const wolkabout::ReconnectPolicy defaults;
+
+    // Zero interval, or interval which does not grow, would retry without pause
+    if (policy.initialInterval.count() <= 0)
+    {
+        LOG(WARN) << "ConnectionManager: Initial reconnect interval must be positive, using "
+                  << defaults.initialInterval.count() << "ms";
+        policy.initialInterval = defaults.initialInterval;
+    }
+
+    if (!(policy.multiplier >= 1.0))
+    {
+        LOG(WARN) << "ConnectionManager: Reconnect interval multiplier must be at least 1, using "
+                  << defaults.multiplier;
+        policy.multiplier = defaults.multiplier;
+    }
+
+    if (policy.maxInterval < policy.initialInterval)
+    {
+        LOG(WARN) << "ConnectionManager: Maximum reconnect interval is below initial one, using "
+                  << policy.initialInterval.count() << "ms";
+        policy.maxInterval = policy.initialInterval;
+    }
+
+    return policy;
+}
+}    // namespace
+
+namespace wolkabout
+{
+ConnectionManager::ConnectionManager(ReconnectPolicy policy, std::function<bool()> connect,
+                                     std::function<void()> connected)
+: m_policy{validate(policy)}
+, m_connect{std::move(connect)}
+, m_connected{std::move(connected)}
+, m_state{State::DISCONNECTED}
+, m_failedAttempts{0}
+, m_disconnectRequested{false}
+, m_random{std::random_device{}()}
+, m_run{true}
+, m_worker{&ConnectionManager::run, this}
+{
+}
+
+ConnectionManager::~ConnectionManager()
+{
+    {
+        std::lock_guard<std::mutex> lock{m_mutex};
+        m_run = false;
+    }
+
+    m_condition.notify_all();
+
+    if (m_worker.joinable())
+    {
+        m_worker.join();
+    }
+}
+
+void ConnectionManager::connect()
+{
+    std::lock_guard<std::mutex> lock{m_mutex};
+
+    if (m_state == State::DISCONNECTED)
+    {
+        LOG(INFO) << "ConnectionManager: Connecting...";
+        m_failedAttempts = 0;
+    }
+    else if (m_state != State::WAITING)
+    {
+        return;
+    }
+
+    scheduleAttempt(std::chrono::milliseconds{0});
+}
+
+void ConnectionManager::connectionLost()
+{
+    std::lock_guard<std::mutex> lock{m_mutex};
+
+    if (m_state != State::CONNECTED)
+    {
+        return;
+    }
+
+    m_failedAttempts = 0;
+    scheduleAttempt(getBackoffInterval(0));
+}
+
+void ConnectionManager::disconnect()
+{
+    std::unique_lock<std::mutex> lock{m_mutex};
+
+    if (m_state == State::CONNECTING)
+    {
+        // attempt in progress is not reported, even if it succeeds
+        m_disconnectRequested = true;
+        m_condition.wait(lock, [&] { return m_state != State::CONNECTING || !m_run; });
+    }
+
+    m_state = State::DISCONNECTED;
+}
+
+ConnectionManager::State ConnectionManager::getState() const
+{
+    std::lock_guard<std::mutex> lock{m_mutex};
+    return m_state;
+}
+
+std::uint64_t ConnectionManager::getFailedAttempts() const
+{
+    std::lock_guard<std::mutex> lock{m_mutex};
+    return m_failedAttempts;
+}
+
+std::chrono::milliseconds ConnectionManager::getBackoffInterval(std::uint64_t failedAttempts) const
+{
+    const auto maxInterval = static_cast<double>(m_policy.maxInterval.count());
+
+    auto interval = static_cast<double>(m_policy.initialInterval.count());
+    for (std::uint64_t i = 0; i < failedAttempts && interval < maxInterval; ++i)
+    {
+        interval *= m_policy.multiplier;
+    }
+
+    return std::chrono::milliseconds{static_cast<std::chrono::milliseconds::rep>(std::min(interval, maxInterval))};
+}
+
+void ConnectionManager::scheduleAttempt(std::chrono::milliseconds delay)
+{
+    if (m_policy.jitter && delay.count() > 0)
+    {
+        std::uniform_int_distribution<std::chrono::milliseconds::rep> distribution{0, delay.count()};
+        delay = std::chrono::milliseconds{distribution(m_random)};
+    }
+
+    m_state = State::WAITING;
+    m_nextAttempt = std::chrono::steady_clock::now() + delay;
+    m_condition.notify_all();
+}
+
+void ConnectionManager::run()
+{
+    std::unique_lock<std::mutex> lock{m_mutex};
+
+    while (m_run)
+    {
+        if (m_state != State::WAITING)
+        {
+            m_condition.wait(lock);
+            continue;
+        }
+
+        if (std::chrono::steady_clock::now() < m_nextAttempt)
+        {
+            m_condition.wait_until(lock, m_nextAttempt);
+            continue;
+        }
+
+        m_state = State::CONNECTING;
+
+        lock.unlock();
+        const bool connected = m_connect();
+        lock.lock();
+
+        if (m_disconnectRequested)
+        {
+            m_disconnectRequested = false;
+            m_state = State::DISCONNECTED;
+            m_condition.notify_all();
+            continue;
+        }
+
+        if (connected)
+        {
+            m_state = State::CONNECTED;
+            m_failedAttempts = 0;
+            m_condition.notify_all();
+
+            lock.unlock();
+            m_connected();
+            lock.lock();
+            continue;
+        }
+
+        if (m_failedAttempts == 0)
+        {
+            LOG(INFO) << "ConnectionManager: Failed to connect";
+        }
+
+        scheduleAttempt(getBackoffInterval(m_failedAttempts));
+        ++m_failedAttempts;
+    }
+}
+}    // namespace wolkabout
@@ -0,0 +1,139 @@
+/*
+ * Copyright 2020 WolkAbout Technology s.r.o.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef CONNECTIONMANAGER_H
+#define CONNECTIONMANAGER_H
+
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <functional>
+#include <mutex>
+#include <random>
+#include <thread>
+
+namespace wolkabout
+{
+/**
+ * @brief Delays between failed connection attempts.<br>
+ *        Delay grows exponentially from initial interval up to max interval, and is reset once connected.
+ */
+struct ReconnectPolicy
+{
+    /**
+     * @brief Delay after the first failed attempt, or after connection is lost
+     */
+    std::chrono::milliseconds initialInterval{1000};
+
+    /**
+     * @brief Upper bound of delay between attempts
+     */
+    std::chrono::milliseconds maxInterval{60000};
+
+    /**
+     * @brief Factor by which delay grows after each failed attempt
+     */
+    double multiplier = 2.0;
+
+    /**
+     * @brief Draws each delay uniformly between 0 and the exponential interval ("full jitter"),
+     *        so devices which lost connection at the same time do not reconnect at the same time
+     */
+    bool jitter = true;
+};
+
+/**
+ * @brief Establishes connection on its own thread, retrying per wolkabout::ReconnectPolicy,
+ *        so callers are never blocked by connection attempts.
+ */
+class ConnectionManager
+{
+public:
+    enum class State
+    {
+        DISCONNECTED,
+        WAITING,
+        CONNECTING,
+        CONNECTED
+    };
+
+    /**
+     * @param policy Non-positive initial interval, and multiplier below 1, are replaced with defaults,
+     *               and maximum interval below initial one is raised to it
+     * @param connect Attempts to connect, returning whether it succeeded. Invoked from the thread of the manager
+     * @param connected Invoked from the thread of the manager once connection is established
+     */
+    ConnectionManager(ReconnectPolicy policy, std::function<bool()> connect, std::function<void()> connected);
+
+    ~ConnectionManager();
+
+    ConnectionManager(const ConnectionManager&) = delete;
+    ConnectionManager& operator=(const ConnectionManager&) = delete;
+
+    /**
+     * @brief Starts connecting right away, or cuts short the delay before the next attempt
+     */
+    void connect();
+
+    /**
+     * @brief Starts reconnecting after backoff delay, unless connecting was stopped with disconnect
+     */
+    void connectionLost();
+
+    /**
+     * @brief Stops connection attempts, waiting for the one in progress to finish
+     */
+    void disconnect();
+
+    State getState() const;
+
+    /**
+     * @brief Number of failed attempts since connection was last established
+     */
+    std::uint64_t getFailedAttempts() const;
+
+    /**
+     * @brief Interval after given number of failed attempts, before jitter is applied
+     */
+    std::chrono::milliseconds getBackoffInterval(std::uint64_t failedAttempts) const;
+
+private:
+    void run();
+
+    // must be called with mutex held
+    void scheduleAttempt(std::chrono::milliseconds delay);
+
+    const ReconnectPolicy m_policy;
+
+    std::function<bool()> m_connect;
+    std::function<void()> m_connected;
+
+    State m_state;
+    std::uint64_t m_failedAttempts;
+    std::chrono::steady_clock::time_point m_nextAttempt;
+    bool m_disconnectRequested;
+
+    std::mt19937 m_random;
+
+    bool m_run;
+    mutable std::mutex m_mutex;
+    std::condition_variable m_condition;
+
+    std::thread m_worker;
+};
+}    // namespace wolkabout
+
+#endif    // CONNECTIONMANAGER_H
@@ -0,0 +1,181 @@
+/*
+ * Copyright 2020 WolkAbout Technology s.r.o.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "ingestion/BufferLimiter.h"
+
+namespace
+{
+wolkabout::BufferLimits normalize(wolkabout::BufferLimits limits)
+{
+    // Stride of zero would keep no sample, and negative timeout would not wait at all
+    if (limits.sampleStride == 0)
+    {
+        limits.sampleStride = 1;
+    }
+
+    if (limits.blockTimeout.count() < 0)
+    {
+        limits.blockTimeout = std::chrono::milliseconds{0};
+    }
+
+    return limits;
+}
+}    // namespace
+
+namespace wolkabout
+{
+BufferLimiter::BufferLimiter(BufferLimits limits)
+: m_limits{normalize(limits)}
+, m_count{0}
+, m_bytes{0}
+, m_blockTimedOut{0}
+, m_droppedOldest{0}
+, m_droppedNewest{0}
+, m_sampledOut{0}
+, m_sampleCounter{0}
+, m_waiting{0}
+{
+}
+
+const BufferLimits& BufferLimiter::getLimits() const
+{
+    return m_limits;
+}
+
+bool BufferLimiter::admit()
+{
+    if (!isFull(0))
+    {
+        return true;
+    }
+
+    switch (m_limits.policy)
+    {
+    case OverflowPolicy::BLOCK:
+    {
+        std::unique_lock<std::mutex> lock{m_mutex};
+
+        ++m_waiting;
+        const bool hasSpace =
+          m_spaceAvailable.wait_for(lock, m_limits.blockTimeout, [this] { return !isFull(0); });
+        --m_waiting;
+
+        if (!hasSpace)
+        {
+            ++m_blockTimedOut;
+        }
+
+        return hasSpace;
+    }
+    case OverflowPolicy::DROP_NEWEST:
+        ++m_droppedNewest;
+        return false;
+    case OverflowPolicy::SAMPLE:
+        if (m_sampleCounter++ % m_limits.sampleStride != 0)
+        {
+            ++m_sampledOut;
+            return false;
+        }
+
+        return true;
+    case OverflowPolicy::DROP_OLDEST:
+        return true;
+    }
+
+    return true;
+}
+
+bool BufferLimiter::reserve(std::size_t bytes)
+{
+    // Readings admitted while others were still queued may exceed the limits once they are stored
+    if (isFull(bytes))
+    {
+        if (m_limits.policy == OverflowPolicy::BLOCK)
+        {
+            ++m_blockTimedOut;
+            return false;
+        }
+
+        if (m_limits.policy == OverflowPolicy::DROP_NEWEST)
+        {
+            ++m_droppedNewest;
+            return false;
+        }
+    }
+
+    ++m_count;
+    m_bytes += bytes;
+
+    return true;
+}
+
+void BufferLimiter::release(std::size_t count, std::size_t bytes)
+{
+    m_count -= count;
+    m_bytes -= bytes;
+
+    if (m_waiting > 0)
+    {
+        std::lock_guard<std::mutex> lock{m_mutex};
+        m_spaceAvailable.notify_all();
+    }
+}
+
+bool BufferLimiter::mustEvict() const
+{
+    return (m_limits.policy == OverflowPolicy::DROP_OLDEST || m_limits.policy == OverflowPolicy::SAMPLE) &&
+           isOverLimit();
+}
+
+void BufferLimiter::evicted(std::size_t bytes)
+{
+    ++m_droppedOldest;
+    release(1, bytes);
+}
+
+std::size_t BufferLimiter::getCount() const
+{
+    return m_count;
+}
+
+std::size_t BufferLimiter::getBytes() const
+{
+    return m_bytes;
+}
+
+DropStatistics BufferLimiter::getDropStatistics() const
+{
+    DropStatistics statistics;
+    statistics.blockTimedOut = m_blockTimedOut;
+    statistics.droppedOldest = m_droppedOldest;
+    statistics.droppedNewest = m_droppedNewest;
+    statistics.sampledOut = m_sampledOut;
+
+    return statistics;
+}
+
+bool BufferLimiter::isFull(std::size_t additionalBytes) const
+{
+    return (m_limits.maxReadings != 0 && m_count >= m_limits.maxReadings) ||
+           (m_limits.maxBytes != 0 && m_bytes + additionalBytes > m_limits.maxBytes);
+}
+
+bool BufferLimiter::isOverLimit() const
+{
+    return (m_limits.maxReadings != 0 && m_count > m_limits.maxReadings) ||
+           (m_limits.maxBytes != 0 && m_bytes > m_limits.maxBytes);
+}
+}    // namespace wolkabout
@@ -0,0 +1,163 @@
+/*
+ * Copyright 2020 WolkAbout Technology s.r.o.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef BUFFERLIMITER_H
+#define BUFFERLIMITER_H
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <mutex>
+
+namespace wolkabout
+{
+/**
+ * @brief Action taken when a sensor reading arrives while buffered readings are at their limit
+ */
+enum class OverflowPolicy
+{
+    /**
+     * @brief Caller waits for published readings to free up space, and the reading is dropped on timeout
+     */
+    BLOCK,
+
+    /**
+     * @brief Oldest buffered readings are dropped to make room for the new one
+     */
+    DROP_OLDEST,
+
+    /**
+     * @brief New reading is dropped
+     */
+    DROP_NEWEST,
+
+    /**
+     * @brief Only every n-th new reading is kept, and oldest buffered readings are dropped to make room for it
+     */
+    SAMPLE
+};
+
+/**
+ * @brief Limits on sensor readings buffered while they wait to be published
+ */
+struct BufferLimits
+{
+    /**
+     * @brief Maximum number of buffered readings, 0 for no limit
+     */
+    std::size_t maxReadings = 0;
+
+    /**
+     * @brief Maximum number of bytes occupied by buffered readings, 0 for no limit
+     */
+    std::size_t maxBytes = 0;
+
+    OverflowPolicy policy = OverflowPolicy::DROP_OLDEST;
+
+    /**
+     * @brief How long OverflowPolicy::BLOCK waits for space
+     */
+    std::chrono::milliseconds blockTimeout{1000};
+
+    /**
+     * @brief Every n-th reading is kept under OverflowPolicy::SAMPLE
+     */
+    unsigned int sampleStride = 10;
+};
+
+/**
+ * @brief Number of sensor readings dropped, per overflow policy which dropped them
+ */
+struct DropStatistics
+{
+    std::uint64_t blockTimedOut = 0;
+    std::uint64_t droppedOldest = 0;
+    std::uint64_t droppedNewest = 0;
+    std::uint64_t sampledOut = 0;
+
+    std::uint64_t total() const { return blockTimedOut + droppedOldest + droppedNewest + sampledOut; }
+};
+
+/**
+ * @brief Tracks number and size of buffered sensor readings against wolkabout::BufferLimits.<br>
+ *        Producers ask for admission before enqueueing a reading, while the persistence accounts for readings
+ *        it stores and removes, and evicts the oldest ones when the policy requires it.<br>
+ *        This class is thread safe.
+ */
+class BufferLimiter
+{
+public:
+    explicit BufferLimiter(BufferLimits limits);
+
+    const BufferLimits& getLimits() const;
+
+    /**
+     * @brief Applies overflow policy to a reading about to be enqueued. Blocks under OverflowPolicy::BLOCK.
+     * @return false if reading must be dropped
+     */
+    bool admit();
+
+    /**
+     * @brief Accounts for a reading being stored
+     * @return false if reading must be dropped instead of being stored
+     */
+    bool reserve(std::size_t bytes);
+
+    /**
+     * @brief Accounts for stored readings being removed
+     */
+    void release(std::size_t count, std::size_t bytes);
+
+    /**
+     * @brief Checks whether oldest readings must be evicted to get back within the limits
+     */
+    bool mustEvict() const;
+
+    /**
+     * @brief Accounts for oldest stored reading being evicted
+     */
+    void evicted(std::size_t bytes);
+
+    std::size_t getCount() const;
+    std::size_t getBytes() const;
+
+    DropStatistics getDropStatistics() const;
+
+private:
+    bool isFull(std::size_t additionalBytes) const;
+    bool isOverLimit() const;
+
+    const BufferLimits m_limits;
+
+    std::atomic<std::size_t> m_count;
+    std::atomic<std::size_t> m_bytes;
+
+    std::atomic<std::uint64_t> m_blockTimedOut;
+    std::atomic<std::uint64_t> m_droppedOldest;
+    std::atomic<std::uint64_t> m_droppedNewest;
+    std::atomic<std::uint64_t> m_sampledOut;
+
+    std::atomic<std::uint64_t> m_sampleCounter;
+
+    std::mutex m_mutex;
+    std::condition_variable m_spaceAvailable;
+    std::atomic<unsigned int> m_waiting;
+};
+}    // namespace wolkabout
+
+#endif    // BUFFERLIMITER_H
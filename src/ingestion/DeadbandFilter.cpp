@@ -0,0 +1,197 @@
+/*
+ * Copyright 2020 WolkAbout Technology s.r.o.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "ingestion/DeadbandFilter.h"
+
+#include <cmath>
+
+namespace wolkabout
+{
+const constexpr std::size_t DeadbandFilter::CHUNK_SIZE;
+const constexpr std::size_t DeadbandFilter::MAX_CHUNKS;
+
+DeadbandFilter::DeadbandFilter()
+{
+    for (auto& chunk : m_boundChunks)
+    {
+        chunk.store(nullptr, std::memory_order_relaxed);
+    }
+}
+
+void DeadbandFilter::setDeadband(const std::string& reference, Deadband deadband)
+{
+    std::lock_guard<std::mutex> lock{m_mutex};
+
+    auto& channel = m_channels[reference];
+
+    std::lock_guard<std::mutex> channelLock{channel.mutex};
+    channel.deadband = deadband;
+    channel.hasLast = false;
+}
+
+void DeadbandFilter::bind(ReferenceHandle handle, const std::string& reference)
+{
+    if (!handle.isValid())
+    {
+        return;
+    }
+
+    std::lock_guard<std::mutex> lock{m_mutex};
+
+    const auto it = m_channels.find(reference);
+    if (it == m_channels.end())
+    {
+        return;
+    }
+
+    const auto chunkIndex = handle.id / CHUNK_SIZE;
+    if (chunkIndex >= MAX_CHUNKS)
+    {
+        m_overflowChannels[handle.id] = &it->second;
+        return;
+    }
+
+    auto chunk = m_boundChunks[chunkIndex].load(std::memory_order_relaxed);
+    if (!chunk)
+    {
+        m_ownedChunks.emplace_back(new Chunk());
+        chunk = m_ownedChunks.back().get();
+
+        for (auto& channel : chunk->channels)
+        {
+            channel.store(nullptr, std::memory_order_relaxed);
+        }
+
+        m_boundChunks[chunkIndex].store(chunk, std::memory_order_release);
+    }
+
+    chunk->channels[handle.id % CHUNK_SIZE].store(&it->second, std::memory_order_release);
+}
+
+bool DeadbandFilter::pass(const std::string& reference, const ReadingValue& value, unsigned long long int rtc,
+                          const std::function<bool()>& admit)
+{
+    Channel* channel = nullptr;
+    {
+        std::lock_guard<std::mutex> lock{m_mutex};
+
+        const auto it = m_channels.find(reference);
+        if (it != m_channels.end())
+        {
+            channel = &it->second;
+        }
+    }
+
+    if (!channel)
+    {
+        return !admit || admit();
+    }
+
+    return pass(*channel, value, rtc, admit);
+}
+
+bool DeadbandFilter::pass(ReferenceHandle handle, const ReadingValue& value, unsigned long long int rtc,
+                          const std::function<bool()>& admit)
+{
+    const auto channel = find(handle);
+    if (!channel)
+    {
+        return !admit || admit();
+    }
+
+    return pass(*channel, value, rtc, admit);
+}
+
+DeadbandFilter::Channel* DeadbandFilter::find(ReferenceHandle handle)
+{
+    if (!handle.isValid())
+    {
+        return nullptr;
+    }
+
+    const auto chunkIndex = handle.id / CHUNK_SIZE;
+    if (chunkIndex >= MAX_CHUNKS)
+    {
+        std::lock_guard<std::mutex> lock{m_mutex};
+
+        const auto it = m_overflowChannels.find(handle.id);
+        return it != m_overflowChannels.end() ? it->second : nullptr;
+    }
+
+    const auto chunk = m_boundChunks[chunkIndex].load(std::memory_order_acquire);
+    return chunk ? chunk->channels[handle.id % CHUNK_SIZE].load(std::memory_order_acquire) : nullptr;
+}
+
+bool DeadbandFilter::pass(Channel& channel, const ReadingValue& value, unsigned long long int rtc,
+                          const std::function<bool()>& admit)
+{
+    std::lock_guard<std::mutex> lock{channel.mutex};
+
+    const auto heartbeat = static_cast<unsigned long long int>(channel.deadband.heartbeat.count());
+    const bool heartbeatDue = heartbeat != 0 && rtc >= channel.lastRtc + heartbeat;
+
+    if (channel.hasLast && !heartbeatDue && !changed(channel.deadband, channel.last, value))
+    {
+        return false;
+    }
+
+    // Reading dropped after passing the deadband was never sent, so it must not become the reference point
+    if (admit && !admit())
+    {
+        return false;
+    }
+
+    channel.hasLast = true;
+    channel.last = value;
+    channel.lastRtc = rtc;
+
+    return true;
+}
+
+bool DeadbandFilter::changed(const Deadband& deadband, const ReadingValue& last, const ReadingValue& value)
+{
+    if (!value.isNumeric() || value.getType() != last.getType() || value.size() != last.size())
+    {
+        return value != last;
+    }
+
+    for (std::size_t i = 0; i < value.size(); ++i)
+    {
+        const double previous = last.toDouble(i);
+        const double delta = std::fabs(value.toDouble(i) - previous);
+
+        if (deadband.absolute <= 0 && deadband.percent <= 0)
+        {
+            if (delta > 0)
+            {
+                return true;
+            }
+
+            continue;
+        }
+
+        // Every band that is set has to be exceeded
+        const bool exceedsAbsolute = deadband.absolute <= 0 || delta > deadband.absolute;
+        const bool exceedsPercent = deadband.percent <= 0 || delta > std::fabs(previous) * deadband.percent / 100;
+        if (exceedsAbsolute && exceedsPercent)
+        {
+            return true;
+        }
+    }
+
+    return false;
+}
+}    // namespace wolkabout
@@ -0,0 +1,127 @@
+/*
+ * Copyright 2020 WolkAbout Technology s.r.o.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef DEADBANDFILTER_H
+#define DEADBANDFILTER_H
+
+#include "model/ReadingValue.h"
+#include "utilities/ReferenceRegistry.h"
+
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace wolkabout
+{
+/**
+ * @brief Change a sensor reading must make, relative to the last one sent, in order to be sent.<br>
+ *        With no band set only readings whose value changed are sent.
+ */
+struct Deadband
+{
+    /**
+     * @brief Minimum absolute change of numeric value, 0 disables
+     */
+    double absolute = 0;
+
+    /**
+     * @brief Minimum change of numeric value, in percent of the last value sent, 0 disables
+     */
+    double percent = 0;
+
+    /**
+     * @brief Reading is sent regardless of change once this much time passed since the last one sent, 0 disables
+     */
+    std::chrono::milliseconds heartbeat{0};
+};
+
+/**
+ * @brief Drops sensor readings which do not change enough according to wolkabout::Deadband of their reference.<br>
+ *        Readings of references without deadband are always passed. Thread safe.<br>
+ *        Each reference keeps its state under its own lock, and readings added by handle find it without locking
+ *        the filter, so producers of different references do not contend.
+ */
+class DeadbandFilter
+{
+public:
+    DeadbandFilter();
+
+    void setDeadband(const std::string& reference, Deadband deadband);
+
+    /**
+     * @brief Makes deadband of reference apply to readings added by its handle
+     */
+    void bind(ReferenceHandle handle, const std::string& reference);
+
+    /**
+     * @brief Checks whether reading changed enough to be sent
+     * @param admit Called once reading passed the deadband, and last sent value is only updated if it returns true
+     * @return true if reading passed and was admitted
+     */
+    bool pass(const std::string& reference, const ReadingValue& value, unsigned long long int rtc,
+              const std::function<bool()>& admit = nullptr);
+    bool pass(ReferenceHandle handle, const ReadingValue& value, unsigned long long int rtc,
+              const std::function<bool()>& admit = nullptr);
+
+private:
+    struct Channel
+    {
+        std::mutex mutex;
+
+        Deadband deadband;
+
+        bool hasLast = false;
+        ReadingValue last;
+        unsigned long long int lastRtc = 0;
+    };
+
+    static const constexpr std::size_t CHUNK_SIZE = 256;
+    static const constexpr std::size_t MAX_CHUNKS = 4096;
+
+    struct Chunk
+    {
+        std::array<std::atomic<Channel*>, CHUNK_SIZE> channels;
+    };
+
+    static bool pass(Channel& channel, const ReadingValue& value, unsigned long long int rtc,
+                     const std::function<bool()>& admit);
+    static bool changed(const Deadband& deadband, const ReadingValue& last, const ReadingValue& value);
+
+    Channel* find(ReferenceHandle handle);
+
+    // guards channels by reference, and binding of handles
+    std::mutex m_mutex;
+
+    std::unordered_map<std::string, Channel> m_channels;
+
+    // channels bound to handles, written under m_mutex and read without it, as channels are never removed
+    std::array<std::atomic<Chunk*>, MAX_CHUNKS> m_boundChunks;
+    std::vector<std::unique_ptr<Chunk>> m_ownedChunks;
+
+    // channels bound to handles beyond capacity of the chunks, under m_mutex
+    std::unordered_map<std::uint32_t, Channel*> m_overflowChannels;
+};
+}    // namespace wolkabout
+
+#endif    // DEADBANDFILTER_H
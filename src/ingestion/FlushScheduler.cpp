@@ -0,0 +1,127 @@
+/*
+ * Copyright 2020 WolkAbout Technology s.r.o.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "ingestion/FlushScheduler.h"
+
+#include <algorithm>
+
+namespace wolkabout
+{
+const constexpr std::chrono::milliseconds FlushScheduler::MIN_TICK_INTERVAL;
+
+FlushScheduler::FlushScheduler(FlushPolicy policy)
+: m_policy{policy}, m_pendingReadings{0}, m_pendingBytes{0}, m_pendingAlarms{0}, m_hasPending{false}
+{
+}
+
+const FlushPolicy& FlushScheduler::getPolicy() const
+{
+    return m_policy;
+}
+
+void FlushScheduler::readingsAdded(std::size_t count, std::size_t bytes)
+{
+    if (count == 0)
+    {
+        return;
+    }
+
+    if (m_pendingReadings == 0)
+    {
+        m_oldestReading = std::chrono::steady_clock::now();
+    }
+
+    m_pendingReadings += count;
+    m_pendingBytes += bytes;
+    m_hasPending = true;
+}
+
+void FlushScheduler::alarmsAdded(std::size_t count)
+{
+    if (count == 0)
+    {
+        return;
+    }
+
+    if (m_pendingAlarms == 0)
+    {
+        m_oldestAlarm = std::chrono::steady_clock::now();
+    }
+
+    m_pendingAlarms += count;
+    m_hasPending = true;
+}
+
+bool FlushScheduler::readingsDue() const
+{
+    if (m_pendingReadings == 0)
+    {
+        return false;
+    }
+
+    return (m_policy.maxItems != 0 && m_pendingReadings >= m_policy.maxItems) ||
+           (m_policy.maxBytes != 0 && m_pendingBytes >= m_policy.maxBytes) ||
+           isExpired(m_oldestReading, m_policy.maxAge);
+}
+
+bool FlushScheduler::alarmsDue() const
+{
+    return m_pendingAlarms != 0 && isExpired(m_oldestAlarm, m_policy.alarmDeadline);
+}
+
+void FlushScheduler::readingsFlushed()
+{
+    m_pendingReadings = 0;
+    m_pendingBytes = 0;
+    m_hasPending = m_pendingAlarms != 0;
+}
+
+void FlushScheduler::alarmsFlushed()
+{
+    m_pendingAlarms = 0;
+    m_hasPending = m_pendingReadings != 0;
+}
+
+bool FlushScheduler::hasPending() const
+{
+    return m_hasPending;
+}
+
+std::chrono::milliseconds FlushScheduler::getTickInterval() const
+{
+    std::chrono::milliseconds shortest{0};
+    for (const auto& age : {m_policy.maxAge, m_policy.alarmDeadline})
+    {
+        if (age.count() > 0 && (shortest.count() == 0 || age < shortest))
+        {
+            shortest = age;
+        }
+    }
+
+    if (shortest.count() == 0)
+    {
+        return shortest;
+    }
+
+    // Deadlines are met within a quarter of the shortest one
+    return std::max(shortest / 4, MIN_TICK_INTERVAL);
+}
+
+bool FlushScheduler::isExpired(std::chrono::steady_clock::time_point since, std::chrono::milliseconds age)
+{
+    return age.count() > 0 && std::chrono::steady_clock::now() - since >= age;
+}
+}    // namespace wolkabout
@@ -0,0 +1,101 @@
+/*
+ * Copyright 2020 WolkAbout Technology s.r.o.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef FLUSHSCHEDULER_H
+#define FLUSHSCHEDULER_H
+
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+
+namespace wolkabout
+{
+/**
+ * @brief Thresholds at which data is published without wolkabout::Wolk::publish being called.<br>
+ *        Thresholds set to 0 are disabled.
+ */
+struct FlushPolicy
+{
+    /**
+     * @brief Publish sensor readings once this many of them are unsent
+     */
+    std::size_t maxItems = 0;
+
+    /**
+     * @brief Publish sensor readings once unsent ones occupy this many bytes
+     */
+    std::size_t maxBytes = 0;
+
+    /**
+     * @brief Publish sensor readings once the oldest unsent one has been waiting this long
+     */
+    std::chrono::milliseconds maxAge{0};
+
+    /**
+     * @brief Publish alarms once the oldest unsent one has been waiting this long
+     */
+    std::chrono::milliseconds alarmDeadline{0};
+};
+
+/**
+ * @brief Decides when data has to be published according to wolkabout::FlushPolicy.<br>
+ *        Must be used from the thread which stores, and publishes, data, except for hasPending and getTickInterval.
+ */
+class FlushScheduler
+{
+public:
+    explicit FlushScheduler(FlushPolicy policy);
+
+    const FlushPolicy& getPolicy() const;
+
+    void readingsAdded(std::size_t count, std::size_t bytes);
+    void alarmsAdded(std::size_t count);
+
+    bool readingsDue() const;
+    bool alarmsDue() const;
+
+    void readingsFlushed();
+    void alarmsFlushed();
+
+    /**
+     * @brief Checks whether there is unsent data which may become due with time. Thread safe.
+     */
+    bool hasPending() const;
+
+    /**
+     * @brief Interval at which age thresholds should be checked, or 0 if no age threshold is set
+     */
+    std::chrono::milliseconds getTickInterval() const;
+
+private:
+    static bool isExpired(std::chrono::steady_clock::time_point since, std::chrono::milliseconds age);
+
+    static const constexpr std::chrono::milliseconds MIN_TICK_INTERVAL{10};
+
+    const FlushPolicy m_policy;
+
+    std::size_t m_pendingReadings;
+    std::size_t m_pendingBytes;
+    std::chrono::steady_clock::time_point m_oldestReading;
+
+    std::size_t m_pendingAlarms;
+    std::chrono::steady_clock::time_point m_oldestAlarm;
+
+    std::atomic_bool m_hasPending;
+};
+}    // namespace wolkabout
+
+#endif    // FLUSHSCHEDULER_H
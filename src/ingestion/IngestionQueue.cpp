@@ -0,0 +1,275 @@
+/*
+ * Copyright 2020 WolkAbout Technology s.r.o.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "ingestion/IngestionQueue.h"
+
+#include <chrono>
+#include <utility>
+
+namespace
+{
+// Upper bound on how long the worker sleeps if a wake up signal is missed
+const std::chrono::milliseconds IDLE_WAIT{50};
+
+// Upper bound on how long a producer waits for space if the signal of the worker is missed
+const std::chrono::milliseconds SPACE_WAIT{10};
+}    // namespace
+
+namespace wolkabout
+{
+const constexpr std::size_t IngestionQueue::DEFAULT_CAPACITY;
+const constexpr std::size_t IngestionQueue::DEFAULT_BATCH_SIZE;
+const constexpr std::size_t IngestionQueue::CONTROL_CAPACITY;
+
+IngestionQueue::IngestionQueue(BatchHandler handler, std::size_t capacity, std::size_t batchSize)
+: m_buffer{capacity}
+, m_controlBuffer{CONTROL_CAPACITY}
+, m_batchSize{batchSize}
+, m_handler{std::move(handler)}
+, m_controlOverflowing{false}
+, m_run{true}
+, m_sleeping{false}
+, m_waitingProducers{0}
+, m_worker{&IngestionQueue::run, this}
+{
+}
+
+IngestionQueue::~IngestionQueue()
+{
+    stop();
+}
+
+void IngestionQueue::push(IngestionRecord record, Priority priority)
+{
+    record.enqueuedAt = std::chrono::steady_clock::now();
+
+    auto& buffer = priority == Priority::CONTROL ? m_controlBuffer : m_buffer;
+
+    if (std::this_thread::get_id() == m_worker.get_id())
+    {
+        if (!buffer.tryPush(record))
+        {
+            (priority == Priority::CONTROL ? m_deferredControl : m_deferred).push_back(std::move(record));
+        }
+
+        return;
+    }
+
+    if (priority == Priority::CONTROL)
+    {
+        // records already overflowing are handled first, so the new one goes behind them
+        if (m_controlOverflowing.load() || !buffer.tryPush(record))
+        {
+            pushOverflowControl(std::move(record));
+        }
+
+        wakeUp();
+        return;
+    }
+
+    while (!buffer.tryPush(record))
+    {
+        if (!m_run)
+        {
+            return;
+        }
+
+        wakeUp();
+        waitForSpace();
+    }
+
+    wakeUp();
+}
+
+void IngestionQueue::stop()
+{
+    {
+        std::lock_guard<std::mutex> lock{m_mutex};
+        m_run = false;
+    }
+
+    m_condition.notify_one();
+
+    {
+        std::lock_guard<std::mutex> lock{m_spaceMutex};
+        m_spaceAvailable.notify_all();
+    }
+
+    if (m_worker.joinable() && std::this_thread::get_id() != m_worker.get_id())
+    {
+        m_worker.join();
+    }
+}
+
+std::size_t IngestionQueue::size() const
+{
+    return m_buffer.size() + m_controlBuffer.size();
+}
+
+bool IngestionQueue::hasPendingControl() const
+{
+    return !m_controlBuffer.empty() || !m_deferredControl.empty() || m_controlOverflowing.load();
+}
+
+QueueLatency IngestionQueue::getLatency(Priority priority) const
+{
+    const auto& counters = priority == Priority::CONTROL ? m_controlLatency : m_bulkLatency;
+
+    QueueLatency latency;
+    latency.count = counters.count.load(std::memory_order_relaxed);
+    latency.total = std::chrono::microseconds{counters.total.load(std::memory_order_relaxed)};
+    latency.max = std::chrono::microseconds{counters.max.load(std::memory_order_relaxed)};
+    return latency;
+}
+
+void IngestionQueue::run()
+{
+    std::vector<IngestionRecord> batch;
+    batch.reserve(m_batchSize);
+
+    while (m_run)
+    {
+        handleControl(batch);
+
+        m_buffer.popBatch(batch, m_batchSize);
+        if (!batch.empty())
+        {
+            notifySpace();
+            handle(batch, m_bulkLatency);
+        }
+
+        if (!m_deferred.empty())
+        {
+            batch.swap(m_deferred);
+            handle(batch, m_bulkLatency);
+
+            continue;
+        }
+
+        if (empty())
+        {
+            std::unique_lock<std::mutex> lock{m_mutex};
+
+            m_sleeping.store(true);
+            std::atomic_thread_fence(std::memory_order_seq_cst);
+
+            if (m_run && empty())
+            {
+                m_condition.wait_for(lock, IDLE_WAIT);
+            }
+
+            m_sleeping.store(false);
+        }
+    }
+}
+
+bool IngestionQueue::empty() const
+{
+    return m_buffer.empty() && m_controlBuffer.empty() && m_deferredControl.empty() && !m_controlOverflowing.load();
+}
+
+void IngestionQueue::pushOverflowControl(IngestionRecord record)
+{
+    std::lock_guard<std::mutex> lock{m_overflowMutex};
+
+    m_overflowControl.push_back(std::move(record));
+    m_controlOverflowing.store(true);
+}
+
+void IngestionQueue::handleControl(std::vector<IngestionRecord>& batch)
+{
+    // control records pushed by the handler itself are handled before returning to bulk records
+    while (m_run)
+    {
+        m_controlBuffer.popBatch(batch, CONTROL_CAPACITY);
+        if (batch.empty() && m_controlOverflowing.load())
+        {
+            std::lock_guard<std::mutex> lock{m_overflowMutex};
+
+            batch.swap(m_overflowControl);
+            m_controlOverflowing.store(false);
+        }
+
+        if (batch.empty())
+        {
+            batch.swap(m_deferredControl);
+        }
+
+        if (batch.empty())
+        {
+            return;
+        }
+
+        handle(batch, m_controlLatency);
+    }
+}
+
+void IngestionQueue::handle(std::vector<IngestionRecord>& batch, LatencyCounters& latency)
+{
+    const auto now = std::chrono::steady_clock::now();
+
+    std::int64_t total = 0;
+    std::int64_t max = latency.max.load(std::memory_order_relaxed);
+    for (const auto& record : batch)
+    {
+        const auto waited = std::chrono::duration_cast<std::chrono::microseconds>(now - record.enqueuedAt).count();
+        total += waited;
+        max = std::max(max, static_cast<std::int64_t>(waited));
+    }
+
+    latency.count.fetch_add(batch.size(), std::memory_order_relaxed);
+    latency.total.fetch_add(total, std::memory_order_relaxed);
+    latency.max.store(max, std::memory_order_relaxed);
+
+    m_handler(batch);
+    batch.clear();
+}
+
+void IngestionQueue::waitForSpace()
+{
+    std::unique_lock<std::mutex> lock{m_spaceMutex};
+
+    ++m_waitingProducers;
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+
+    m_spaceAvailable.wait_for(lock, SPACE_WAIT,
+                              [this] { return !m_run || m_buffer.size() < m_buffer.capacity(); });
+
+    --m_waitingProducers;
+}
+
+void IngestionQueue::notifySpace()
+{
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+
+    if (m_waitingProducers.load() > 0)
+    {
+        std::lock_guard<std::mutex> lock{m_spaceMutex};
+        m_spaceAvailable.notify_all();
+    }
+}
+
+void IngestionQueue::wakeUp()
+{
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+
+    if (m_sleeping.load())
+    {
+        std::lock_guard<std::mutex> lock{m_mutex};
+        m_condition.notify_one();
+    }
+}
+}    // namespace wolkabout
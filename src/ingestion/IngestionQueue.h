@@ -0,0 +1,182 @@
+/*
+ * Copyright 2020 WolkAbout Technology s.r.o.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef INGESTIONQUEUE_H
+#define INGESTIONQUEUE_H
+
+#include "ingestion/IngestionRecord.h"
+#include "utilities/MpscRingBuffer.h"
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace wolkabout
+{
+/**
+ * @brief Time records of one priority class spent in queue before being handed to the handler
+ */
+struct QueueLatency
+{
+    std::uint64_t count = 0;
+    std::chrono::microseconds total{0};
+    std::chrono::microseconds max{0};
+
+    std::chrono::microseconds average() const
+    {
+        return count == 0 ? std::chrono::microseconds{0} : total / static_cast<std::int64_t>(count);
+    }
+
+    QueueLatency& operator+=(const QueueLatency& other)
+    {
+        count += other.count;
+        total += other.total;
+        max = std::max(max, other.max);
+        return *this;
+    }
+};
+
+/**
+ * @brief Time in queue of control commands (actuation, configuration, connection changes),
+ *        and of data records and publishing of data
+ */
+struct CommandLatency
+{
+    QueueLatency control;
+    QueueLatency data;
+};
+
+/**
+ * @brief Bounded queue of wolkabout::IngestionRecord with a single worker thread.<br>
+ *        Producers enqueue without taking a lock, and the worker hands records to the handler in batches.<br>
+ *        Producers of bulk records sleep while the queue is full, until the worker takes a batch off it.
+ */
+class IngestionQueue
+{
+public:
+    typedef std::function<void(std::vector<IngestionRecord>& records)> BatchHandler;
+
+    /**
+     * @brief Control records are handed to the handler ahead of any bulk records,
+     *        and are checked for between every batch of bulk records
+     */
+    enum class Priority
+    {
+        BULK,
+        CONTROL
+    };
+
+    explicit IngestionQueue(BatchHandler handler, std::size_t capacity = DEFAULT_CAPACITY,
+                            std::size_t batchSize = DEFAULT_BATCH_SIZE);
+
+    ~IngestionQueue();
+
+    IngestionQueue(const IngestionQueue&) = delete;
+    IngestionQueue& operator=(const IngestionQueue&) = delete;
+
+    /**
+     * @brief Enqueues record. Bulk records wait, without spinning, while the queue is full.<br>
+     *        Control records never wait: once their ring is full they overflow into a list behind it,
+     *        so lanes which push control records into each other can not block one another.<br>
+     *        When invoked from the worker thread itself, record is deferred to the next batch instead.
+     */
+    void push(IngestionRecord record, Priority priority = Priority::BULK);
+
+    /**
+     * @brief Stops the worker thread. Records still in the queue are discarded.
+     */
+    void stop();
+
+    std::size_t size() const;
+
+    /**
+     * @brief Checks whether control records are waiting, so that a long running bulk record can stop early.<br>
+     *        Must be called from the worker thread, i.e. by the handler
+     */
+    bool hasPendingControl() const;
+
+    /**
+     * @brief Time in queue of records handed to the handler so far, per priority class. Safe to call from any thread
+     */
+    QueueLatency getLatency(Priority priority) const;
+
+    static const constexpr std::size_t DEFAULT_CAPACITY = 8192;
+    static const constexpr std::size_t DEFAULT_BATCH_SIZE = 256;
+    static const constexpr std::size_t CONTROL_CAPACITY = 256;
+
+private:
+    struct LatencyCounters
+    {
+        std::atomic<std::uint64_t> count{0};
+        std::atomic<std::int64_t> total{0};
+        std::atomic<std::int64_t> max{0};
+    };
+
+    void run();
+    void wakeUp();
+
+    // Blocks producer of bulk records until the worker takes records off the full buffer
+    void waitForSpace();
+    void notifySpace();
+
+    bool empty() const;
+
+    void pushOverflowControl(IngestionRecord record);
+
+    // Hands all pending control records to the handler
+    void handleControl(std::vector<IngestionRecord>& batch);
+    void handle(std::vector<IngestionRecord>& batch, LatencyCounters& latency);
+
+    MpscRingBuffer<IngestionRecord> m_buffer;
+    MpscRingBuffer<IngestionRecord> m_controlBuffer;
+    const std::size_t m_batchSize;
+
+    BatchHandler m_handler;
+
+    // Records pushed by the worker itself while the buffer was full
+    std::vector<IngestionRecord> m_deferred;
+    std::vector<IngestionRecord> m_deferredControl;
+
+    // Control records pushed by other threads while the control buffer was full
+    std::mutex m_overflowMutex;
+    std::vector<IngestionRecord> m_overflowControl;
+    std::atomic_bool m_controlOverflowing;
+
+    // Written only by the worker
+    LatencyCounters m_bulkLatency;
+    LatencyCounters m_controlLatency;
+
+    std::atomic_bool m_run;
+    std::atomic_bool m_sleeping;
+    std::mutex m_mutex;
+    std::condition_variable m_condition;
+
+    std::atomic<unsigned int> m_waitingProducers;
+    std::mutex m_spaceMutex;
+    std::condition_variable m_spaceAvailable;
+
+    std::thread m_worker;
+};
+}    // namespace wolkabout
+
+#endif    // INGESTIONQUEUE_H
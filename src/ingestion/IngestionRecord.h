@@ -0,0 +1,61 @@
+/*
+ * Copyright 2020 WolkAbout Technology s.r.o.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef INGESTIONRECORD_H
+#define INGESTIONRECORD_H
+
+#include "model/ReadingEntry.h"
+#include "model/ReadingValue.h"
+#include "utilities/ReferenceRegistry.h"
+
+#include <chrono>
+#include <functional>
+#include <vector>
+
+namespace wolkabout
+{
+/**
+ * @brief Fixed-size entry of the ingestion queue.<br>
+ *        Single readings and alarms carry the handle of their reference and a ReadingValue by value,
+ *        so enqueueing them neither copies the reference nor wraps a lambda into a heap allocated std::function.
+ */
+struct IngestionRecord
+{
+    enum class Type
+    {
+        NONE,
+        SENSOR_READING,
+        SENSOR_READINGS,
+        ALARM,
+        COMMAND
+    };
+
+    Type type = Type::NONE;
+
+    ReferenceHandle handle;
+    ReadingValue value;
+    std::vector<ReadingEntry> readings;
+    bool active = false;
+    unsigned long long int rtc = 0;
+
+    std::function<void()> command;
+
+    // set by wolkabout::IngestionQueue, to measure time spent in queue
+    std::chrono::steady_clock::time_point enqueuedAt;
+};
+}    // namespace wolkabout
+
+#endif    // INGESTIONRECORD_H
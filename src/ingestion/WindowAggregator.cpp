@@ -0,0 +1,152 @@
+/*
+ * Copyright 2020 WolkAbout Technology s.r.o.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "ingestion/WindowAggregator.h"
+
+#include "utilities/Logger.h"
+
+#include <algorithm>
+
+namespace wolkabout
+{
+void WindowAggregator::setAggregation(const std::string& reference, Aggregation aggregation)
+{
+    if (aggregation.window.count() <= 0 || aggregation.statistics.empty() ||
+        aggregation.statistics.size() > ReadingValue::MAX_NUMERIC_VALUES)
+    {
+        LOG(WARN) << "WindowAggregator: Invalid aggregation for reference '" << reference << "'";
+        return;
+    }
+
+    auto& channel = m_channels[reference];
+    channel.reference = reference;
+    channel.aggregation = std::move(aggregation);
+    channel.count = 0;
+}
+
+void WindowAggregator::bind(ReferenceHandle handle, const std::string& reference)
+{
+    if (!handle.isValid())
+    {
+        return;
+    }
+
+    const auto it = m_channels.find(reference);
+    if (it == m_channels.end())
+    {
+        return;
+    }
+
+    if (handle.id >= m_boundChannels.size())
+    {
+        m_boundChannels.resize(handle.id + 1, nullptr);
+    }
+
+    m_boundChannels[handle.id] = &it->second;
+}
+
+bool WindowAggregator::add(const std::string& reference, const ReadingValue& value, unsigned long long int rtc,
+                           std::vector<ReadingEntry>& closed)
+{
+    const auto it = m_channels.find(reference);
+    return it != m_channels.end() && add(it->second, value, rtc, closed);
+}
+
+bool WindowAggregator::add(ReferenceHandle handle, const ReadingValue& value, unsigned long long int rtc,
+                           std::vector<ReadingEntry>& closed)
+{
+    if (handle.id >= m_boundChannels.size() || !m_boundChannels[handle.id])
+    {
+        return false;
+    }
+
+    return add(*m_boundChannels[handle.id], value, rtc, closed);
+}
+
+void WindowAggregator::closeExpired(unsigned long long int rtc, std::vector<ReadingEntry>& closed)
+{
+    for (auto& pair : m_channels)
+    {
+        auto& channel = pair.second;
+        const auto window = static_cast<unsigned long long int>(channel.aggregation.window.count());
+        if (channel.count != 0 && channel.windowStart + window <= rtc)
+        {
+            close(channel, closed);
+        }
+    }
+}
+
+bool WindowAggregator::add(Channel& channel, const ReadingValue& value, unsigned long long int rtc,
+                           std::vector<ReadingEntry>& closed)
+{
+    if (!value.isNumeric() || value.isMultiValue())
+    {
+        return false;
+    }
+
+    const auto window = static_cast<unsigned long long int>(channel.aggregation.window.count());
+    const auto windowStart = rtc - rtc % window;
+
+    if (channel.count != 0 && windowStart > channel.windowStart)
+    {
+        close(channel, closed);
+    }
+
+    const double number = value.toDouble();
+    if (channel.count == 0)
+    {
+        channel.windowStart = windowStart;
+        channel.min = number;
+        channel.max = number;
+        channel.sum = 0;
+    }
+
+    channel.min = std::min(channel.min, number);
+    channel.max = std::max(channel.max, number);
+    channel.sum += number;
+    ++channel.count;
+
+    return true;
+}
+
+void WindowAggregator::close(Channel& channel, std::vector<ReadingEntry>& closed)
+{
+    std::vector<double> statistics;
+    statistics.reserve(channel.aggregation.statistics.size());
+
+    for (const auto statistic : channel.aggregation.statistics)
+    {
+        switch (statistic)
+        {
+        case Statistic::MIN:
+            statistics.push_back(channel.min);
+            break;
+        case Statistic::MAX:
+            statistics.push_back(channel.max);
+            break;
+        case Statistic::AVERAGE:
+            statistics.push_back(channel.sum / static_cast<double>(channel.count));
+            break;
+        case Statistic::COUNT:
+            statistics.push_back(static_cast<double>(channel.count));
+            break;
+        }
+    }
+
+    closed.emplace_back(channel.reference, statistics, channel.windowStart);
+    channel.count = 0;
+}
+}    // namespace wolkabout
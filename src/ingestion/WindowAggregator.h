@@ -0,0 +1,103 @@
+/*
+ * Copyright 2020 WolkAbout Technology s.r.o.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef WINDOWAGGREGATOR_H
+#define WINDOWAGGREGATOR_H
+
+#include "model/ReadingEntry.h"
+#include "model/ReadingValue.h"
+#include "utilities/ReferenceRegistry.h"
+
+#include <chrono>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace wolkabout
+{
+enum class Statistic
+{
+    MIN,
+    MAX,
+    AVERAGE,
+    COUNT
+};
+
+/**
+ * @brief Tumbling window over which sensor readings are aggregated, and statistics sent for each window.<br>
+ *        Each window is sent as single multi-value reading holding statistics in given order,
+ *        timestamped with start of the window.
+ */
+struct Aggregation
+{
+    std::chrono::milliseconds window{0};
+    std::vector<Statistic> statistics{Statistic::MIN, Statistic::MAX, Statistic::AVERAGE, Statistic::COUNT};
+};
+
+/**
+ * @brief Replaces numeric sensor readings of references with wolkabout::Aggregation by statistics of their windows.<br>
+ *        Window is closed by first reading which falls outside of it, or by closeExpired.
+ *        Readings older than the open window are aggregated into it. Not thread safe.
+ */
+class WindowAggregator
+{
+public:
+    void setAggregation(const std::string& reference, Aggregation aggregation);
+
+    /**
+     * @brief Makes aggregation of reference apply to readings added by its handle
+     */
+    void bind(ReferenceHandle handle, const std::string& reference);
+
+    /**
+     * @brief Aggregates reading
+     * @param closed Reading of the window closed by this one is appended to it
+     * @return false if reading is not aggregated, and should be stored as is
+     */
+    bool add(const std::string& reference, const ReadingValue& value, unsigned long long int rtc,
+             std::vector<ReadingEntry>& closed);
+    bool add(ReferenceHandle handle, const ReadingValue& value, unsigned long long int rtc,
+             std::vector<ReadingEntry>& closed);
+
+    /**
+     * @brief Closes windows which ended before rtc
+     * @param closed Readings of closed windows are appended to it
+     */
+    void closeExpired(unsigned long long int rtc, std::vector<ReadingEntry>& closed);
+
+private:
+    struct Channel
+    {
+        std::string reference;
+        Aggregation aggregation;
+
+        unsigned long long int windowStart = 0;
+        std::size_t count = 0;
+        double min = 0;
+        double max = 0;
+        double sum = 0;
+    };
+
+    static bool add(Channel& channel, const ReadingValue& value, unsigned long long int rtc,
+                    std::vector<ReadingEntry>& closed);
+    static void close(Channel& channel, std::vector<ReadingEntry>& closed);
+
+    std::unordered_map<std::string, Channel> m_channels;
+    std::vector<Channel*> m_boundChannels;
+};
+}    // namespace wolkabout
+
+#endif    // WINDOWAGGREGATOR_H
@@ -0,0 +1,119 @@
+/*
+ * Copyright 2020 WolkAbout Technology s.r.o.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef PUBLISHRESULT_H
+#define PUBLISHRESULT_H
+
+#include <chrono>
+#include <cstdint>
+
+namespace wolkabout
+{
+/**
+ * @brief Number of items of a single type published, and left in persistence, by a publish attempt
+ */
+struct PublishCounts
+{
+    std::uint64_t sent = 0;
+    std::uint64_t remaining = 0;
+
+    /**
+     * @brief Number of messages the sent items were packed into
+     */
+    std::uint64_t messages = 0;
+
+    /**
+     * @brief Size of payloads of sent messages, in bytes
+     */
+    std::uint64_t bytes = 0;
+
+    /**
+     * @brief Number of times a message turned out larger than the maximum payload size, and its batch was halved
+     */
+    std::uint64_t splits = 0;
+
+    /**
+     * @brief Whether publishing stopped because its budget was spent, rather than because a publish failed
+     */
+    bool yielded = false;
+
+    /**
+     * @brief Whether publishing was skipped because connection was down, leaving items in persistence.<br>
+     *        Items left are still counted in remaining, without being read for publishing
+     */
+    bool suppressed = false;
+
+    /**
+     * @brief Whether publishing of sensor readings stopped early because alarms, actuator statuses,
+     *        or configuration were added meanwhile, and are to be published first
+     */
+    bool preempted = false;
+
+    PublishCounts& operator+=(const PublishCounts& other)
+    {
+        sent += other.sent;
+        remaining += other.remaining;
+        messages += other.messages;
+        bytes += other.bytes;
+        splits += other.splits;
+        yielded = yielded || other.yielded;
+        suppressed = suppressed || other.suppressed;
+        preempted = preempted || other.preempted;
+        return *this;
+    }
+};
+
+/**
+ * @brief Outcome of wolkabout::Wolk::publish
+ */
+struct PublishResult
+{
+    PublishCounts sensorReadings;
+    PublishCounts alarms;
+    PublishCounts actuatorStatuses;
+    PublishCounts configuration;
+
+    /**
+     * @brief Time spent publishing, not including time spent waiting in the command queue
+     */
+    std::chrono::milliseconds elapsed{0};
+
+    /**
+     * @brief Whether publishing stopped on a failed publish, or was skipped while offline, leaving items in persistence
+     */
+    bool stalled() const
+    {
+        return sensorReadings.remaining != 0 || alarms.remaining != 0 || actuatorStatuses.remaining != 0 ||
+               configuration.remaining != 0 || sensorReadings.suppressed || alarms.suppressed ||
+               actuatorStatuses.suppressed || configuration.suppressed;
+    }
+};
+
+/**
+ * @brief Number of publish calls skipped because connection was down, per item type
+ */
+struct SuppressedPublishes
+{
+    std::uint64_t sensorReadings = 0;
+    std::uint64_t alarms = 0;
+    std::uint64_t actuatorStatuses = 0;
+    std::uint64_t configuration = 0;
+
+    std::uint64_t total() const { return sensorReadings + alarms + actuatorStatuses + configuration; }
+};
+}    // namespace wolkabout
+
+#endif    // PUBLISHRESULT_H
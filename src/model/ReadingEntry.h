@@ -0,0 +1,52 @@
+/*
+ * Copyright 2020 WolkAbout Technology s.r.o.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef READINGENTRY_H
+#define READINGENTRY_H
+
+#include "model/ReadingValue.h"
+
+#include <string>
+#include <utility>
+
+namespace wolkabout
+{
+/**
+ * @brief Single sensor reading of a batch passed to wolkabout::Wolk::addSensorReadings
+ */
+struct ReadingEntry
+{
+    ReadingEntry() = default;
+
+    /**
+     * @param sensorReference Sensor reference
+     * @param sensorValue Sensor value, of any type accepted by wolkabout::Wolk::addSensorReading
+     * @param readingRtc Reading POSIX time in milliseconds<br>
+     *            If omitted current POSIX time is adopted
+     */
+    template <typename T>
+    ReadingEntry(std::string sensorReference, const T& sensorValue, unsigned long long int readingRtc = 0)
+    : reference{std::move(sensorReference)}, value{sensorValue}, rtc{readingRtc}
+    {
+    }
+
+    std::string reference;
+    ReadingValue value;
+    unsigned long long int rtc = 0;
+};
+}    // namespace wolkabout
+
+#endif    // READINGENTRY_H
@@ -0,0 +1,293 @@
+/*
+ * Copyright 2020 WolkAbout Technology s.r.o.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "model/ReadingValue.h"
+
+#include <utility>
+
+namespace wolkabout
+{
+const constexpr std::size_t ReadingValue::MAX_NUMERIC_VALUES;
+
+ReadingValue::ReadingValue() : m_type{Type::STRING}, m_multiValue{false}, m_size{0}, m_numbers{} {}
+
+ReadingValue::ReadingValue(bool value) : ReadingValue()
+{
+    set(0, value);
+    m_size = 1;
+}
+
+ReadingValue::ReadingValue(int value) : ReadingValue()
+{
+    set(0, value);
+    m_size = 1;
+}
+
+ReadingValue::ReadingValue(long value) : ReadingValue()
+{
+    set(0, value);
+    m_size = 1;
+}
+
+ReadingValue::ReadingValue(long long value) : ReadingValue()
+{
+    set(0, value);
+    m_size = 1;
+}
+
+ReadingValue::ReadingValue(unsigned int value) : ReadingValue()
+{
+    set(0, value);
+    m_size = 1;
+}
+
+ReadingValue::ReadingValue(unsigned long value) : ReadingValue()
+{
+    set(0, value);
+    m_size = 1;
+}
+
+ReadingValue::ReadingValue(unsigned long long value) : ReadingValue()
+{
+    set(0, value);
+    m_size = 1;
+}
+
+ReadingValue::ReadingValue(float value) : ReadingValue()
+{
+    set(0, value);
+    m_size = 1;
+}
+
+ReadingValue::ReadingValue(double value) : ReadingValue()
+{
+    set(0, value);
+    m_size = 1;
+}
+
+ReadingValue::ReadingValue(const char* value) : ReadingValue(std::string(value)) {}
+
+ReadingValue::ReadingValue(std::string value) : ReadingValue()
+{
+    m_strings.push_back(std::move(value));
+}
+
+ReadingValue::ReadingValue(std::vector<std::string> values) : ReadingValue()
+{
+    m_multiValue = true;
+    m_strings = std::move(values);
+}
+
+ReadingValue::Type ReadingValue::getType() const
+{
+    return m_type;
+}
+
+bool ReadingValue::isNumeric() const
+{
+    return m_type != Type::STRING;
+}
+
+bool ReadingValue::isMultiValue() const
+{
+    return m_multiValue;
+}
+
+std::size_t ReadingValue::size() const
+{
+    return isNumeric() ? m_size : m_strings.size();
+}
+
+double ReadingValue::toDouble(std::size_t index) const
+{
+    if (index >= size())
+    {
+        return 0;
+    }
+
+    const Number& number = m_numbers[index];
+    switch (m_type)
+    {
+    case Type::BOOL:
+        return number.b ? 1 : 0;
+    case Type::INT:
+        return number.i;
+    case Type::LONG:
+        return static_cast<double>(number.l);
+    case Type::LONG_LONG:
+        return static_cast<double>(number.ll);
+    case Type::UNSIGNED_INT:
+        return number.ui;
+    case Type::UNSIGNED_LONG:
+        return static_cast<double>(number.ul);
+    case Type::UNSIGNED_LONG_LONG:
+        return static_cast<double>(number.ull);
+    case Type::FLOAT:
+        return static_cast<double>(number.f);
+    case Type::DOUBLE:
+        return number.d;
+    case Type::STRING:
+        return 0;
+    }
+
+    return 0;
+}
+
+std::string ReadingValue::toString(std::size_t index) const
+{
+    if (index >= size())
+    {
+        return "";
+    }
+
+    const Number& number = m_numbers[index];
+    switch (m_type)
+    {
+    case Type::BOOL:
+        return StringUtils::toString(number.b);
+    case Type::INT:
+        return StringUtils::toString(number.i);
+    case Type::LONG:
+        return StringUtils::toString(number.l);
+    case Type::LONG_LONG:
+        return StringUtils::toString(number.ll);
+    case Type::UNSIGNED_INT:
+        return StringUtils::toString(number.ui);
+    case Type::UNSIGNED_LONG:
+        return StringUtils::toString(number.ul);
+    case Type::UNSIGNED_LONG_LONG:
+        return StringUtils::toString(number.ull);
+    case Type::FLOAT:
+        return StringUtils::toString(number.f);
+    case Type::DOUBLE:
+        return StringUtils::toString(number.d);
+    case Type::STRING:
+        return m_strings[index];
+    }
+
+    return "";
+}
+
+std::vector<std::string> ReadingValue::toStrings() const
+{
+    if (!isNumeric())
+    {
+        return m_strings;
+    }
+
+    std::vector<std::string> values;
+    values.reserve(m_size);
+    for (std::size_t i = 0; i < m_size; ++i)
+    {
+        values.push_back(toString(i));
+    }
+
+    return values;
+}
+
+std::size_t ReadingValue::byteSize() const
+{
+    std::size_t size = sizeof(ReadingValue);
+    for (const auto& value : m_strings)
+    {
+        size += sizeof(std::string) + value.capacity();
+    }
+
+    return size;
+}
+
+bool ReadingValue::operator==(const ReadingValue& other) const
+{
+    if (m_type != other.m_type || m_multiValue != other.m_multiValue || size() != other.size())
+    {
+        return false;
+    }
+
+    if (!isNumeric())
+    {
+        return m_strings == other.m_strings;
+    }
+
+    for (std::size_t i = 0; i < m_size; ++i)
+    {
+        if (toString(i) != other.toString(i))
+        {
+            return false;
+        }
+    }
+
+    return true;
+}
+
+bool ReadingValue::operator!=(const ReadingValue& other) const
+{
+    return !(*this == other);
+}
+
+void ReadingValue::set(std::size_t index, bool value)
+{
+    m_type = Type::BOOL;
+    m_numbers[index].b = value;
+}
+
+void ReadingValue::set(std::size_t index, int value)
+{
+    m_type = Type::INT;
+    m_numbers[index].i = value;
+}
+
+void ReadingValue::set(std::size_t index, long value)
+{
+    m_type = Type::LONG;
+    m_numbers[index].l = value;
+}
+
+void ReadingValue::set(std::size_t index, long long value)
+{
+    m_type = Type::LONG_LONG;
+    m_numbers[index].ll = value;
+}
+
+void ReadingValue::set(std::size_t index, unsigned int value)
+{
+    m_type = Type::UNSIGNED_INT;
+    m_numbers[index].ui = value;
+}
+
+void ReadingValue::set(std::size_t index, unsigned long value)
+{
+    m_type = Type::UNSIGNED_LONG;
+    m_numbers[index].ul = value;
+}
+
+void ReadingValue::set(std::size_t index, unsigned long long value)
+{
+    m_type = Type::UNSIGNED_LONG_LONG;
+    m_numbers[index].ull = value;
+}
+
+void ReadingValue::set(std::size_t index, float value)
+{
+    m_type = Type::FLOAT;
+    m_numbers[index].f = value;
+}
+
+void ReadingValue::set(std::size_t index, double value)
+{
+    m_type = Type::DOUBLE;
+    m_numbers[index].d = value;
+}
+}    // namespace wolkabout
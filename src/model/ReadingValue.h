@@ -0,0 +1,176 @@
+/*
+ * Copyright 2020 WolkAbout Technology s.r.o.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef READINGVALUE_H
+#define READINGVALUE_H
+
+#include "utilities/StringUtils.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <type_traits>
+#include <vector>
+
+namespace wolkabout
+{
+/**
+ * @brief Sensor reading value kept in its binary form.<br>
+ *        Numeric values, and multi-value readings of up to MAX_NUMERIC_VALUES numbers, are stored inline
+ *        and are only converted to text when the reading is about to be serialized.
+ *        Strings, and longer multi-value readings, are stored as text.
+ */
+class ReadingValue
+{
+public:
+    enum class Type : std::uint8_t
+    {
+        BOOL,
+        INT,
+        LONG,
+        LONG_LONG,
+        UNSIGNED_INT,
+        UNSIGNED_LONG,
+        UNSIGNED_LONG_LONG,
+        FLOAT,
+        DOUBLE,
+        STRING
+    };
+
+    static const constexpr std::size_t MAX_NUMERIC_VALUES = 4;
+
+    ReadingValue();
+
+    // Explicit, as pointers, string literals included, would otherwise implicitly convert to bool
+    explicit ReadingValue(bool value);
+    ReadingValue(int value);
+    ReadingValue(long value);
+    ReadingValue(long long value);
+    ReadingValue(unsigned int value);
+    ReadingValue(unsigned long value);
+    ReadingValue(unsigned long long value);
+    ReadingValue(float value);
+    ReadingValue(double value);
+
+    // Text and multi-value readings must be converted explicitly, so they do not compete
+    // with the existing std::string and std::vector<std::string> overloads
+    explicit ReadingValue(const char* value);
+    explicit ReadingValue(std::string value);
+
+    explicit ReadingValue(std::vector<std::string> values);
+
+    template <typename T> explicit ReadingValue(const std::vector<T>& values);
+
+    Type getType() const;
+
+    bool isNumeric() const;
+    bool isMultiValue() const;
+
+    /**
+     * @brief Number of values held
+     */
+    std::size_t size() const;
+
+    /**
+     * @brief Numeric value at index converted to double, 0 for text values
+     */
+    double toDouble(std::size_t index = 0) const;
+
+    /**
+     * @brief Formats value at index the same way StringUtils::toString formats the original type
+     */
+    std::string toString(std::size_t index = 0) const;
+
+    std::vector<std::string> toStrings() const;
+
+    /**
+     * @brief Approximate number of bytes the value occupies, including heap allocations
+     */
+    std::size_t byteSize() const;
+
+    bool operator==(const ReadingValue& other) const;
+    bool operator!=(const ReadingValue& other) const;
+
+private:
+    union Number {
+        bool b;
+        int i;
+        long l;
+        long long ll;
+        unsigned int ui;
+        unsigned long ul;
+        unsigned long long ull;
+        float f;
+        double d;
+    };
+
+    template <typename T> void assign(const std::vector<T>& values, std::true_type isArithmetic);
+    template <typename T> void assign(const std::vector<T>& values, std::false_type isArithmetic);
+
+    void set(std::size_t index, bool value);
+    void set(std::size_t index, int value);
+    void set(std::size_t index, long value);
+    void set(std::size_t index, long long value);
+    void set(std::size_t index, unsigned int value);
+    void set(std::size_t index, unsigned long value);
+    void set(std::size_t index, unsigned long long value);
+    void set(std::size_t index, float value);
+    void set(std::size_t index, double value);
+
+    Type m_type;
+    bool m_multiValue;
+    std::uint8_t m_size;
+
+    Number m_numbers[MAX_NUMERIC_VALUES];
+    std::vector<std::string> m_strings;
+};
+
+template <typename T> ReadingValue::ReadingValue(const std::vector<T>& values) : ReadingValue()
+{
+    m_multiValue = true;
+    assign(values, typename std::is_arithmetic<T>::type{});
+}
+
+template <typename T> void ReadingValue::assign(const std::vector<T>& values, std::true_type)
+{
+    if (values.size() > MAX_NUMERIC_VALUES)
+    {
+        assign(values, std::false_type{});
+        return;
+    }
+
+    for (std::size_t i = 0; i < values.size(); ++i)
+    {
+        set(i, values[i]);
+    }
+
+    m_size = static_cast<std::uint8_t>(values.size());
+}
+
+template <typename T> void ReadingValue::assign(const std::vector<T>& values, std::false_type)
+{
+    m_type = Type::STRING;
+    m_size = 0;
+
+    m_strings.reserve(values.size());
+    for (const auto& value : values)
+    {
+        m_strings.push_back(StringUtils::toString(value));
+    }
+}
+}    // namespace wolkabout
+
+#endif    // READINGVALUE_H
@@ -0,0 +1,131 @@
+/*
+ * Copyright 2020 WolkAbout Technology s.r.o.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "persistence/LockingPersistence.h"
+
+#include <utility>
+
+namespace wolkabout
+{
+LockingPersistence::LockingPersistence(std::shared_ptr<Persistence> persistence)
+: m_persistence{std::move(persistence)}
+{
+}
+
+bool LockingPersistence::putSensorReading(const std::string& key, std::shared_ptr<SensorReading> sensorReading)
+{
+    std::lock_guard<std::mutex> lock{m_mutex};
+    return m_persistence->putSensorReading(key, std::move(sensorReading));
+}
+
+std::vector<std::shared_ptr<SensorReading>> LockingPersistence::getSensorReadings(const std::string& key,
+                                                                                  std::uint_fast64_t count)
+{
+    std::lock_guard<std::mutex> lock{m_mutex};
+    return m_persistence->getSensorReadings(key, count);
+}
+
+void LockingPersistence::removeSensorReadings(const std::string& key, std::uint_fast64_t count)
+{
+    std::lock_guard<std::mutex> lock{m_mutex};
+    m_persistence->removeSensorReadings(key, count);
+}
+
+std::vector<std::string> LockingPersistence::getSensorReadingsKeys()
+{
+    std::lock_guard<std::mutex> lock{m_mutex};
+    return m_persistence->getSensorReadingsKeys();
+}
+
+bool LockingPersistence::putAlarm(const std::string& key, std::shared_ptr<Alarm> alarm)
+{
+    std::lock_guard<std::mutex> lock{m_mutex};
+    return m_persistence->putAlarm(key, std::move(alarm));
+}
+
+std::vector<std::shared_ptr<Alarm>> LockingPersistence::getAlarms(const std::string& key, std::uint_fast64_t count)
+{
+    std::lock_guard<std::mutex> lock{m_mutex};
+    return m_persistence->getAlarms(key, count);
+}
+
+void LockingPersistence::removeAlarms(const std::string& key, std::uint_fast64_t count)
+{
+    std::lock_guard<std::mutex> lock{m_mutex};
+    m_persistence->removeAlarms(key, count);
+}
+
+std::vector<std::string> LockingPersistence::getAlarmsKeys()
+{
+    std::lock_guard<std::mutex> lock{m_mutex};
+    return m_persistence->getAlarmsKeys();
+}
+
+bool LockingPersistence::putActuatorStatus(const std::string& key, std::shared_ptr<ActuatorStatus> actuatorStatus)
+{
+    std::lock_guard<std::mutex> lock{m_mutex};
+    return m_persistence->putActuatorStatus(key, std::move(actuatorStatus));
+}
+
+std::shared_ptr<ActuatorStatus> LockingPersistence::getActuatorStatus(const std::string& key)
+{
+    std::lock_guard<std::mutex> lock{m_mutex};
+    return m_persistence->getActuatorStatus(key);
+}
+
+void LockingPersistence::removeActuatorStatus(const std::string& key)
+{
+    std::lock_guard<std::mutex> lock{m_mutex};
+    m_persistence->removeActuatorStatus(key);
+}
+
+std::vector<std::string> LockingPersistence::getActuatorStatusesKeys()
+{
+    std::lock_guard<std::mutex> lock{m_mutex};
+    return m_persistence->getActuatorStatusesKeys();
+}
+
+bool LockingPersistence::putConfiguration(const std::string& key,
+                                          std::shared_ptr<std::vector<ConfigurationItem>> configuration)
+{
+    std::lock_guard<std::mutex> lock{m_mutex};
+    return m_persistence->putConfiguration(key, std::move(configuration));
+}
+
+std::shared_ptr<std::vector<ConfigurationItem>> LockingPersistence::getConfiguration(const std::string& key)
+{
+    std::lock_guard<std::mutex> lock{m_mutex};
+    return m_persistence->getConfiguration(key);
+}
+
+void LockingPersistence::removeConfiguration(const std::string& key)
+{
+    std::lock_guard<std::mutex> lock{m_mutex};
+    m_persistence->removeConfiguration(key);
+}
+
+std::vector<std::string> LockingPersistence::getConfigurationKeys()
+{
+    std::lock_guard<std::mutex> lock{m_mutex};
+    return m_persistence->getConfigurationKeys();
+}
+
+bool LockingPersistence::isEmpty()
+{
+    std::lock_guard<std::mutex> lock{m_mutex};
+    return m_persistence->isEmpty();
+}
+}    // namespace wolkabout
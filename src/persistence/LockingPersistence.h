@@ -0,0 +1,70 @@
+/*
+ * Copyright 2020 WolkAbout Technology s.r.o.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef LOCKINGPERSISTENCE_H
+#define LOCKINGPERSISTENCE_H
+
+#include "persistence/Persistence.h"
+
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+namespace wolkabout
+{
+/**
+ * @brief Serializes calls to a wolkabout::Persistence which is not known to be thread safe.<br>
+ *        Wolk stores data from its ingestion and control lanes while publishing it from the egress lane,
+ *        so plain persistence implementations are wrapped in this adapter.
+ */
+class LockingPersistence : public Persistence
+{
+public:
+    explicit LockingPersistence(std::shared_ptr<Persistence> persistence);
+
+    bool putSensorReading(const std::string& key, std::shared_ptr<SensorReading> sensorReading) override;
+    std::vector<std::shared_ptr<SensorReading>> getSensorReadings(const std::string& key,
+                                                                  std::uint_fast64_t count) override;
+    void removeSensorReadings(const std::string& key, std::uint_fast64_t count) override;
+    std::vector<std::string> getSensorReadingsKeys() override;
+
+    bool putAlarm(const std::string& key, std::shared_ptr<Alarm> alarm) override;
+    std::vector<std::shared_ptr<Alarm>> getAlarms(const std::string& key, std::uint_fast64_t count) override;
+    void removeAlarms(const std::string& key, std::uint_fast64_t count) override;
+    std::vector<std::string> getAlarmsKeys() override;
+
+    bool putActuatorStatus(const std::string& key, std::shared_ptr<ActuatorStatus> actuatorStatus) override;
+    std::shared_ptr<ActuatorStatus> getActuatorStatus(const std::string& key) override;
+    void removeActuatorStatus(const std::string& key) override;
+    std::vector<std::string> getActuatorStatusesKeys() override;
+
+    bool putConfiguration(const std::string& key,
+                          std::shared_ptr<std::vector<ConfigurationItem>> configuration) override;
+    std::shared_ptr<std::vector<ConfigurationItem>> getConfiguration(const std::string& key) override;
+    void removeConfiguration(const std::string& key) override;
+    std::vector<std::string> getConfigurationKeys() override;
+
+    bool isEmpty() override;
+
+private:
+    std::shared_ptr<Persistence> m_persistence;
+    std::mutex m_mutex;
+};
+}    // namespace wolkabout
+
+#endif    // LOCKINGPERSISTENCE_H
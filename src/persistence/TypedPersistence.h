@@ -0,0 +1,92 @@
+/*
+ * Copyright 2020 WolkAbout Technology s.r.o.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef TYPEDPERSISTENCE_H
+#define TYPEDPERSISTENCE_H
+
+#include "ingestion/BufferLimiter.h"
+#include "model/ReadingEntry.h"
+#include "model/ReadingValue.h"
+#include "persistence/Persistence.h"
+#include "utilities/ReferenceRegistry.h"
+
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace wolkabout
+{
+/**
+ * @brief Persistence capable of storing sensor readings in their binary form.<br>
+ *        Readings stored through this interface are converted to wolkabout::SensorReading,
+ *        and their values formatted, only once they are retrieved for publishing.<br>
+ *        Readings may be keyed with handles of the persistence's wolkabout::ReferenceRegistry,
+ *        in which case the key is resolved to a string only when keys are listed.<br>
+ *        Implementations must be thread safe: readings are stored from the ingestion and control lanes
+ *        while they are retrieved and removed from the egress lane.
+ */
+class TypedPersistence : public Persistence
+{
+public:
+    using Persistence::putSensorReading;
+
+    /**
+     * @brief Inserts sensor reading value
+     * @param key Key with which sensor reading should be associated
+     * @param value Sensor reading value
+     * @param rtc Reading POSIX time in milliseconds
+     * @return true if successful, or false if failed
+     */
+    virtual bool putSensorReading(const std::string& key, const ReadingValue& value, unsigned long long int rtc) = 0;
+
+    /**
+     * @brief Inserts sensor reading value
+     * @param handle Handle, obtained from getReferenceRegistry(), of the key with which sensor reading should be
+     *               associated
+     * @param value Sensor reading value
+     * @param rtc Reading POSIX time in milliseconds
+     * @return true if successful, or false if failed
+     */
+    virtual bool putSensorReading(ReferenceHandle handle, const ReadingValue& value, unsigned long long int rtc) = 0;
+
+    /**
+     * @brief Inserts batch of sensor readings at once, each associated with its sensor reference
+     * @param readings Sensor readings
+     * @return true if successful, or false if failed
+     */
+    virtual bool putSensorReadings(const std::vector<ReadingEntry>& readings) = 0;
+
+    /**
+     * @brief Number of sensor readings associated with key, without retrieving them
+     */
+    virtual std::uint_fast64_t getSensorReadingsCount(const std::string& key) = 0;
+
+    /**
+     * @brief Registry through which keys of this persistence are interned
+     */
+    virtual ReferenceRegistry& getReferenceRegistry() = 0;
+
+    /**
+     * @brief Sets limiter which stored sensor readings are accounted in.<br>
+     *        Readings are reserved in the limiter when stored and released when removed,
+     *        and oldest readings are evicted whenever the limiter requires it.
+     */
+    virtual void setBufferLimiter(std::shared_ptr<BufferLimiter> bufferLimiter) = 0;
+};
+}    // namespace wolkabout
+
+#endif    // TYPEDPERSISTENCE_H
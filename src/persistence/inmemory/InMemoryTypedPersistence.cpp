@@ -0,0 +1,384 @@
+/*
+ * Copyright 2020 WolkAbout Technology s.r.o.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "persistence/inmemory/InMemoryTypedPersistence.h"
+
+#include "model/SensorReading.h"
+
+#include <algorithm>
+#include <limits>
+
+namespace wolkabout
+{
+namespace
+{
+std::size_t sensorReadingSize(const SensorReading& sensorReading)
+{
+    std::size_t size = sizeof(SensorReading) + sensorReading.getReference().capacity();
+    for (const auto& value : sensorReading.getValues())
+    {
+        size += sizeof(std::string) + value.capacity();
+    }
+
+    return size;
+}
+}    // namespace
+
+bool InMemoryTypedPersistence::putSensorReading(const std::string& key, std::shared_ptr<SensorReading> sensorReading)
+{
+    if (!sensorReading)
+    {
+        return false;
+    }
+
+    const auto handle = m_referenceRegistry.intern(key);
+
+    std::lock_guard<std::mutex> lock{m_mutex};
+
+    const auto rtc = sensorReading->getRtc();
+    const auto bytes = sizeof(StoredReading) + sensorReadingSize(*sensorReading);
+
+    return store(handle, StoredReading{ReadingValue{}, rtc, std::move(sensorReading), bytes, 0});
+}
+
+bool InMemoryTypedPersistence::putSensorReading(const std::string& key, const ReadingValue& value,
+                                                unsigned long long int rtc)
+{
+    return putSensorReading(m_referenceRegistry.intern(key), value, rtc);
+}
+
+bool InMemoryTypedPersistence::putSensorReading(ReferenceHandle handle, const ReadingValue& value,
+                                                unsigned long long int rtc)
+{
+    if (!handle.isValid())
+    {
+        return false;
+    }
+
+    std::lock_guard<std::mutex> lock{m_mutex};
+
+    return store(handle, StoredReading{value, rtc, nullptr, readingSize(value), 0});
+}
+
+bool InMemoryTypedPersistence::putSensorReadings(const std::vector<ReadingEntry>& readings)
+{
+    std::vector<ReferenceHandle> handles;
+    handles.reserve(readings.size());
+    for (const auto& reading : readings)
+    {
+        handles.push_back(m_referenceRegistry.intern(reading.reference));
+    }
+
+    std::lock_guard<std::mutex> lock{m_mutex};
+
+    bool stored = true;
+    for (std::size_t i = 0; i < readings.size(); ++i)
+    {
+        const auto& reading = readings[i];
+        stored &= store(handles[i], StoredReading{reading.value, reading.rtc, nullptr, readingSize(reading.value), 0});
+    }
+
+    return stored;
+}
+
+std::vector<std::shared_ptr<SensorReading>> InMemoryTypedPersistence::getSensorReadings(const std::string& key,
+                                                                                        std::uint_fast64_t count)
+{
+    std::vector<std::shared_ptr<SensorReading>> sensorReadings;
+
+    ReferenceHandle handle;
+    if (!m_referenceRegistry.find(key, handle))
+    {
+        return sensorReadings;
+    }
+
+    std::lock_guard<std::mutex> lock{m_mutex};
+
+    if (handle.id >= m_readings.size())
+    {
+        return sensorReadings;
+    }
+
+    auto& readings = m_readings[handle.id];
+    const auto size = static_cast<std::size_t>(std::min<std::uint_fast64_t>(count, readings.size()));
+
+    sensorReadings.reserve(size);
+    for (std::size_t i = 0; i < size; ++i)
+    {
+        auto& stored = readings[i];
+        if (!stored.reading)
+        {
+            stored.reading = stored.value.isMultiValue() ?
+                               std::make_shared<SensorReading>(stored.value.toStrings(), key, stored.rtc) :
+                               std::make_shared<SensorReading>(stored.value.toString(), key, stored.rtc);
+            stored.value = ReadingValue{};
+        }
+
+        sensorReadings.push_back(stored.reading);
+    }
+
+    // Retrieved readings may be in flight, and must stay in place until they are removed
+    m_pinned[handle.id] = std::max(m_pinned[handle.id], size);
+
+    return sensorReadings;
+}
+
+void InMemoryTypedPersistence::removeSensorReadings(const std::string& key, std::uint_fast64_t count)
+{
+    ReferenceHandle handle;
+    if (!m_referenceRegistry.find(key, handle))
+    {
+        return;
+    }
+
+    std::lock_guard<std::mutex> lock{m_mutex};
+
+    if (handle.id >= m_readings.size())
+    {
+        return;
+    }
+
+    auto& readings = m_readings[handle.id];
+    const auto size = static_cast<std::size_t>(std::min<std::uint_fast64_t>(count, readings.size()));
+
+    std::size_t bytes = 0;
+    for (std::size_t i = 0; i < size; ++i)
+    {
+        bytes += readings[i].bytes;
+    }
+
+    readings.erase(readings.begin(), readings.begin() + static_cast<std::ptrdiff_t>(size));
+    m_readingsCount -= size;
+
+    auto& pinned = m_pinned[handle.id];
+    pinned = pinned > size ? pinned - size : 0;
+
+    if (m_bufferLimiter)
+    {
+        m_bufferLimiter->release(size, bytes);
+    }
+}
+
+std::vector<std::string> InMemoryTypedPersistence::getSensorReadingsKeys()
+{
+    std::vector<ReferenceHandle> handles;
+    {
+        std::lock_guard<std::mutex> lock{m_mutex};
+
+        for (std::size_t id = 0; id < m_readings.size(); ++id)
+        {
+            if (!m_readings[id].empty())
+            {
+                ReferenceHandle handle;
+                handle.id = static_cast<std::uint32_t>(id);
+                handles.push_back(handle);
+            }
+        }
+    }
+
+    std::vector<std::string> keys;
+    keys.reserve(handles.size());
+    for (const auto& handle : handles)
+    {
+        keys.push_back(m_referenceRegistry.resolve(handle));
+    }
+
+    return keys;
+}
+
+std::uint_fast64_t InMemoryTypedPersistence::getSensorReadingsCount(const std::string& key)
+{
+    ReferenceHandle handle;
+    if (!m_referenceRegistry.find(key, handle))
+    {
+        return 0;
+    }
+
+    std::lock_guard<std::mutex> lock{m_mutex};
+
+    return handle.id < m_readings.size() ? m_readings[handle.id].size() : 0;
+}
+
+ReferenceRegistry& InMemoryTypedPersistence::getReferenceRegistry()
+{
+    return m_referenceRegistry;
+}
+
+void InMemoryTypedPersistence::setBufferLimiter(std::shared_ptr<BufferLimiter> bufferLimiter)
+{
+    std::lock_guard<std::mutex> lock{m_mutex};
+
+    m_bufferLimiter = std::move(bufferLimiter);
+}
+
+bool InMemoryTypedPersistence::putAlarm(const std::string& key, std::shared_ptr<Alarm> alarm)
+{
+    std::lock_guard<std::mutex> lock{m_persistenceMutex};
+    return m_persistence.putAlarm(key, alarm);
+}
+
+std::vector<std::shared_ptr<Alarm>> InMemoryTypedPersistence::getAlarms(const std::string& key,
+                                                                        std::uint_fast64_t count)
+{
+    std::lock_guard<std::mutex> lock{m_persistenceMutex};
+    return m_persistence.getAlarms(key, count);
+}
+
+void InMemoryTypedPersistence::removeAlarms(const std::string& key, std::uint_fast64_t count)
+{
+    std::lock_guard<std::mutex> lock{m_persistenceMutex};
+    m_persistence.removeAlarms(key, count);
+}
+
+std::vector<std::string> InMemoryTypedPersistence::getAlarmsKeys()
+{
+    std::lock_guard<std::mutex> lock{m_persistenceMutex};
+    return m_persistence.getAlarmsKeys();
+}
+
+bool InMemoryTypedPersistence::putActuatorStatus(const std::string& key, std::shared_ptr<ActuatorStatus> actuatorStatus)
+{
+    std::lock_guard<std::mutex> lock{m_persistenceMutex};
+    return m_persistence.putActuatorStatus(key, actuatorStatus);
+}
+
+std::shared_ptr<ActuatorStatus> InMemoryTypedPersistence::getActuatorStatus(const std::string& key)
+{
+    std::lock_guard<std::mutex> lock{m_persistenceMutex};
+    return m_persistence.getActuatorStatus(key);
+}
+
+void InMemoryTypedPersistence::removeActuatorStatus(const std::string& key)
+{
+    std::lock_guard<std::mutex> lock{m_persistenceMutex};
+    m_persistence.removeActuatorStatus(key);
+}
+
+std::vector<std::string> InMemoryTypedPersistence::getActuatorStatusesKeys()
+{
+    std::lock_guard<std::mutex> lock{m_persistenceMutex};
+    return m_persistence.getActuatorStatusesKeys();
+}
+
+bool InMemoryTypedPersistence::putConfiguration(const std::string& key,
+                                                std::shared_ptr<std::vector<ConfigurationItem>> configuration)
+{
+    std::lock_guard<std::mutex> lock{m_persistenceMutex};
+    return m_persistence.putConfiguration(key, configuration);
+}
+
+std::shared_ptr<std::vector<ConfigurationItem>> InMemoryTypedPersistence::getConfiguration(const std::string& key)
+{
+    std::lock_guard<std::mutex> lock{m_persistenceMutex};
+    return m_persistence.getConfiguration(key);
+}
+
+void InMemoryTypedPersistence::removeConfiguration(const std::string& key)
+{
+    std::lock_guard<std::mutex> lock{m_persistenceMutex};
+    m_persistence.removeConfiguration(key);
+}
+
+std::vector<std::string> InMemoryTypedPersistence::getConfigurationKeys()
+{
+    std::lock_guard<std::mutex> lock{m_persistenceMutex};
+    return m_persistence.getConfigurationKeys();
+}
+
+bool InMemoryTypedPersistence::isEmpty()
+{
+    {
+        std::lock_guard<std::mutex> lock{m_mutex};
+        if (m_readingsCount != 0)
+        {
+            return false;
+        }
+    }
+
+    std::lock_guard<std::mutex> lock{m_persistenceMutex};
+    return m_persistence.isEmpty();
+}
+
+std::size_t InMemoryTypedPersistence::readingSize(const ReadingValue& value)
+{
+    return sizeof(StoredReading) - sizeof(ReadingValue) + value.byteSize();
+}
+
+bool InMemoryTypedPersistence::store(ReferenceHandle handle, StoredReading reading)
+{
+    if (m_bufferLimiter && !m_bufferLimiter->reserve(reading.bytes))
+    {
+        return false;
+    }
+
+    reading.sequence = m_nextSequence++;
+    readingsFor(handle).push_back(std::move(reading));
+    ++m_readingsCount;
+
+    while (m_bufferLimiter && m_bufferLimiter->mustEvict() && m_readingsCount > 1)
+    {
+        if (!evictOldest())
+        {
+            break;
+        }
+    }
+
+    return true;
+}
+
+bool InMemoryTypedPersistence::evictOldest()
+{
+    // Oldest reading which is not pinned, as pinned ones may be in flight
+    std::size_t oldestId = 0;
+    auto oldestSequence = std::numeric_limits<std::uint64_t>::max();
+
+    for (std::size_t id = 0; id < m_readings.size(); ++id)
+    {
+        const auto& readings = m_readings[id];
+        const auto pinned = m_pinned[id];
+        if (pinned < readings.size() && readings[pinned].sequence < oldestSequence)
+        {
+            oldestId = id;
+            oldestSequence = readings[pinned].sequence;
+        }
+    }
+
+    if (oldestSequence == std::numeric_limits<std::uint64_t>::max())
+    {
+        return false;
+    }
+
+    auto& oldest = m_readings[oldestId];
+    const auto position = oldest.begin() + static_cast<std::ptrdiff_t>(m_pinned[oldestId]);
+    const auto bytes = position->bytes;
+    oldest.erase(position);
+    --m_readingsCount;
+
+    m_bufferLimiter->evicted(bytes);
+    return true;
+}
+
+std::deque<InMemoryTypedPersistence::StoredReading>& InMemoryTypedPersistence::readingsFor(ReferenceHandle handle)
+{
+    if (handle.id >= m_readings.size())
+    {
+        m_readings.resize(handle.id + 1);
+        m_pinned.resize(handle.id + 1, 0);
+    }
+
+    return m_readings[handle.id];
+}
+}    // namespace wolkabout
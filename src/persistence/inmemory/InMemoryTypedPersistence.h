@@ -0,0 +1,127 @@
+/*
+ * Copyright 2020 WolkAbout Technology s.r.o.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef INMEMORYTYPEDPERSISTENCE_H
+#define INMEMORYTYPEDPERSISTENCE_H
+
+#include "ingestion/BufferLimiter.h"
+#include "model/ReadingEntry.h"
+#include "model/ReadingValue.h"
+#include "persistence/TypedPersistence.h"
+#include "persistence/inmemory/InMemoryPersistence.h"
+#include "utilities/ReferenceRegistry.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+namespace wolkabout
+{
+/**
+ * @brief In-memory persistence which keeps sensor reading values in their binary form
+ *        until they are retrieved for publishing.<br>
+ *        Sensor readings are stored by handle of their key, which is resolved to a string when keys are listed.<br>
+ *        Alarms, actuator statuses and configuration are stored in wolkabout::InMemoryPersistence.<br>
+ *        Readings retrieved for publishing stay pinned until they are removed, so eviction under
+ *        wolkabout::BufferLimits never drops a reading which is in flight, and removal by count
+ *        removes exactly the readings that were sent.
+ */
+class InMemoryTypedPersistence : public TypedPersistence
+{
+public:
+    InMemoryTypedPersistence() = default;
+    ~InMemoryTypedPersistence() override = default;
+
+    bool putSensorReading(const std::string& key, std::shared_ptr<SensorReading> sensorReading) override;
+    bool putSensorReading(const std::string& key, const ReadingValue& value, unsigned long long int rtc) override;
+    bool putSensorReading(ReferenceHandle handle, const ReadingValue& value, unsigned long long int rtc) override;
+    bool putSensorReadings(const std::vector<ReadingEntry>& readings) override;
+    std::vector<std::shared_ptr<SensorReading>> getSensorReadings(const std::string& key,
+                                                                  std::uint_fast64_t count) override;
+    void removeSensorReadings(const std::string& key, std::uint_fast64_t count) override;
+    std::vector<std::string> getSensorReadingsKeys() override;
+    std::uint_fast64_t getSensorReadingsCount(const std::string& key) override;
+
+    ReferenceRegistry& getReferenceRegistry() override;
+
+    void setBufferLimiter(std::shared_ptr<BufferLimiter> bufferLimiter) override;
+
+    bool putAlarm(const std::string& key, std::shared_ptr<Alarm> alarm) override;
+    std::vector<std::shared_ptr<Alarm>> getAlarms(const std::string& key, std::uint_fast64_t count) override;
+    void removeAlarms(const std::string& key, std::uint_fast64_t count) override;
+    std::vector<std::string> getAlarmsKeys() override;
+
+    bool putActuatorStatus(const std::string& key, std::shared_ptr<ActuatorStatus> actuatorStatus) override;
+    std::shared_ptr<ActuatorStatus> getActuatorStatus(const std::string& key) override;
+    void removeActuatorStatus(const std::string& key) override;
+    std::vector<std::string> getActuatorStatusesKeys() override;
+
+    bool putConfiguration(const std::string& key,
+                          std::shared_ptr<std::vector<ConfigurationItem>> configuration) override;
+    std::shared_ptr<std::vector<ConfigurationItem>> getConfiguration(const std::string& key) override;
+    void removeConfiguration(const std::string& key) override;
+    std::vector<std::string> getConfigurationKeys() override;
+
+    bool isEmpty() override;
+
+private:
+    struct StoredReading
+    {
+        ReadingValue value;
+        unsigned long long int rtc;
+
+        // Created from value when the reading is retrieved for the first time
+        std::shared_ptr<SensorReading> reading;
+
+        // Size accounted for in wolkabout::BufferLimiter
+        std::size_t bytes;
+
+        // Insertion order across all keys
+        std::uint64_t sequence;
+    };
+
+    static std::size_t readingSize(const ReadingValue& value);
+
+    bool store(ReferenceHandle handle, StoredReading reading);
+    bool evictOldest();
+
+    std::deque<StoredReading>& readingsFor(ReferenceHandle handle);
+
+    ReferenceRegistry m_referenceRegistry;
+
+    std::mutex m_mutex;
+
+    // Indexed by handle id of the key
+    std::vector<std::deque<StoredReading>> m_readings;
+
+    // Number of readings at the front of each key which were retrieved and not yet removed, indexed as m_readings
+    std::vector<std::size_t> m_pinned;
+    std::size_t m_readingsCount = 0;
+    std::uint64_t m_nextSequence = 0;
+
+    std::shared_ptr<BufferLimiter> m_bufferLimiter;
+
+    // Guards alarms, actuator statuses and configuration, which are written and read from different lanes
+    std::mutex m_persistenceMutex;
+    InMemoryPersistence m_persistence;
+};
+}    // namespace wolkabout
+
+#endif    // INMEMORYTYPEDPERSISTENCE_H
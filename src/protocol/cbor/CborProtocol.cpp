@@ -0,0 +1,742 @@
+/*
+ * Copyright 2020 WolkAbout Technology s.r.o.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "protocol/cbor/CborProtocol.h"
+
+#include "model/ActuatorGetCommand.h"
+#include "model/ActuatorSetCommand.h"
+#include "model/ActuatorStatus.h"
+#include "model/Alarm.h"
+#include "model/ConfigurationItem.h"
+#include "model/ConfigurationSetCommand.h"
+#include "model/Message.h"
+#include "model/SensorReading.h"
+#include "protocol/cbor/CborReader.h"
+#include "protocol/cbor/CborWriter.h"
+#include "utilities/Logger.h"
+
+#include <algorithm>
+#include <cerrno>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <unordered_map>
+#include <utility>
+
+namespace wolkabout
+{
+const std::string CborProtocol::CHANNEL_DELIMITER = "/";
+const std::string CborProtocol::CHANNEL_MULTI_LEVEL_WILDCARD = "#";
+const std::string CborProtocol::CHANNEL_SINGLE_LEVEL_WILDCARD = "+";
+
+const std::string CborProtocol::DEVICE_PATH_PREFIX = "d/";
+const std::string CborProtocol::REFERENCE_PATH_PREFIX = "r/";
+
+const std::string CborProtocol::SENSOR_READING_TOPIC_ROOT = "d2p/cbor/sensor_reading/";
+const std::string CborProtocol::EVENTS_TOPIC_ROOT = "d2p/cbor/events/";
+const std::string CborProtocol::ACTUATION_STATUS_TOPIC_ROOT = "d2p/cbor/actuator_status/";
+const std::string CborProtocol::CONFIGURATION_RESPONSE_TOPIC_ROOT = "d2p/cbor/configuration_get/";
+
+const std::string CborProtocol::ACTUATION_SET_TOPIC_ROOT = "p2d/cbor/actuator_set/";
+const std::string CborProtocol::ACTUATION_GET_TOPIC_ROOT = "p2d/cbor/actuator_get/";
+const std::string CborProtocol::CONFIGURATION_SET_REQUEST_TOPIC_ROOT = "p2d/cbor/configuration_set/";
+const std::string CborProtocol::CONFIGURATION_GET_REQUEST_TOPIC_ROOT = "p2d/cbor/configuration_get/";
+
+namespace
+{
+const std::string TRUE_VALUE = "true";
+const std::string FALSE_VALUE = "false";
+
+bool startsWith(const std::string& string, const std::string& prefix)
+{
+    return string.compare(0, prefix.size(), prefix) == 0;
+}
+
+std::string formatDouble(double value)
+{
+    // Shortest representation which is parsed back to the same value
+    char buffer[32];
+    for (int precision = 1; precision <= 17; ++precision)
+    {
+        std::snprintf(buffer, sizeof(buffer), "%.*g", precision, value);
+        if (std::strtod(buffer, nullptr) == value)
+        {
+            break;
+        }
+    }
+
+    return buffer;
+}
+
+bool parseInteger(const std::string& value, std::int64_t& result)
+{
+    const std::size_t digits = !value.empty() && value[0] == '-' ? 1 : 0;
+    if (value.size() == digits || value.size() > 20 || value == "-0")
+    {
+        return false;
+    }
+
+    if (value[digits] == '0' && value.size() != digits + 1)
+    {
+        return false;
+    }
+
+    if (value.find_first_not_of("0123456789", digits) != std::string::npos)
+    {
+        return false;
+    }
+
+    errno = 0;
+    const auto parsed = std::strtoll(value.c_str(), nullptr, 10);
+    if (errno == ERANGE)
+    {
+        return false;
+    }
+
+    result = static_cast<std::int64_t>(parsed);
+    return true;
+}
+
+bool parseDecimalFraction(const std::string& value, std::int64_t& exponent, std::int64_t& mantissa)
+{
+    const std::size_t start = !value.empty() && value[0] == '-' ? 1 : 0;
+
+    const auto point = value.find('.', start);
+    if (point == std::string::npos || point == start || point + 1 == value.size() || value.size() - start > 19)
+    {
+        return false;
+    }
+
+    if (value[start] == '0' && point != start + 1)
+    {
+        return false;
+    }
+
+    std::int64_t digits = 0;
+    for (std::size_t i = start; i < value.size(); ++i)
+    {
+        if (i == point)
+        {
+            continue;
+        }
+
+        if (value[i] < '0' || value[i] > '9')
+        {
+            return false;
+        }
+
+        digits = digits * 10 + (value[i] - '0');
+    }
+
+    // Sign of zero would be lost
+    if (start == 1 && digits == 0)
+    {
+        return false;
+    }
+
+    exponent = -static_cast<std::int64_t>(value.size() - point - 1);
+    mantissa = start == 1 ? -digits : digits;
+    return true;
+}
+
+std::string formatDecimalFraction(std::int64_t exponent, std::int64_t mantissa)
+{
+    const bool negative = mantissa < 0;
+    const auto magnitude = static_cast<std::uint64_t>(mantissa);
+    auto digits = std::to_string(negative ? 0 - magnitude : magnitude);
+
+    if (exponent > 0)
+    {
+        digits.append(static_cast<std::size_t>(std::min<std::int64_t>(exponent, 308)), '0');
+    }
+    else if (exponent < 0)
+    {
+        const auto fraction = static_cast<std::size_t>(std::min<std::int64_t>(-exponent, 308));
+        if (digits.size() <= fraction)
+        {
+            digits.insert(0, fraction - digits.size() + 1, '0');
+        }
+
+        digits.insert(digits.size() - fraction, ".");
+    }
+
+    return negative ? "-" + digits : digits;
+}
+
+bool parseDecimal(const std::string& value, double& result)
+{
+    if (value.empty() || value.size() > 24 || value.find_first_not_of("0123456789.-+eE") != std::string::npos)
+    {
+        return false;
+    }
+
+    char* end = nullptr;
+    result = std::strtod(value.c_str(), &end);
+    if (end != value.c_str() + value.size())
+    {
+        return false;
+    }
+
+    return formatDouble(result) == value;
+}
+
+std::string makeChannel(const std::string& root, const std::string& deviceKey)
+{
+    return root + CborProtocol::DEVICE_PATH_PREFIX + deviceKey;
+}
+
+template <typename T, typename WriteValue>
+std::string encodeTimeSeries(const std::vector<std::shared_ptr<T>>& items, WriteValue writeValue)
+{
+    // Items of each reference, in order of first appearance
+    std::vector<std::pair<const std::string*, std::vector<const T*>>> references;
+    std::unordered_map<std::string, std::size_t> referenceIndexes;
+
+    for (const auto& item : items)
+    {
+        const auto inserted = referenceIndexes.emplace(item->getReference(), references.size());
+        if (inserted.second)
+        {
+            references.emplace_back(&item->getReference(), std::vector<const T*>{});
+        }
+
+        references[inserted.first->second].second.push_back(item.get());
+    }
+
+    std::string payload;
+    payload.reserve(items.size() * 8);
+
+    CborWriter writer{payload};
+
+    const std::uint64_t baseRtc = items.front()->getRtc();
+    writer.startArray(2);
+    writer.writeUnsigned(baseRtc);
+    writer.startMap(references.size());
+
+    for (const auto& reference : references)
+    {
+        writer.writeText(*reference.first);
+        writer.startArray(reference.second.size() * 2);
+
+        std::uint64_t previousRtc = baseRtc;
+        for (const auto* item : reference.second)
+        {
+            const std::uint64_t rtc = item->getRtc();
+            writer.writeSigned(static_cast<std::int64_t>(rtc - previousRtc));
+            writeValue(writer, *item);
+
+            previousRtc = rtc;
+        }
+    }
+
+    return payload;
+}
+
+template <typename T, typename ReadItem>
+std::vector<std::shared_ptr<T>> decodeTimeSeries(const std::string& payload, ReadItem readItem)
+{
+    CborReader reader{payload};
+
+    std::size_t size;
+    std::uint64_t baseRtc;
+    std::size_t referencesCount;
+    if (!reader.readArray(size) || size != 2 || !reader.readUnsigned(baseRtc) || !reader.readMap(referencesCount))
+    {
+        return {};
+    }
+
+    std::vector<std::shared_ptr<T>> items;
+    for (std::size_t i = 0; i < referencesCount; ++i)
+    {
+        std::string reference;
+        std::size_t fields;
+        if (!reader.readText(reference) || !reader.readArray(fields) || fields % 2 != 0)
+        {
+            return {};
+        }
+
+        std::uint64_t rtc = baseRtc;
+        for (std::size_t j = 0; j < fields / 2; ++j)
+        {
+            std::int64_t delta;
+            if (!reader.readSigned(delta))
+            {
+                return {};
+            }
+
+            rtc += static_cast<std::uint64_t>(delta);
+
+            auto item = readItem(reader, reference, rtc);
+            if (!item)
+            {
+                return {};
+            }
+
+            items.push_back(std::move(item));
+        }
+    }
+
+    return items;
+}
+}    // namespace
+
+std::vector<std::string> CborProtocol::getInboundChannels() const
+{
+    return getInboundChannelsForDevice(CHANNEL_SINGLE_LEVEL_WILDCARD);
+}
+
+std::vector<std::string> CborProtocol::getInboundChannelsForDevice(const std::string& deviceKey) const
+{
+    return {makeChannel(ACTUATION_SET_TOPIC_ROOT, deviceKey) + CHANNEL_DELIMITER + REFERENCE_PATH_PREFIX +
+              CHANNEL_MULTI_LEVEL_WILDCARD,
+            makeChannel(ACTUATION_GET_TOPIC_ROOT, deviceKey) + CHANNEL_DELIMITER + REFERENCE_PATH_PREFIX +
+              CHANNEL_MULTI_LEVEL_WILDCARD,
+            makeChannel(CONFIGURATION_SET_REQUEST_TOPIC_ROOT, deviceKey),
+            makeChannel(CONFIGURATION_GET_REQUEST_TOPIC_ROOT, deviceKey)};
+}
+
+std::string CborProtocol::extractDeviceKeyFromChannel(const std::string& topic) const
+{
+    const auto devicePath = CHANNEL_DELIMITER + DEVICE_PATH_PREFIX;
+
+    const auto start = topic.find(devicePath);
+    if (start == std::string::npos)
+    {
+        return "";
+    }
+
+    const auto keyStart = start + devicePath.size();
+    const auto keyEnd = topic.find(CHANNEL_DELIMITER, keyStart);
+
+    return topic.substr(keyStart, keyEnd == std::string::npos ? std::string::npos : keyEnd - keyStart);
+}
+
+std::string CborProtocol::extractReferenceFromChannel(const std::string& topic) const
+{
+    const auto referencePath = CHANNEL_DELIMITER + REFERENCE_PATH_PREFIX;
+
+    const auto start = topic.find(referencePath);
+    if (start == std::string::npos)
+    {
+        return "";
+    }
+
+    return topic.substr(start + referencePath.size());
+}
+
+bool CborProtocol::isActuatorSetMessage(const Message& message) const
+{
+    return startsWith(message.getChannel(), ACTUATION_SET_TOPIC_ROOT);
+}
+
+bool CborProtocol::isActuatorGetMessage(const Message& message) const
+{
+    return startsWith(message.getChannel(), ACTUATION_GET_TOPIC_ROOT);
+}
+
+bool CborProtocol::isConfigurationSetMessage(const Message& message) const
+{
+    return startsWith(message.getChannel(), CONFIGURATION_SET_REQUEST_TOPIC_ROOT);
+}
+
+bool CborProtocol::isConfigurationGetMessage(const Message& message) const
+{
+    return startsWith(message.getChannel(), CONFIGURATION_GET_REQUEST_TOPIC_ROOT);
+}
+
+std::unique_ptr<ActuatorGetCommand> CborProtocol::makeActuatorGetCommand(const Message& message) const
+{
+    const auto reference = extractReferenceFromChannel(message.getChannel());
+    if (reference.empty())
+    {
+        return nullptr;
+    }
+
+    return std::unique_ptr<ActuatorGetCommand>(new ActuatorGetCommand(reference));
+}
+
+std::unique_ptr<ActuatorSetCommand> CborProtocol::makeActuatorSetCommand(const Message& message) const
+{
+    const auto reference = extractReferenceFromChannel(message.getChannel());
+    if (reference.empty())
+    {
+        return nullptr;
+    }
+
+    CborReader reader{message.getContent()};
+
+    std::string value;
+    if (!readValue(reader, value) || !reader.atEnd())
+    {
+        LOG(WARN) << "Unable to parse actuator set command: " << message.getChannel();
+        return nullptr;
+    }
+
+    return std::unique_ptr<ActuatorSetCommand>(new ActuatorSetCommand(reference, value));
+}
+
+std::unique_ptr<ConfigurationSetCommand> CborProtocol::makeConfigurationSetCommand(const Message& message) const
+{
+    auto configuration = parseConfiguration(message);
+    if (configuration.empty() && !message.getContent().empty())
+    {
+        CborReader reader{message.getContent()};
+
+        std::size_t size;
+        if (!reader.readMap(size) || size != 0)
+        {
+            LOG(WARN) << "Unable to parse configuration set command: " << message.getChannel();
+            return nullptr;
+        }
+    }
+
+    return std::unique_ptr<ConfigurationSetCommand>(new ConfigurationSetCommand(std::move(configuration)));
+}
+
+std::unique_ptr<Message> CborProtocol::makeMessage(
+  const std::string& deviceKey, const std::vector<std::shared_ptr<SensorReading>>& sensorReadings) const
+{
+    if (sensorReadings.empty())
+    {
+        return nullptr;
+    }
+
+    auto payload = encodeTimeSeries(sensorReadings, [](CborWriter& writer, const SensorReading& sensorReading) {
+        const auto& values = sensorReading.getValues();
+        if (values.size() == 1)
+        {
+            writeValue(writer, values.front());
+        }
+        else
+        {
+            writeValues(writer, values);
+        }
+    });
+
+    return std::unique_ptr<Message>(new Message(std::move(payload), makeChannel(SENSOR_READING_TOPIC_ROOT, deviceKey)));
+}
+
+std::unique_ptr<Message> CborProtocol::makeMessage(const std::string& deviceKey,
+                                                   const std::vector<std::shared_ptr<Alarm>>& alarms) const
+{
+    if (alarms.empty())
+    {
+        return nullptr;
+    }
+
+    auto payload = encodeTimeSeries(
+      alarms, [](CborWriter& writer, const Alarm& alarm) { writer.writeBool(static_cast<bool>(alarm.getValue())); });
+
+    return std::unique_ptr<Message>(new Message(std::move(payload), makeChannel(EVENTS_TOPIC_ROOT, deviceKey)));
+}
+
+std::unique_ptr<Message> CborProtocol::makeMessage(
+  const std::string& deviceKey, const std::vector<std::shared_ptr<ActuatorStatus>>& actuatorStatuses) const
+{
+    if (actuatorStatuses.empty())
+    {
+        return nullptr;
+    }
+
+    std::string payload;
+    CborWriter writer{payload};
+
+    writer.startMap(actuatorStatuses.size());
+    for (const auto& actuatorStatus : actuatorStatuses)
+    {
+        writer.writeText(actuatorStatus->getReference());
+        writer.startArray(2);
+        writeValue(writer, actuatorStatus->getValue());
+        writer.writeUnsigned(static_cast<std::uint64_t>(actuatorStatus->getState()));
+    }
+
+    return std::unique_ptr<Message>(
+      new Message(std::move(payload), makeChannel(ACTUATION_STATUS_TOPIC_ROOT, deviceKey)));
+}
+
+std::unique_ptr<Message> CborProtocol::makeMessage(const std::string& deviceKey,
+                                                   const std::vector<ConfigurationItem>& configuration) const
+{
+    std::string payload;
+    CborWriter writer{payload};
+
+    writer.startMap(configuration.size());
+    for (const auto& item : configuration)
+    {
+        writer.writeText(item.getReference());
+
+        const auto& values = item.getValues();
+        if (values.size() == 1)
+        {
+            writeValue(writer, values.front());
+        }
+        else
+        {
+            writeValues(writer, values);
+        }
+    }
+
+    return std::unique_ptr<Message>(
+      new Message(std::move(payload), makeChannel(CONFIGURATION_RESPONSE_TOPIC_ROOT, deviceKey)));
+}
+
+std::vector<std::shared_ptr<SensorReading>> CborProtocol::parseSensorReadings(const Message& message) const
+{
+    return decodeTimeSeries<SensorReading>(
+      message.getContent(),
+      [](CborReader& reader, const std::string& reference, std::uint64_t rtc) -> std::shared_ptr<SensorReading> {
+          if (reader.peek() == CborReader::Type::ARRAY)
+          {
+              std::vector<std::string> values;
+              if (!readValues(reader, values))
+              {
+                  return nullptr;
+              }
+
+              return std::make_shared<SensorReading>(values, reference, rtc);
+          }
+
+          std::string value;
+          if (!readValue(reader, value))
+          {
+              return nullptr;
+          }
+
+          return std::make_shared<SensorReading>(value, reference, rtc);
+      });
+}
+
+std::vector<std::shared_ptr<Alarm>> CborProtocol::parseAlarms(const Message& message) const
+{
+    return decodeTimeSeries<Alarm>(
+      message.getContent(),
+      [](CborReader& reader, const std::string& reference, std::uint64_t rtc) -> std::shared_ptr<Alarm> {
+          bool active;
+          if (!reader.readBool(active))
+          {
+              return nullptr;
+          }
+
+          return std::make_shared<Alarm>(active, reference, rtc);
+      });
+}
+
+std::vector<std::shared_ptr<ActuatorStatus>> CborProtocol::parseActuatorStatuses(const Message& message) const
+{
+    CborReader reader{message.getContent()};
+
+    std::size_t size;
+    if (!reader.readMap(size))
+    {
+        return {};
+    }
+
+    std::vector<std::shared_ptr<ActuatorStatus>> actuatorStatuses;
+    for (std::size_t i = 0; i < size; ++i)
+    {
+        std::string reference;
+        std::size_t fields;
+        std::string value;
+        std::uint64_t state;
+        if (!reader.readText(reference) || !reader.readArray(fields) || fields != 2 || !readValue(reader, value) ||
+            !reader.readUnsigned(state) || state > static_cast<std::uint64_t>(ActuatorStatus::State::ERROR))
+        {
+            return {};
+        }
+
+        actuatorStatuses.push_back(
+          std::make_shared<ActuatorStatus>(value, reference, static_cast<ActuatorStatus::State>(state)));
+    }
+
+    return actuatorStatuses;
+}
+
+std::vector<ConfigurationItem> CborProtocol::parseConfiguration(const Message& message) const
+{
+    CborReader reader{message.getContent()};
+
+    std::size_t size;
+    if (!reader.readMap(size))
+    {
+        return {};
+    }
+
+    std::vector<ConfigurationItem> configuration;
+    for (std::size_t i = 0; i < size; ++i)
+    {
+        std::string reference;
+        if (!reader.readText(reference))
+        {
+            return {};
+        }
+
+        std::vector<std::string> values;
+        if (reader.peek() == CborReader::Type::ARRAY)
+        {
+            if (!readValues(reader, values))
+            {
+                return {};
+            }
+        }
+        else
+        {
+            std::string value;
+            if (!readValue(reader, value))
+            {
+                return {};
+            }
+
+            values.push_back(std::move(value));
+        }
+
+        configuration.emplace_back(std::move(values), std::move(reference));
+    }
+
+    return configuration;
+}
+
+void CborProtocol::writeValue(CborWriter& writer, const std::string& value)
+{
+    if (value == TRUE_VALUE || value == FALSE_VALUE)
+    {
+        writer.writeBool(value == TRUE_VALUE);
+        return;
+    }
+
+    std::int64_t integer;
+    if (parseInteger(value, integer))
+    {
+        writer.writeSigned(integer);
+        return;
+    }
+
+    std::int64_t exponent;
+    std::int64_t mantissa;
+    if (parseDecimalFraction(value, exponent, mantissa))
+    {
+        writer.writeDecimalFraction(exponent, mantissa);
+        return;
+    }
+
+    double decimal;
+    if (parseDecimal(value, decimal))
+    {
+        writer.writeDouble(decimal);
+        return;
+    }
+
+    writer.writeText(value);
+}
+
+void CborProtocol::writeValues(CborWriter& writer, const std::vector<std::string>& values)
+{
+    writer.startArray(values.size());
+    for (const auto& value : values)
+    {
+        writeValue(writer, value);
+    }
+}
+
+bool CborProtocol::readValue(CborReader& reader, std::string& value)
+{
+    switch (reader.peek())
+    {
+    case CborReader::Type::TEXT:
+        return reader.readText(value);
+    case CborReader::Type::UNSIGNED:
+    {
+        std::uint64_t integer;
+        if (!reader.readUnsigned(integer))
+        {
+            return false;
+        }
+
+        value = std::to_string(integer);
+        return true;
+    }
+    case CborReader::Type::NEGATIVE:
+    {
+        std::int64_t integer;
+        if (!reader.readSigned(integer))
+        {
+            return false;
+        }
+
+        value = std::to_string(integer);
+        return true;
+    }
+    case CborReader::Type::BOOL:
+    {
+        bool boolean;
+        if (!reader.readBool(boolean))
+        {
+            return false;
+        }
+
+        value = boolean ? TRUE_VALUE : FALSE_VALUE;
+        return true;
+    }
+    case CborReader::Type::FLOAT:
+    {
+        double decimal;
+        if (!reader.readDouble(decimal))
+        {
+            return false;
+        }
+
+        value = formatDouble(decimal);
+        return true;
+    }
+    case CborReader::Type::DECIMAL_FRACTION:
+    {
+        std::int64_t exponent;
+        std::int64_t mantissa;
+        if (!reader.readDecimalFraction(exponent, mantissa))
+        {
+            return false;
+        }
+
+        value = formatDecimalFraction(exponent, mantissa);
+        return true;
+    }
+    default:
+        return false;
+    }
+}
+
+bool CborProtocol::readValues(CborReader& reader, std::vector<std::string>& values)
+{
+    std::size_t size;
+    if (!reader.readArray(size))
+    {
+        return false;
+    }
+
+    values.clear();
+    for (std::size_t i = 0; i < size; ++i)
+    {
+        std::string value;
+        if (!readValue(reader, value))
+        {
+            return false;
+        }
+
+        values.push_back(std::move(value));
+    }
+
+    return true;
+}
+}    // namespace wolkabout
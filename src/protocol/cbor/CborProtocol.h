@@ -0,0 +1,119 @@
+/*
+ * Copyright 2020 WolkAbout Technology s.r.o.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef CBORPROTOCOL_H
+#define CBORPROTOCOL_H
+
+#include "protocol/DataProtocol.h"
+
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace wolkabout
+{
+class CborReader;
+class CborWriter;
+
+/**
+ * @brief Data protocol which encodes payloads in CBOR, with references written once per message and
+ *        timestamps encoded as difference from the previous one.<br>
+ *        Values which are integers, decimal numbers or booleans are encoded as CBOR integers, decimal fractions,
+ *        floats and booleans only when decoding them yields the exact same string, otherwise they are sent as text.
+ *
+ *        Sensor readings, and alarms, are encoded as [base rtc, {reference: [rtc delta, value, ...]}],
+ *        where each delta is relative to the previous item of the reference, and the first one to base rtc.<br>
+ *        Multi-value readings are encoded as an array of values.<br>
+ *        Actuator statuses are encoded as {reference: [value, state]}, and configuration as
+ *        {reference: value or array of values}.
+ *
+ *        Experimental: messages are published and subscribed to on d2p/cbor/... and p2d/cbor/... channels,
+ *        separate from the JSON channel layout, since the payload format is not negotiated with the platform.
+ *        Platform has to be set up to route these channels before this protocol is used in production.
+ */
+class CborProtocol : public DataProtocol
+{
+public:
+    std::vector<std::string> getInboundChannels() const override;
+    std::vector<std::string> getInboundChannelsForDevice(const std::string& deviceKey) const override;
+    std::string extractDeviceKeyFromChannel(const std::string& topic) const override;
+
+    std::string extractReferenceFromChannel(const std::string& topic) const override;
+
+    bool isActuatorSetMessage(const Message& message) const override;
+    bool isActuatorGetMessage(const Message& message) const override;
+
+    bool isConfigurationSetMessage(const Message& message) const override;
+    bool isConfigurationGetMessage(const Message& message) const override;
+
+    std::unique_ptr<ActuatorGetCommand> makeActuatorGetCommand(const Message& message) const override;
+    std::unique_ptr<ActuatorSetCommand> makeActuatorSetCommand(const Message& message) const override;
+
+    std::unique_ptr<ConfigurationSetCommand> makeConfigurationSetCommand(const Message& message) const override;
+
+    std::unique_ptr<Message> makeMessage(
+      const std::string& deviceKey,
+      const std::vector<std::shared_ptr<SensorReading>>& sensorReadings) const override;
+
+    std::unique_ptr<Message> makeMessage(const std::string& deviceKey,
+                                         const std::vector<std::shared_ptr<Alarm>>& alarms) const override;
+
+    std::unique_ptr<Message> makeMessage(
+      const std::string& deviceKey,
+      const std::vector<std::shared_ptr<ActuatorStatus>>& actuatorStatuses) const override;
+
+    std::unique_ptr<Message> makeMessage(const std::string& deviceKey,
+                                         const std::vector<ConfigurationItem>& configuration) const override;
+
+    /**
+     * @brief Decodes sensor readings from message made by this protocol
+     * @return Sensor readings, grouped by reference, or empty vector if payload is malformed
+     */
+    std::vector<std::shared_ptr<SensorReading>> parseSensorReadings(const Message& message) const;
+
+    std::vector<std::shared_ptr<Alarm>> parseAlarms(const Message& message) const;
+
+    std::vector<std::shared_ptr<ActuatorStatus>> parseActuatorStatuses(const Message& message) const;
+
+    std::vector<ConfigurationItem> parseConfiguration(const Message& message) const;
+
+    static const std::string CHANNEL_DELIMITER;
+    static const std::string CHANNEL_MULTI_LEVEL_WILDCARD;
+    static const std::string CHANNEL_SINGLE_LEVEL_WILDCARD;
+
+    static const std::string DEVICE_PATH_PREFIX;
+    static const std::string REFERENCE_PATH_PREFIX;
+
+    static const std::string SENSOR_READING_TOPIC_ROOT;
+    static const std::string EVENTS_TOPIC_ROOT;
+    static const std::string ACTUATION_STATUS_TOPIC_ROOT;
+    static const std::string CONFIGURATION_RESPONSE_TOPIC_ROOT;
+
+    static const std::string ACTUATION_SET_TOPIC_ROOT;
+    static const std::string ACTUATION_GET_TOPIC_ROOT;
+    static const std::string CONFIGURATION_SET_REQUEST_TOPIC_ROOT;
+    static const std::string CONFIGURATION_GET_REQUEST_TOPIC_ROOT;
+
+private:
+    static void writeValue(CborWriter& writer, const std::string& value);
+    static void writeValues(CborWriter& writer, const std::vector<std::string>& values);
+
+    static bool readValue(CborReader& reader, std::string& value);
+    static bool readValues(CborReader& reader, std::vector<std::string>& values);
+};
+}    // namespace wolkabout
+
+#endif    // CBORPROTOCOL_H
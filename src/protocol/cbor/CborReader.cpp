@@ -0,0 +1,322 @@
+/*
+ * Copyright 2020 WolkAbout Technology s.r.o.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+
+#include "protocol/cbor/CborReader.h"
+
+#include <cstring>
+#include <limits>
+
+namespace wolkabout
+{
+namespace
+{
+const std::uint8_t MAJOR_UNSIGNED = 0;
+const std::uint8_t MAJOR_NEGATIVE = 1;
+const std::uint8_t MAJOR_BYTES = 2;
+const std::uint8_t MAJOR_TEXT = 3;
+const std::uint8_t MAJOR_ARRAY = 4;
+const std::uint8_t MAJOR_MAP = 5;
+const std::uint8_t MAJOR_TAG = 6;
+const std::uint8_t MAJOR_SIMPLE = 7;
+
+const std::uint8_t FALSE_ITEM = 0xf4;
+const std::uint8_t TRUE_ITEM = 0xf5;
+const std::uint8_t NULL_ITEM = 0xf6;
+const std::uint8_t HALF_ITEM = 0xf9;
+const std::uint8_t FLOAT_ITEM = 0xfa;
+const std::uint8_t DOUBLE_ITEM = 0xfb;
+
+const std::uint8_t DECIMAL_FRACTION_ITEM = 0xc4;
+
+double halfToDouble(std::uint16_t half)
+{
+    const int exponent = (half >> 10) & 0x1f;
+    const int mantissa = half & 0x3ff;
+
+    double value;
+    if (exponent == 0)
+    {
+        value = mantissa * (1.0 / (1 << 24));
+    }
+    else if (exponent != 31)
+    {
+        value = (mantissa + 1024) * (exponent >= 25 ? static_cast<double>(1 << (exponent - 25)) :
+                                                      1.0 / static_cast<double>(1 << (25 - exponent)));
+    }
+    else
+    {
+        value = mantissa == 0 ? std::numeric_limits<double>::infinity() : std::numeric_limits<double>::quiet_NaN();
+    }
+
+    return (half & 0x8000) ? -value : value;
+}
+}    // namespace
+
+CborReader::CborReader(const std::string& data) : m_data{data}, m_position{0} {}
+
+CborReader::Type CborReader::peek() const
+{
+    if (atEnd())
+    {
+        return Type::INVALID;
+    }
+
+    const auto initial = static_cast<std::uint8_t>(m_data[m_position]);
+    switch (initial >> 5)
+    {
+    case MAJOR_UNSIGNED:
+        return Type::UNSIGNED;
+    case MAJOR_NEGATIVE:
+        return Type::NEGATIVE;
+    case MAJOR_BYTES:
+        return Type::BYTES;
+    case MAJOR_TEXT:
+        return Type::TEXT;
+    case MAJOR_ARRAY:
+        return Type::ARRAY;
+    case MAJOR_MAP:
+        return Type::MAP;
+    case MAJOR_TAG:
+        return initial == DECIMAL_FRACTION_ITEM ? Type::DECIMAL_FRACTION : Type::INVALID;
+    case MAJOR_SIMPLE:
+        switch (initial)
+        {
+        case FALSE_ITEM:
+        case TRUE_ITEM:
+            return Type::BOOL;
+        case NULL_ITEM:
+            return Type::NULL_VALUE;
+        case HALF_ITEM:
+        case FLOAT_ITEM:
+        case DOUBLE_ITEM:
+            return Type::FLOAT;
+        default:
+            return Type::INVALID;
+        }
+    default:
+        return Type::INVALID;
+    }
+}
+
+bool CborReader::atEnd() const
+{
+    return m_position >= m_data.size();
+}
+
+bool CborReader::readUnsigned(std::uint64_t& value)
+{
+    return readHead(MAJOR_UNSIGNED, value);
+}
+
+bool CborReader::readSigned(std::int64_t& value)
+{
+    const auto position = m_position;
+
+    std::uint64_t raw;
+    if (readHead(MAJOR_UNSIGNED, raw))
+    {
+        if (raw <= static_cast<std::uint64_t>(std::numeric_limits<std::int64_t>::max()))
+        {
+            value = static_cast<std::int64_t>(raw);
+            return true;
+        }
+    }
+    else if (readHead(MAJOR_NEGATIVE, raw))
+    {
+        if (raw <= static_cast<std::uint64_t>(std::numeric_limits<std::int64_t>::max()))
+        {
+            value = -1 - static_cast<std::int64_t>(raw);
+            return true;
+        }
+    }
+
+    m_position = position;
+    return false;
+}
+
+bool CborReader::readBool(bool& value)
+{
+    if (peek() != Type::BOOL)
+    {
+        return false;
+    }
+
+    value = static_cast<std::uint8_t>(m_data[m_position++]) == TRUE_ITEM;
+    return true;
+}
+
+bool CborReader::readNull()
+{
+    if (peek() != Type::NULL_VALUE)
+    {
+        return false;
+    }
+
+    ++m_position;
+    return true;
+}
+
+bool CborReader::readDouble(double& value)
+{
+    if (peek() != Type::FLOAT)
+    {
+        return false;
+    }
+
+    const auto initial = static_cast<std::uint8_t>(m_data[m_position]);
+    const std::size_t bytes = initial == HALF_ITEM ? 2 : initial == FLOAT_ITEM ? 4 : 8;
+
+    std::uint64_t bits;
+    if (!readBigEndian(m_position + 1, bytes, bits))
+    {
+        return false;
+    }
+
+    if (bytes == 2)
+    {
+        value = halfToDouble(static_cast<std::uint16_t>(bits));
+    }
+    else if (bytes == 4)
+    {
+        const auto single = static_cast<std::uint32_t>(bits);
+        float result;
+        std::memcpy(&result, &single, sizeof(result));
+        value = result;
+    }
+    else
+    {
+        std::memcpy(&value, &bits, sizeof(value));
+    }
+
+    m_position += 1 + bytes;
+    return true;
+}
+
+bool CborReader::readDecimalFraction(std::int64_t& exponent, std::int64_t& mantissa)
+{
+    const auto position = m_position;
+
+    std::uint64_t tag;
+    std::size_t size;
+    if (!readHead(MAJOR_TAG, tag) || tag != 4 || !readArray(size) || size != 2 || !readSigned(exponent) ||
+        !readSigned(mantissa))
+    {
+        m_position = position;
+        return false;
+    }
+
+    return true;
+}
+
+bool CborReader::readText(std::string& value)
+{
+    const auto position = m_position;
+
+    std::uint64_t size;
+    if (!readHead(MAJOR_TEXT, size))
+    {
+        return false;
+    }
+
+    if (size > m_data.size() - m_position)
+    {
+        m_position = position;
+        return false;
+    }
+
+    value.assign(m_data, m_position, static_cast<std::size_t>(size));
+    m_position += static_cast<std::size_t>(size);
+    return true;
+}
+
+bool CborReader::readArray(std::size_t& size)
+{
+    std::uint64_t value;
+    if (!readHead(MAJOR_ARRAY, value))
+    {
+        return false;
+    }
+
+    size = static_cast<std::size_t>(value);
+    return true;
+}
+
+bool CborReader::readMap(std::size_t& size)
+{
+    std::uint64_t value;
+    if (!readHead(MAJOR_MAP, value))
+    {
+        return false;
+    }
+
+    size = static_cast<std::size_t>(value);
+    return true;
+}
+
+bool CborReader::readHead(std::uint8_t majorType, std::uint64_t& value)
+{
+    if (atEnd())
+    {
+        return false;
+    }
+
+    const auto initial = static_cast<std::uint8_t>(m_data[m_position]);
+    if ((initial >> 5) != majorType)
+    {
+        return false;
+    }
+
+    const std::uint8_t additional = initial & 0x1f;
+    if (additional < 24)
+    {
+        value = additional;
+        m_position += 1;
+        return true;
+    }
+
+    if (additional > 27)
+    {
+        // Indefinite lengths, and reserved values, are not written by CborWriter
+        return false;
+    }
+
+    const std::size_t bytes = std::size_t{1} << (additional - 24);
+    if (!readBigEndian(m_position + 1, bytes, value))
+    {
+        return false;
+    }
+
+    m_position += 1 + bytes;
+    return true;
+}
+
+bool CborReader::readBigEndian(std::size_t position, std::size_t bytes, std::uint64_t& value) const
+{
+    if (position > m_data.size() || bytes > m_data.size() - position)
+    {
+        return false;
+    }
+
+    value = 0;
+    for (std::size_t i = 0; i < bytes; ++i)
+    {
+        value = (value << 8) | static_cast<std::uint8_t>(m_data[position + i]);
+    }
+
+    return true;
+}
+}    // namespace wolkabout
@@ -0,0 +1,80 @@
+/*
+ * Copyright 2020 WolkAbout Technology s.r.o.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+
+#ifndef CBORREADER_H
+#define CBORREADER_H
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+namespace wolkabout
+{
+/**
+ * @brief Reads CBOR (RFC 7049) encoded items written by wolkabout::CborWriter.<br>
+ *        Each read returns false, and leaves position unchanged, if the next item is not of requested type,
+ *        or is truncated.
+ */
+class CborReader
+{
+public:
+    enum class Type
+    {
+        UNSIGNED,
+        NEGATIVE,
+        BYTES,
+        TEXT,
+        ARRAY,
+        MAP,
+        BOOL,
+        NULL_VALUE,
+        FLOAT,
+        DECIMAL_FRACTION,
+        INVALID
+    };
+
+    explicit CborReader(const std::string& data);
+
+    Type peek() const;
+    bool atEnd() const;
+
+    bool readUnsigned(std::uint64_t& value);
+
+    /**
+     * @brief Reads unsigned, or negative, integer which fits std::int64_t
+     */
+    bool readSigned(std::int64_t& value);
+
+    bool readBool(bool& value);
+    bool readNull();
+    bool readDouble(double& value);
+    bool readDecimalFraction(std::int64_t& exponent, std::int64_t& mantissa);
+    bool readText(std::string& value);
+
+    bool readArray(std::size_t& size);
+    bool readMap(std::size_t& size);
+
+private:
+    bool readHead(std::uint8_t majorType, std::uint64_t& value);
+    bool readBigEndian(std::size_t position, std::size_t bytes, std::uint64_t& value) const;
+
+    const std::string& m_data;
+    std::size_t m_position;
+};
+}    // namespace wolkabout
+
+#endif    // CBORREADER_H
@@ -0,0 +1,153 @@
+/*
+ * Copyright 2020 WolkAbout Technology s.r.o.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+
+#include "protocol/cbor/CborWriter.h"
+
+#include <cstring>
+
+namespace wolkabout
+{
+namespace
+{
+const std::uint8_t MAJOR_UNSIGNED = 0;
+const std::uint8_t MAJOR_NEGATIVE = 1;
+const std::uint8_t MAJOR_TEXT = 3;
+const std::uint8_t MAJOR_ARRAY = 4;
+const std::uint8_t MAJOR_MAP = 5;
+const std::uint8_t MAJOR_TAG = 6;
+
+const std::uint64_t DECIMAL_FRACTION_TAG = 4;
+
+const char FALSE_ITEM = static_cast<char>(0xf4);
+const char TRUE_ITEM = static_cast<char>(0xf5);
+const char NULL_ITEM = static_cast<char>(0xf6);
+const char FLOAT_ITEM = static_cast<char>(0xfa);
+const char DOUBLE_ITEM = static_cast<char>(0xfb);
+}    // namespace
+
+CborWriter::CborWriter(std::string& buffer) : m_buffer{buffer} {}
+
+void CborWriter::writeUnsigned(std::uint64_t value)
+{
+    writeHead(MAJOR_UNSIGNED, value);
+}
+
+void CborWriter::writeSigned(std::int64_t value)
+{
+    if (value >= 0)
+    {
+        writeHead(MAJOR_UNSIGNED, static_cast<std::uint64_t>(value));
+    }
+    else
+    {
+        // -1 - n, computed without overflowing for the minimal value
+        writeHead(MAJOR_NEGATIVE, ~static_cast<std::uint64_t>(value));
+    }
+}
+
+void CborWriter::writeBool(bool value)
+{
+    m_buffer.push_back(value ? TRUE_ITEM : FALSE_ITEM);
+}
+
+void CborWriter::writeNull()
+{
+    m_buffer.push_back(NULL_ITEM);
+}
+
+void CborWriter::writeDouble(double value)
+{
+    const auto single = static_cast<float>(value);
+    if (static_cast<double>(single) == value || value != value)
+    {
+        std::uint32_t bits;
+        std::memcpy(&bits, &single, sizeof(bits));
+
+        m_buffer.push_back(FLOAT_ITEM);
+        writeBigEndian(bits, sizeof(bits));
+        return;
+    }
+
+    std::uint64_t bits;
+    std::memcpy(&bits, &value, sizeof(bits));
+
+    m_buffer.push_back(DOUBLE_ITEM);
+    writeBigEndian(bits, sizeof(bits));
+}
+
+void CborWriter::writeDecimalFraction(std::int64_t exponent, std::int64_t mantissa)
+{
+    writeHead(MAJOR_TAG, DECIMAL_FRACTION_TAG);
+    startArray(2);
+    writeSigned(exponent);
+    writeSigned(mantissa);
+}
+
+void CborWriter::writeText(const std::string& value)
+{
+    writeHead(MAJOR_TEXT, value.size());
+    m_buffer.append(value);
+}
+
+void CborWriter::startArray(std::size_t size)
+{
+    writeHead(MAJOR_ARRAY, size);
+}
+
+void CborWriter::startMap(std::size_t size)
+{
+    writeHead(MAJOR_MAP, size);
+}
+
+void CborWriter::writeHead(std::uint8_t majorType, std::uint64_t value)
+{
+    const auto major = static_cast<std::uint8_t>(majorType << 5);
+
+    if (value < 24)
+    {
+        m_buffer.push_back(static_cast<char>(major | value));
+    }
+    else if (value <= 0xff)
+    {
+        m_buffer.push_back(static_cast<char>(major | 24));
+        writeBigEndian(value, 1);
+    }
+    else if (value <= 0xffff)
+    {
+        m_buffer.push_back(static_cast<char>(major | 25));
+        writeBigEndian(value, 2);
+    }
+    else if (value <= 0xffffffff)
+    {
+        m_buffer.push_back(static_cast<char>(major | 26));
+        writeBigEndian(value, 4);
+    }
+    else
+    {
+        m_buffer.push_back(static_cast<char>(major | 27));
+        writeBigEndian(value, 8);
+    }
+}
+
+void CborWriter::writeBigEndian(std::uint64_t value, std::size_t bytes)
+{
+    for (std::size_t i = bytes; i > 0; --i)
+    {
+        m_buffer.push_back(static_cast<char>((value >> ((i - 1) * 8)) & 0xff));
+    }
+}
+}    // namespace wolkabout
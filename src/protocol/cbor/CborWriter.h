@@ -0,0 +1,64 @@
+/*
+ * Copyright 2020 WolkAbout Technology s.r.o.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+
+#ifndef CBORWRITER_H
+#define CBORWRITER_H
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+namespace wolkabout
+{
+/**
+ * @brief Appends CBOR (RFC 7049) encoded items to a buffer.<br>
+ *        Only definite length items are written.
+ */
+class CborWriter
+{
+public:
+    explicit CborWriter(std::string& buffer);
+
+    void writeUnsigned(std::uint64_t value);
+    void writeSigned(std::int64_t value);
+    void writeBool(bool value);
+    void writeNull();
+
+    /**
+     * @brief Writes value as single precision float when it is represented exactly, otherwise as double
+     */
+    void writeDouble(double value);
+
+    /**
+     * @brief Writes decimal fraction (tag 4), whose value is mantissa * 10^exponent
+     */
+    void writeDecimalFraction(std::int64_t exponent, std::int64_t mantissa);
+
+    void writeText(const std::string& value);
+
+    void startArray(std::size_t size);
+    void startMap(std::size_t size);
+
+private:
+    void writeHead(std::uint8_t majorType, std::uint64_t value);
+    void writeBigEndian(std::uint64_t value, std::size_t bytes);
+
+    std::string& m_buffer;
+};
+}    // namespace wolkabout
+
+#endif    // CBORWRITER_H
@@ -0,0 +1,141 @@
+/*
+ * Copyright 2020 WolkAbout Technology s.r.o.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "protocol/gzip/GzipDataProtocol.h"
+
+#include "model/ActuatorGetCommand.h"
+#include "model/ActuatorSetCommand.h"
+#include "model/ConfigurationSetCommand.h"
+#include "model/Message.h"
+#include "utilities/Logger.h"
+
+#include <utility>
+
+namespace wolkabout
+{
+const constexpr std::size_t GzipDataProtocol::DEFAULT_THRESHOLD;
+
+GzipDataProtocol::GzipDataProtocol(std::unique_ptr<DataProtocol> protocol, std::size_t threshold, int level)
+: m_protocol{std::move(protocol)}, m_threshold{threshold}, m_level{level}
+{
+}
+
+std::vector<std::string> GzipDataProtocol::getInboundChannels() const
+{
+    return m_protocol->getInboundChannels();
+}
+
+std::vector<std::string> GzipDataProtocol::getInboundChannelsForDevice(const std::string& deviceKey) const
+{
+    return m_protocol->getInboundChannelsForDevice(deviceKey);
+}
+
+std::string GzipDataProtocol::extractDeviceKeyFromChannel(const std::string& topic) const
+{
+    return m_protocol->extractDeviceKeyFromChannel(topic);
+}
+
+std::string GzipDataProtocol::extractReferenceFromChannel(const std::string& topic) const
+{
+    return m_protocol->extractReferenceFromChannel(topic);
+}
+
+bool GzipDataProtocol::isActuatorSetMessage(const Message& message) const
+{
+    return m_protocol->isActuatorSetMessage(message);
+}
+
+bool GzipDataProtocol::isActuatorGetMessage(const Message& message) const
+{
+    return m_protocol->isActuatorGetMessage(message);
+}
+
+bool GzipDataProtocol::isConfigurationSetMessage(const Message& message) const
+{
+    return m_protocol->isConfigurationSetMessage(message);
+}
+
+bool GzipDataProtocol::isConfigurationGetMessage(const Message& message) const
+{
+    return m_protocol->isConfigurationGetMessage(message);
+}
+
+std::unique_ptr<ActuatorGetCommand> GzipDataProtocol::makeActuatorGetCommand(const Message& message) const
+{
+    return m_protocol->makeActuatorGetCommand(message);
+}
+
+std::unique_ptr<ActuatorSetCommand> GzipDataProtocol::makeActuatorSetCommand(const Message& message) const
+{
+    return m_protocol->makeActuatorSetCommand(message);
+}
+
+std::unique_ptr<ConfigurationSetCommand> GzipDataProtocol::makeConfigurationSetCommand(const Message& message) const
+{
+    return m_protocol->makeConfigurationSetCommand(message);
+}
+
+std::unique_ptr<Message> GzipDataProtocol::makeMessage(
+  const std::string& deviceKey, const std::vector<std::shared_ptr<SensorReading>>& sensorReadings) const
+{
+    return compress(m_protocol->makeMessage(deviceKey, sensorReadings));
+}
+
+std::unique_ptr<Message> GzipDataProtocol::makeMessage(const std::string& deviceKey,
+                                                       const std::vector<std::shared_ptr<Alarm>>& alarms) const
+{
+    return compress(m_protocol->makeMessage(deviceKey, alarms));
+}
+
+std::unique_ptr<Message> GzipDataProtocol::makeMessage(
+  const std::string& deviceKey, const std::vector<std::shared_ptr<ActuatorStatus>>& actuatorStatuses) const
+{
+    return compress(m_protocol->makeMessage(deviceKey, actuatorStatuses));
+}
+
+std::unique_ptr<Message> GzipDataProtocol::makeMessage(const std::string& deviceKey,
+                                                       const std::vector<ConfigurationItem>& configuration) const
+{
+    return compress(m_protocol->makeMessage(deviceKey, configuration));
+}
+
+const DataProtocol& GzipDataProtocol::getProtocol() const
+{
+    return *m_protocol;
+}
+
+std::unique_ptr<Message> GzipDataProtocol::compress(std::unique_ptr<Message> message) const
+{
+    if (!message || message->getContent().size() < m_threshold)
+    {
+        return message;
+    }
+
+    std::string compressed;
+    if (!Gzip::compress(message->getContent(), compressed, m_level))
+    {
+        LOG(WARN) << "GzipDataProtocol: Unable to compress payload, sending it uncompressed";
+        return message;
+    }
+
+    if (compressed.size() >= message->getContent().size())
+    {
+        return message;
+    }
+
+    return std::unique_ptr<Message>(new Message(std::move(compressed), message->getChannel()));
+}
+}    // namespace wolkabout
@@ -0,0 +1,91 @@
+/*
+ * Copyright 2020 WolkAbout Technology s.r.o.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef GZIPDATAPROTOCOL_H
+#define GZIPDATAPROTOCOL_H
+
+#include "protocol/DataProtocol.h"
+#include "utilities/Gzip.h"
+
+#include <cstddef>
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace wolkabout
+{
+/**
+ * @brief Compresses outbound payloads of another wolkabout::DataProtocol with gzip.<br>
+ *        Payloads smaller than the threshold, or which do not get smaller, are sent as they are, so the receiver
+ *        tells compressed payloads apart by gzip magic bytes. Channels and inbound messages are left to the
+ *        wrapped protocol.
+ */
+class GzipDataProtocol : public DataProtocol
+{
+public:
+    /**
+     * @param protocol Protocol which encodes payloads
+     * @param threshold Size of payload, in bytes, below which it is not compressed
+     * @param level zlib compression level, 1 (fastest) to 9 (smallest)
+     */
+    GzipDataProtocol(std::unique_ptr<DataProtocol> protocol, std::size_t threshold = DEFAULT_THRESHOLD,
+                     int level = Gzip::DEFAULT_LEVEL);
+
+    std::vector<std::string> getInboundChannels() const override;
+    std::vector<std::string> getInboundChannelsForDevice(const std::string& deviceKey) const override;
+    std::string extractDeviceKeyFromChannel(const std::string& topic) const override;
+
+    std::string extractReferenceFromChannel(const std::string& topic) const override;
+
+    bool isActuatorSetMessage(const Message& message) const override;
+    bool isActuatorGetMessage(const Message& message) const override;
+
+    bool isConfigurationSetMessage(const Message& message) const override;
+    bool isConfigurationGetMessage(const Message& message) const override;
+
+    std::unique_ptr<ActuatorGetCommand> makeActuatorGetCommand(const Message& message) const override;
+    std::unique_ptr<ActuatorSetCommand> makeActuatorSetCommand(const Message& message) const override;
+
+    std::unique_ptr<ConfigurationSetCommand> makeConfigurationSetCommand(const Message& message) const override;
+
+    std::unique_ptr<Message> makeMessage(
+      const std::string& deviceKey,
+      const std::vector<std::shared_ptr<SensorReading>>& sensorReadings) const override;
+
+    std::unique_ptr<Message> makeMessage(const std::string& deviceKey,
+                                         const std::vector<std::shared_ptr<Alarm>>& alarms) const override;
+
+    std::unique_ptr<Message> makeMessage(
+      const std::string& deviceKey,
+      const std::vector<std::shared_ptr<ActuatorStatus>>& actuatorStatuses) const override;
+
+    std::unique_ptr<Message> makeMessage(const std::string& deviceKey,
+                                         const std::vector<ConfigurationItem>& configuration) const override;
+
+    const DataProtocol& getProtocol() const;
+
+    static const constexpr std::size_t DEFAULT_THRESHOLD = 256;
+
+private:
+    std::unique_ptr<Message> compress(std::unique_ptr<Message> message) const;
+
+    std::unique_ptr<DataProtocol> m_protocol;
+    std::size_t m_threshold;
+    int m_level;
+};
+}    // namespace wolkabout
+
+#endif    // GZIPDATAPROTOCOL_H
@@ -0,0 +1,122 @@
+/*
+ * Copyright 2020 WolkAbout Technology s.r.o.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "protocol/json/StreamingJsonProtocol.h"
+
+#include "model/Message.h"
+#include "model/SensorReading.h"
+#include "utilities/JsonWriter.h"
+
+#include <algorithm>
+#include <cstdint>
+#include <string>
+#include <utility>
+
+namespace wolkabout
+{
+const std::string StreamingJsonProtocol::SENSOR_READING_CHANNEL_ROOT = "d2p/sensor_reading/";
+const std::string StreamingJsonProtocol::DEVICE_PATH_PREFIX = "d/";
+const char StreamingJsonProtocol::MULTI_VALUE_DELIMITER = ',';
+
+const constexpr std::size_t StreamingJsonProtocol::INITIAL_BUFFER_SIZE;
+
+namespace
+{
+struct SensorReadingsBuffers
+{
+    std::size_t payloadSize = StreamingJsonProtocol::INITIAL_BUFFER_SIZE;
+    std::vector<const SensorReading*> sorted;
+};
+
+SensorReadingsBuffers& buffers()
+{
+    // Kept per thread, so the ordering is not allocated again for each message, and the payload, which is handed
+    // over to the message, is allocated once at the size of the previous one instead of growing to it
+    static thread_local SensorReadingsBuffers buffers;
+    return buffers;
+}
+}    // namespace
+
+std::unique_ptr<Message> StreamingJsonProtocol::makeMessage(
+  const std::string& deviceKey, const std::vector<std::shared_ptr<SensorReading>>& sensorReadings) const
+{
+    if (sensorReadings.empty())
+    {
+        return nullptr;
+    }
+
+    auto& reusable = buffers();
+
+    // References are object keys, which JsonProtocol writes in sorted order
+    auto& sorted = reusable.sorted;
+    sorted.clear();
+    for (const auto& sensorReading : sensorReadings)
+    {
+        sorted.push_back(sensorReading.get());
+    }
+    std::stable_sort(sorted.begin(), sorted.end(), [](const SensorReading* lhs, const SensorReading* rhs) {
+        return lhs->getReference() < rhs->getReference();
+    });
+
+    std::string payload;
+    payload.reserve(reusable.payloadSize);
+
+    JsonWriter writer{payload};
+    writer.beginObject();
+
+    const std::string* reference = nullptr;
+    for (const auto* sensorReading : sorted)
+    {
+        if (!reference || *reference != sensorReading->getReference())
+        {
+            if (reference)
+            {
+                writer.endArray();
+            }
+
+            reference = &sensorReading->getReference();
+            writer.key(*reference).beginArray();
+        }
+
+        writer.beginObject().key("data").beginString();
+
+        const auto& values = sensorReading->getValues();
+        for (std::size_t i = 0; i < values.size(); ++i)
+        {
+            if (i != 0)
+            {
+                writer.appendString(MULTI_VALUE_DELIMITER);
+            }
+            writer.appendString(values[i]);
+        }
+        writer.endString();
+
+        if (sensorReading->getRtc() != 0)
+        {
+            writer.key("utc").value(static_cast<std::uint64_t>(sensorReading->getRtc()));
+        }
+
+        writer.endObject();
+    }
+
+    writer.endArray().endObject();
+
+    reusable.payloadSize = std::max(payload.size(), INITIAL_BUFFER_SIZE);
+
+    return std::unique_ptr<Message>(
+      new Message(std::move(payload), SENSOR_READING_CHANNEL_ROOT + DEVICE_PATH_PREFIX + deviceKey));
+}
+}    // namespace wolkabout
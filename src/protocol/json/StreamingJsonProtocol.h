@@ -0,0 +1,53 @@
+/*
+ * Copyright 2020 WolkAbout Technology s.r.o.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef STREAMINGJSONPROTOCOL_H
+#define STREAMINGJSONPROTOCOL_H
+
+#include "protocol/json/JsonProtocol.h"
+
+#include <cstddef>
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace wolkabout
+{
+/**
+ * @brief wolkabout::JsonProtocol which writes sensor reading messages directly into their payload,
+ *        instead of building JSON objects first.<br>
+ *        Payloads are byte-identical to those of wolkabout::JsonProtocol.<br>
+ *        Only sensor readings are streamed, as they make up the bulk of published data, while alarms,
+ *        actuator statuses and configuration are built by wolkabout::JsonProtocol.
+ */
+class StreamingJsonProtocol : public JsonProtocol
+{
+public:
+    using JsonProtocol::makeMessage;
+
+    std::unique_ptr<Message> makeMessage(
+      const std::string& deviceKey,
+      const std::vector<std::shared_ptr<SensorReading>>& sensorReadings) const override;
+
+    static const std::string SENSOR_READING_CHANNEL_ROOT;
+    static const std::string DEVICE_PATH_PREFIX;
+    static const char MULTI_VALUE_DELIMITER;
+
+    static const constexpr std::size_t INITIAL_BUFFER_SIZE = 4096;
+};
+}    // namespace wolkabout
+
+#endif    // STREAMINGJSONPROTOCOL_H
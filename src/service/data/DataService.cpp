@@ -19,18 +19,26 @@
 #include "connectivity/ConnectivityService.h"
 #include "model/ActuatorGetCommand.h"
 #include "model/ActuatorSetCommand.h"
+#include "model/Alarm.h"
 #include "model/ConfigurationSetCommand.h"
 #include "model/Message.h"
 #include "model/SensorReading.h"
 #include "persistence/Persistence.h"
+#include "persistence/TypedPersistence.h"
 #include "protocol/DataProtocol.h"
+#include "service/data/PayloadSizeEstimator.h"
 #include "utilities/Logger.h"
 
 #include <algorithm>
 #include <cassert>
+#include <deque>
 
 namespace wolkabout
 {
+const constexpr std::uint_fast64_t DataService::ALL_ITEMS;
+const constexpr std::size_t DataService::DIRECT_ITEMS_CAPACITY;
+const constexpr std::chrono::milliseconds DataService::DEFAULT_ACK_TIMEOUT;
+
 DataService::DataService(std::string deviceKey, DataProtocol& protocol, Persistence& persistence,
                          ConnectivityService& connectivityService, const ActuatorSetHandler& actuatorSetHandler,
                          const ActuatorGetHandler& actuatorGetHandler,
@@ -39,11 +47,33 @@ DataService::DataService(std::string deviceKey, DataProtocol& protocol, Persiste
 : m_deviceKey{std::move(deviceKey)}
 , m_protocol{protocol}
 , m_persistence{persistence}
+, m_typedPersistence{dynamic_cast<TypedPersistence*>(&persistence)}
+, m_ownReferenceRegistry{m_typedPersistence ? nullptr : new ReferenceRegistry()}
+, m_referenceRegistry{m_typedPersistence ? m_typedPersistence->getReferenceRegistry() : *m_ownReferenceRegistry}
 , m_connectivityService{connectivityService}
 , m_actuatorSetHandler{actuatorSetHandler}
 , m_actuatorGetHandler{actuatorGetHandler}
 , m_configurationSetHandler{configurationSetHandler}
 , m_configurationGetHandler{configurationGetHandler}
+, m_publishBatchItemsCount{PUBLISH_BATCH_ITEMS_COUNT}
+, m_crossReferenceBatching{false}
+, m_actuatorStatusBatching{false}
+, m_maxPayloadSize{0}
+, m_payloadSizeEstimator{std::make_shared<PayloadSizeEstimator>()}
+, m_publishWindow{1}
+, m_ackTimeout{DEFAULT_ACK_TIMEOUT}
+, m_publishBudget{}
+, m_directPublish{false}
+, m_connected{true}
+, m_sensorReadingsBacklog{1}
+, m_alarmsBacklog{1}
+, m_suppressedSensorReadings{0}
+, m_suppressedAlarms{0}
+, m_suppressedActuatorStatuses{0}
+, m_suppressedConfiguration{0}
+, m_priorityItemsAdded{0}
+, m_directSensorReadings{DIRECT_ITEMS_CAPACITY}
+, m_directAlarms{DIRECT_ITEMS_CAPACITY}
 {
 }
 
@@ -126,24 +156,78 @@ const Protocol& DataService::getProtocol()
 
 void DataService::addSensorReading(const std::string& reference, const std::string& value, unsigned long long int rtc)
 {
-    auto sensorReading = std::make_shared<SensorReading>(value, reference, rtc);
-
-    m_persistence.putSensorReading(reference, sensorReading);
+    putSensorReading(std::make_shared<SensorReading>(value, reference, rtc));
 }
 
 void DataService::addSensorReading(const std::string& reference, const std::vector<std::string>& values,
                                    unsigned long long int rtc)
 {
-    auto sensorReading = std::make_shared<SensorReading>(values, reference, rtc);
+    putSensorReading(std::make_shared<SensorReading>(values, reference, rtc));
+}
+
+void DataService::addSensorReading(const std::string& reference, const ReadingValue& value, unsigned long long int rtc)
+{
+    if (m_typedPersistence && !publishesSensorReadingsDirectly())
+    {
+        // value is formatted once readings are retrieved for publishing
+        m_typedPersistence->putSensorReading(reference, value, rtc);
+        ++m_sensorReadingsBacklog;
+        return;
+    }
+
+    putSensorReading(value.isMultiValue() ? std::make_shared<SensorReading>(value.toStrings(), reference, rtc) :
+                                            std::make_shared<SensorReading>(value.toString(), reference, rtc));
+}
+
+void DataService::addSensorReading(ReferenceHandle handle, const ReadingValue& value, unsigned long long int rtc)
+{
+    if (m_typedPersistence && !publishesSensorReadingsDirectly())
+    {
+        m_typedPersistence->putSensorReading(handle, value, rtc);
+        ++m_sensorReadingsBacklog;
+        return;
+    }
+
+    const auto reference = m_referenceRegistry.resolve(handle);
+    if (reference.empty())
+    {
+        LOG(WARN) << "Unknown sensor handle: " << handle.id;
+        return;
+    }
+
+    addSensorReading(reference, value, rtc);
+}
+
+void DataService::addSensorReadings(const std::vector<ReadingEntry>& readings)
+{
+    if (m_typedPersistence && !publishesSensorReadingsDirectly())
+    {
+        m_typedPersistence->putSensorReadings(readings);
+        ++m_sensorReadingsBacklog;
+        return;
+    }
 
-    m_persistence.putSensorReading(reference, sensorReading);
+    for (const auto& reading : readings)
+    {
+        addSensorReading(reading.reference, reading.value, reading.rtc);
+    }
 }
 
 void DataService::addAlarm(const std::string& reference, bool active, unsigned long long int rtc)
 {
-    auto alarm = std::make_shared<Alarm>(active, reference, rtc);
+    putAlarm(std::make_shared<Alarm>(active, reference, rtc));
+}
+
+void DataService::addAlarm(ReferenceHandle handle, bool active, unsigned long long int rtc)
+{
+    const auto reference = m_referenceRegistry.resolve(handle);
+    if (reference.empty())
+    {
+        LOG(WARN) << "Unknown alarm handle: " << handle.id;
+        return;
+    }
 
-    m_persistence.putAlarm(reference, alarm);
+    addAlarm(reference, active, rtc);
 }
 
 void DataService::addActuatorStatus(const std::string& reference, const std::string& value, ActuatorStatus::State state)
@@ -151,6 +235,7 @@ void DataService::addActuatorStatus(const std::string& reference, const std::str
     auto actuatorStatusWithRef = std::make_shared<ActuatorStatus>(value, reference, state);
 
     m_persistence.putActuatorStatus(reference, actuatorStatusWithRef);
+    ++m_priorityItemsAdded;
 }
 
 void DataService::addConfiguration(const std::vector<ConfigurationItem>& configuration)
@@ -158,87 +243,713 @@ void DataService::addConfiguration(const std::vector<ConfigurationItem>& configu
     auto conf = std::make_shared<std::vector<ConfigurationItem>>(configuration);
 
     m_persistence.putConfiguration(m_deviceKey, conf);
+    ++m_priorityItemsAdded;
 }
 
-void DataService::publishSensorReadings()
+void DataService::putSensorReading(std::shared_ptr<SensorReading> sensorReading)
 {
-    for (const auto& key : m_persistence.getSensorReadingsKeys())
+    // readings which do not fit are stored, and later ones are stored behind them
+    if (publishesSensorReadingsDirectly() && m_directSensorReadings.tryPush(sensorReading))
     {
-        publishSensorReadingsForPersistanceKey(key);
+        return;
     }
+
+    persist(sensorReading);
+    ++m_sensorReadingsBacklog;
 }
 
-void DataService::publishSensorReadingsForPersistanceKey(const std::string& persistanceKey)
+void DataService::putAlarm(std::shared_ptr<Alarm> alarm)
 {
-    const auto sensorReadings = m_persistence.getSensorReadings(persistanceKey, PUBLISH_BATCH_ITEMS_COUNT);
+    if (!publishesAlarmsDirectly() || !m_directAlarms.tryPush(alarm))
+    {
+        persist(alarm);
+        ++m_alarmsBacklog;
+    }
+
+    ++m_priorityItemsAdded;
+}
+
+bool DataService::publishesSensorReadingsDirectly() const
+{
+    return m_directPublish && m_connected && m_sensorReadingsBacklog == 0;
+}
+
+bool DataService::publishesAlarmsDirectly() const
+{
+    return m_directPublish && m_connected && m_alarmsBacklog == 0;
+}
 
-    if (sensorReadings.empty())
+ReferenceHandle DataService::registerReference(const std::string& reference)
+{
+    return m_referenceRegistry.intern(reference);
+}
+
+void DataService::setPublishBatching(std::size_t itemsPerMessage, bool crossReference)
+{
+    m_publishBatchItemsCount = std::max<std::size_t>(itemsPerMessage, 1);
+    m_crossReferenceBatching = crossReference;
+}
+
+void DataService::setActuatorStatusBatching(bool enabled)
+{
+    m_actuatorStatusBatching = enabled;
+}
+
+void DataService::setMaxPayloadSize(std::size_t bytes, std::shared_ptr<PayloadSizeEstimator> estimator)
+{
+    m_maxPayloadSize = bytes;
+    if (estimator)
     {
-        return;
+        m_payloadSizeEstimator = std::move(estimator);
     }
+}
 
-    const std::shared_ptr<Message> outboundMessage = m_protocol.makeMessage(m_deviceKey, sensorReadings);
+template <typename T>
+std::size_t DataService::fitToPayload(const std::vector<std::shared_ptr<T>>& items, std::size_t& payloadSize) const
+{
+    if (m_maxPayloadSize == 0)
+    {
+        return items.size();
+    }
 
-    if (!outboundMessage)
+    std::size_t count = 0;
+    for (const auto& item : items)
     {
-        LOG(ERROR) << "Unable to create message from readings: " << persistanceKey;
-        m_persistence.removeSensorReadings(persistanceKey, PUBLISH_BATCH_ITEMS_COUNT);
-        return;
+        const auto itemSize = m_payloadSizeEstimator->estimate(*item);
+
+        // message holds at least one item, even if it is larger than allowed
+        if (payloadSize != 0 && payloadSize + itemSize > m_maxPayloadSize)
+        {
+            break;
+        }
+
+        payloadSize += itemSize;
+        ++count;
     }
 
-    if (m_connectivityService.publish(outboundMessage))
+    return count;
+}
+
+bool DataService::exceedsMaxPayloadSize(const Message& message) const
+{
+    return m_maxPayloadSize != 0 && message.getContent().size() > m_maxPayloadSize;
+}
+
+template <typename T>
+PublishCounts DataService::publishDirectItems(MpscRingBuffer<std::shared_ptr<T>>& queue, bool crossReference,
+                                              std::atomic<std::uint64_t>& backlog)
+{
+    PublishCounts counts;
+
+    std::vector<std::shared_ptr<T>> items;
+    queue.popBatch(items, queue.capacity());
+
+    std::size_t published = 0;
+    while (published < items.size() && m_connected)
     {
-        m_persistence.removeSensorReadings(persistanceKey, PUBLISH_BATCH_ITEMS_COUNT);
+        auto end = std::min(items.size(), published + m_publishBatchItemsCount);
+        if (!crossReference)
+        {
+            end = static_cast<std::size_t>(
+              std::find_if(items.begin() + static_cast<std::ptrdiff_t>(published),
+                           items.begin() + static_cast<std::ptrdiff_t>(end),
+                           [&](const std::shared_ptr<T>& item) {
+                               return item->getReference() != items[published]->getReference();
+                           }) -
+              items.begin());
+        }
+
+        std::vector<std::shared_ptr<T>> batch(items.begin() + static_cast<std::ptrdiff_t>(published),
+                                              items.begin() + static_cast<std::ptrdiff_t>(end));
+        std::size_t payloadSize = 0;
+        batch.resize(fitToPayload(batch, payloadSize));
+
+        std::shared_ptr<Message> outboundMessage = m_protocol.makeMessage(m_deviceKey, batch);
 
-        // proceed to publish next batch only if publish is successfull
-        publishSensorReadingsForPersistanceKey(persistanceKey);
+        while (outboundMessage && batch.size() > 1 && exceedsMaxPayloadSize(*outboundMessage))
+        {
+            batch.resize(batch.size() / 2);
+            ++counts.splits;
+            outboundMessage = m_protocol.makeMessage(m_deviceKey, batch);
+        }
+
+        if (!outboundMessage)
+        {
+            LOG(ERROR) << "Unable to create message from: " << batch.front()->getReference();
+            published += batch.size();
+            continue;
+        }
+
+        if (!m_connectivityService.publish(outboundMessage))
+        {
+            break;
+        }
+
+        published += batch.size();
+        counts.sent += batch.size();
+        counts.bytes += outboundMessage->getContent().size();
+        ++counts.messages;
     }
+
+    // items left unsent are stored, and new items are stored behind them until persistence is drained
+    for (auto it = items.begin() + static_cast<std::ptrdiff_t>(published); it != items.end(); ++it)
+    {
+        persist(*it);
+    }
+
+    if (published < items.size())
+    {
+        counts.remaining = items.size() - published;
+        ++backlog;
+    }
+
+    return counts;
 }
 
-void DataService::publishAlarms()
+void DataService::persist(const std::shared_ptr<SensorReading>& sensorReading)
 {
-    for (const auto& key : m_persistence.getAlarmsKeys())
+    m_persistence.putSensorReading(sensorReading->getReference(), sensorReading);
+}
+
+void DataService::persist(const std::shared_ptr<Alarm>& alarm)
+{
+    m_persistence.putAlarm(alarm->getReference(), alarm);
+}
+
+void DataService::setPublishWindow(std::size_t messages, std::chrono::milliseconds ackTimeout)
+{
+    m_publishWindow = std::max<std::size_t>(messages, 1);
+    m_ackTimeout = ackTimeout;
+
+    // previous workers are stopped first, so there are never more than the window publishing
+    m_publisherPool.reset();
+    if (m_publishWindow > 1)
     {
-        publishAlarmsForPersistanceKey(key);
+        m_publisherPool.reset(new PublisherPool(m_connectivityService, m_publishWindow));
     }
+
+    // every message in flight may fail along with the first one
+    m_sensorReadingsMessageCache.setCapacity(m_publishWindow);
+}
+
+void DataService::setPublishBudget(PublishBudget budget)
+{
+    budget.quantum = std::max<std::size_t>(budget.quantum, 1);
+    m_publishBudget = budget;
 }
 
-void DataService::publishAlarmsForPersistanceKey(const std::string& persistanceKey)
+void DataService::setPreemptionCheck(std::function<bool()> check)
 {
-    const auto alarms = m_persistence.getAlarms(persistanceKey, PUBLISH_BATCH_ITEMS_COUNT);
+    m_preemptionCheck = std::move(check);
+}
 
-    if (alarms.empty())
+PublishCounts DataService::publishSensorReadings()
+{
+    if (!m_connected)
     {
-        return;
+        ++m_suppressedSensorReadings;
+
+        std::uint64_t remaining = 0;
+        for (const auto& key : m_persistence.getSensorReadingsKeys())
+        {
+            remaining += sensorReadingsCount(key);
+        }
+
+        return suppressedCounts(remaining);
     }
 
-    const std::shared_ptr<Message> outboundMessage = m_protocol.makeMessage(m_deviceKey, alarms);
+    auto backlog = m_sensorReadingsBacklog.load();
 
-    if (!outboundMessage)
+    auto counts = publishDirectItems(m_directSensorReadings, m_crossReferenceBatching, m_sensorReadingsBacklog);
+    if (counts.remaining != 0)
     {
-        LOG(ERROR) << "Unable to create message from alarms: " << persistanceKey;
-        m_persistence.removeAlarms(persistanceKey, PUBLISH_BATCH_ITEMS_COUNT);
-        return;
+        // readings which failed to publish are the only ones in persistence, and are published on the next call
+        return counts;
     }
 
-    if (m_connectivityService.publish(outboundMessage))
+    const auto start = std::chrono::steady_clock::now();
+    const auto priorityItemsAdded = m_priorityItemsAdded.load();
+
+    const auto keys = m_persistence.getSensorReadingsKeys();
+
+    // keys are served round robin, each one up to quantum readings per turn, starting where previous call stopped
+    std::vector<std::size_t> rotation(keys.size());
+    const auto first = std::find(keys.begin(), keys.end(), m_nextSensorReadingsKey);
+    const auto offset = first != keys.end() ? static_cast<std::size_t>(first - keys.begin()) : 0;
+    for (std::size_t i = 0; i < keys.size(); ++i)
+    {
+        rotation[i] = (offset + i) % keys.size();
+    }
+    std::size_t position = 0;
+
+    std::vector<std::size_t> deficit(keys.size(), 0);
+
+    // readings of each key which are batched or in flight, and therefore skipped when reading next batch
+    std::vector<std::uint_fast64_t> inFlightItems(keys.size(), 0);
+
+    // keys which returned all of their readings, and are not read again until a batch is sent
+    std::vector<bool> exhausted(keys.size(), false);
+
+    std::deque<InFlightBatch> inFlight;
+    bool failed = false;
+    bool budgetSpent = false;
+    std::uint64_t batchedItems = 0;
+
+    std::vector<std::shared_ptr<SensorReading>> batch;
+
+    while (!failed)
     {
-        m_persistence.removeAlarms(persistanceKey, PUBLISH_BATCH_ITEMS_COUNT);
+        if ((m_publishBudget.items != 0 && batchedItems >= m_publishBudget.items) ||
+            (m_publishBudget.time.count() != 0 && std::chrono::steady_clock::now() - start >= m_publishBudget.time))
+        {
+            budgetSpent = true;
+            break;
+        }
+
+        // added by another thread, and left for the caller to publish before the rest of the readings
+        if (m_priorityItemsAdded.load() != priorityItemsAdded)
+        {
+            counts.preempted = true;
+            budgetSpent = true;
+            break;
+        }
+
+        // commands waiting for the publishing thread, such as connection changes, go ahead of the rest of readings
+        if (m_preemptionCheck && m_preemptionCheck())
+        {
+            budgetSpent = true;
+            break;
+        }
 
-        // proceed to publish next batch only if publish is successfull
-        publishAlarmsForPersistanceKey(persistanceKey);
+        batch.clear();
+        InFlightBatch batchInFlight;
+        std::size_t payloadSize = 0;
+
+        // keys visited in a row without adding readings to the batch
+        std::size_t idle = 0;
+
+        while (!rotation.empty() && idle < rotation.size() && batch.size() < m_publishBatchItemsCount)
+        {
+            position %= rotation.size();
+            const auto keyIndex = rotation[position];
+
+            if (exhausted[keyIndex])
+            {
+                ++idle;
+                ++position;
+                continue;
+            }
+
+            if (deficit[keyIndex] == 0)
+            {
+                deficit[keyIndex] = m_publishBudget.quantum;
+            }
+
+            const auto skip = inFlightItems[keyIndex];
+            const auto wanted = std::min<std::size_t>(deficit[keyIndex], m_publishBatchItemsCount - batch.size());
+            const auto sensorReadings = m_persistence.getSensorReadings(keys[keyIndex], skip + wanted);
+            if (sensorReadings.size() <= skip)
+            {
+                if (skip == 0)
+                {
+                    rotation.erase(rotation.begin() + static_cast<std::ptrdiff_t>(position));
+                }
+                else
+                {
+                    exhausted[keyIndex] = true;
+                    ++idle;
+                    ++position;
+                }
+                continue;
+            }
+
+            const std::vector<std::shared_ptr<SensorReading>> available(
+              sensorReadings.begin() + static_cast<std::ptrdiff_t>(skip), sensorReadings.end());
+            const auto count = fitToPayload(available, payloadSize);
+            if (count == 0)
+            {
+                break;
+            }
+
+            batch.insert(batch.end(), available.begin(), available.begin() + static_cast<std::ptrdiff_t>(count));
+            batchInFlight.keys.emplace_back(keyIndex, count);
+            inFlightItems[keyIndex] += count;
+            deficit[keyIndex] -= count;
+            idle = 0;
+
+            if (available.size() < wanted)
+            {
+                exhausted[keyIndex] = true;
+            }
+
+            if (count < available.size())
+            {
+                break;
+            }
+
+            if (deficit[keyIndex] == 0 || exhausted[keyIndex])
+            {
+                ++position;
+            }
+
+            if (!m_crossReferenceBatching)
+            {
+                break;
+            }
+        }
+
+        if (batch.empty())
+        {
+            break;
+        }
+
+        std::shared_ptr<Message> outboundMessage = makeSensorReadingsMessage(batch);
+
+        // estimate was off, so batch is halved until message fits
+        while (outboundMessage && batch.size() > 1 && exceedsMaxPayloadSize(*outboundMessage))
+        {
+            std::size_t kept = batch.size() / 2;
+            batch.resize(kept);
+
+            auto& batchKeys = batchInFlight.keys;
+            for (auto& batchKey : batchKeys)
+            {
+                const auto taken = std::min(kept, batchKey.second);
+
+                // readings left out of the batch are read again, within the same turn of their key
+                inFlightItems[batchKey.first] -= batchKey.second - taken;
+                deficit[batchKey.first] += batchKey.second - taken;
+
+                batchKey.second = taken;
+                kept -= taken;
+            }
+
+            batchKeys.erase(std::remove_if(batchKeys.begin(), batchKeys.end(),
+                                           [](const std::pair<std::size_t, std::size_t>& batchKey) {
+                                               return batchKey.second == 0;
+                                           }),
+                            batchKeys.end());
+
+            ++counts.splits;
+            outboundMessage = makeSensorReadingsMessage(batch);
+        }
+
+        std::fill(exhausted.begin(), exhausted.end(), false);
+        batchedItems += batch.size();
+
+        std::promise<bool> published;
+        if (!outboundMessage)
+        {
+            LOG(ERROR) << "Unable to create message from readings: " << keys[batchInFlight.keys.front().first];
+
+            // readings are dropped once batches ahead of them are done with, and their keys are not published further
+            batchInFlight.discarded = true;
+            published.set_value(false);
+            batchInFlight.published = published.get_future();
+
+            for (const auto& batchKey : batchInFlight.keys)
+            {
+                rotation.erase(std::remove(rotation.begin(), rotation.end(), batchKey.first), rotation.end());
+            }
+        }
+        else
+        {
+            batchInFlight.readings = batch;
+            batchInFlight.message = outboundMessage;
+            batchInFlight.items = batch.size();
+            batchInFlight.bytes = outboundMessage->getContent().size();
+
+            if (m_publisherPool)
+            {
+                batchInFlight.published = m_publisherPool->publish(outboundMessage);
+            }
+            else
+            {
+                published.set_value(m_connectivityService.publish(outboundMessage));
+                batchInFlight.published = published.get_future();
+            }
+        }
+
+        inFlight.push_back(std::move(batchInFlight));
+
+        while (!failed && inFlight.size() >= m_publishWindow)
+        {
+            failed = !completeSensorReadingsBatch(inFlight.front(), keys, inFlightItems, counts);
+            inFlight.pop_front();
+        }
+    }
+
+    while (!inFlight.empty())
+    {
+        if (failed)
+        {
+            // readings behind the failed batch can not be removed before it, so they are left to be published again
+            abandon(inFlight.front());
+        }
+        else
+        {
+            failed = !completeSensorReadingsBatch(inFlight.front(), keys, inFlightItems, counts);
+        }
+
+        inFlight.pop_front();
+    }
+
+    m_nextSensorReadingsKey = rotation.empty() ? std::string{} : keys[rotation[position % rotation.size()]];
+
+    if (failed || budgetSpent)
+    {
+        for (const auto& key : keys)
+        {
+            counts.remaining += sensorReadingsCount(key);
+        }
+
+        counts.yielded = !failed && counts.remaining != 0;
+    }
+    else
+    {
+        m_sensorReadingsBacklog.compare_exchange_strong(backlog, 0);
+    }
+
+    return counts;
+}
+
+std::uint_fast64_t DataService::sensorReadingsCount(const std::string& key)
+{
+    if (m_typedPersistence)
+    {
+        return m_typedPersistence->getSensorReadingsCount(key);
+    }
+
+    return m_persistence.getSensorReadings(key, ALL_ITEMS).size();
+}
+
+bool DataService::completeSensorReadingsBatch(InFlightBatch& batch, const std::vector<std::string>& keys,
+                                              std::vector<std::uint_fast64_t>& inFlightItems, PublishCounts& counts)
+{
+    if (batch.published.wait_for(m_ackTimeout) != std::future_status::ready)
+    {
+        LOG(WARN) << "Publish of readings not acknowledged in time: " << keys[batch.keys.front().first];
+        abandon(batch);
+        return false;
+    }
+
+    const bool published = batch.published.get();
+    if (!published && !batch.discarded)
+    {
+        m_sensorReadingsMessageCache.put(std::move(batch.readings), std::move(batch.message));
+        return false;
+    }
+
+    m_sensorReadingsMessageCache.remove(batch.readings);
+
+    for (const auto& batchKey : batch.keys)
+    {
+        m_persistence.removeSensorReadings(keys[batchKey.first], batchKey.second);
+        inFlightItems[batchKey.first] -= batchKey.second;
+    }
+
+    if (published)
+    {
+        counts.sent += batch.items;
+        counts.bytes += batch.bytes;
+        ++counts.messages;
+    }
+
+    return true;
+}
+
+void DataService::abandon(InFlightBatch& batch)
+{
+    // publish which timed out keeps its worker busy until it returns, and its result is ignored
+    batch.published = std::future<bool>{};
+
+    // readings are left in persistence, so the same batch is likely to be published again
+    if (!batch.discarded)
+    {
+        m_sensorReadingsMessageCache.put(std::move(batch.readings), std::move(batch.message));
+    }
+}
+
+std::shared_ptr<Message> DataService::makeSensorReadingsMessage(
+  const std::vector<std::shared_ptr<SensorReading>>& sensorReadings)
+{
+    if (auto message = m_sensorReadingsMessageCache.find(sensorReadings))
+    {
+        return message;
+    }
+
+    return m_protocol.makeMessage(m_deviceKey, sensorReadings);
+}
+
+std::shared_ptr<Message> DataService::makeAlarmsMessage(const std::vector<std::shared_ptr<Alarm>>& alarms)
+{
+    if (auto message = m_alarmsMessageCache.find(alarms))
+    {
+        return message;
+    }
+
+    return m_protocol.makeMessage(m_deviceKey, alarms);
+}
+
+PublishCounts DataService::publishAlarms()
+{
+    if (!m_connected)
+    {
+        ++m_suppressedAlarms;
+
+        std::uint64_t remaining = 0;
+        for (const auto& key : m_persistence.getAlarmsKeys())
+        {
+            remaining += m_persistence.getAlarms(key, ALL_ITEMS).size();
+        }
+
+        return suppressedCounts(remaining);
+    }
+
+    auto backlog = m_alarmsBacklog.load();
+
+    auto counts = publishDirectItems(m_directAlarms, false, m_alarmsBacklog);
+    if (counts.remaining != 0)
+    {
+        return counts;
+    }
+
+    for (const auto& key : m_persistence.getAlarmsKeys())
+    {
+        publishAlarmsForPersistanceKey(key, counts);
+    }
+
+    if (counts.remaining == 0)
+    {
+        m_alarmsBacklog.compare_exchange_strong(backlog, 0);
+    }
+
+    return counts;
+}
+
+void DataService::publishAlarmsForPersistanceKey(const std::string& persistanceKey, PublishCounts& counts)
+{
+    while (true)
+    {
+        auto alarms = m_persistence.getAlarms(persistanceKey, m_publishBatchItemsCount);
+
+        if (alarms.empty())
+        {
+            return;
+        }
+
+        std::size_t payloadSize = 0;
+        alarms.resize(fitToPayload(alarms, payloadSize));
+
+        std::shared_ptr<Message> outboundMessage = makeAlarmsMessage(alarms);
+
+        while (outboundMessage && alarms.size() > 1 && exceedsMaxPayloadSize(*outboundMessage))
+        {
+            alarms.resize(alarms.size() / 2);
+            ++counts.splits;
+            outboundMessage = makeAlarmsMessage(alarms);
+        }
+
+        if (!outboundMessage)
+        {
+            LOG(ERROR) << "Unable to create message from alarms: " << persistanceKey;
+            m_persistence.removeAlarms(persistanceKey, alarms.size());
+            return;
+        }
+
+        if (!m_connectivityService.publish(outboundMessage))
+        {
+            m_alarmsMessageCache.put(std::move(alarms), std::move(outboundMessage));
+            counts.remaining += m_persistence.getAlarms(persistanceKey, ALL_ITEMS).size();
+            return;
+        }
+
+        m_alarmsMessageCache.remove(alarms);
+        m_persistence.removeAlarms(persistanceKey, alarms.size());
+        counts.sent += alarms.size();
+        counts.bytes += outboundMessage->getContent().size();
+        ++counts.messages;
     }
 }
 
-void DataService::publishActuatorStatuses()
+PublishCounts DataService::publishActuatorStatuses()
 {
+    if (!m_connected)
+    {
+        ++m_suppressedActuatorStatuses;
+        return suppressedCounts(m_persistence.getActuatorStatusesKeys().size());
+    }
+
+    PublishCounts counts;
+    if (!m_actuatorStatusBatching)
+    {
+        for (const auto& key : m_persistence.getActuatorStatusesKeys())
+        {
+            publishActuatorStatusesForPersistanceKey(key, counts);
+        }
+
+        return counts;
+    }
+
+    std::vector<std::string> keys;
+    std::vector<std::shared_ptr<ActuatorStatus>> actuatorStatuses;
     for (const auto& key : m_persistence.getActuatorStatusesKeys())
     {
-        publishActuatorStatusesForPersistanceKey(key);
+        if (auto actuatorStatus = m_persistence.getActuatorStatus(key))
+        {
+            keys.push_back(key);
+            actuatorStatuses.push_back(std::move(actuatorStatus));
+        }
+
+        if (actuatorStatuses.size() >= m_publishBatchItemsCount)
+        {
+            publishActuatorStatusesBatch(keys, actuatorStatuses, counts);
+            keys.clear();
+            actuatorStatuses.clear();
+        }
+    }
+
+    if (!actuatorStatuses.empty())
+    {
+        publishActuatorStatusesBatch(keys, actuatorStatuses, counts);
     }
+
+    return counts;
+}
+
+void DataService::publishActuatorStatusesBatch(const std::vector<std::string>& persistanceKeys,
+                                               const std::vector<std::shared_ptr<ActuatorStatus>>& actuatorStatuses,
+                                               PublishCounts& counts)
+{
+    const std::shared_ptr<Message> outboundMessage = m_protocol.makeMessage(m_deviceKey, actuatorStatuses);
+
+    if (!outboundMessage)
+    {
+        LOG(ERROR) << "Unable to create message from actuator statuses: " << persistanceKeys.front();
+        for (const auto& key : persistanceKeys)
+        {
+            m_persistence.removeActuatorStatus(key);
+        }
+        return;
+    }
+
+    if (!m_connectivityService.publish(outboundMessage))
+    {
+        counts.remaining += actuatorStatuses.size();
+        return;
+    }
+
+    for (const auto& key : persistanceKeys)
+    {
+        m_persistence.removeActuatorStatus(key);
+    }
+
+    counts.sent += actuatorStatuses.size();
+    counts.bytes += outboundMessage->getContent().size();
+    ++counts.messages;
 }
 
-void DataService::publishActuatorStatusesForPersistanceKey(const std::string& persistanceKey)
+void DataService::publishActuatorStatusesForPersistanceKey(const std::string& persistanceKey, PublishCounts& counts)
 {
     const auto actuatorStatus = m_persistence.getActuatorStatus(persistanceKey);
 
@@ -259,15 +970,31 @@ void DataService::publishActuatorStatusesForPersistanceKey(const std::string& pe
     if (m_connectivityService.publish(outboundMessage))
     {
         m_persistence.removeActuatorStatus(persistanceKey);
+        ++counts.sent;
+        counts.bytes += outboundMessage->getContent().size();
+        ++counts.messages;
+    }
+    else
+    {
+        ++counts.remaining;
     }
 }
 
-void DataService::publishConfiguration()
+PublishCounts DataService::publishConfiguration()
 {
-    publishConfigurationForPersistanceKey(m_deviceKey);
+    if (!m_connected)
+    {
+        ++m_suppressedConfiguration;
+        return suppressedCounts(m_persistence.getConfiguration(m_deviceKey) ? 1 : 0);
+    }
+
+    PublishCounts counts;
+    publishConfigurationForPersistanceKey(m_deviceKey, counts);
+
+    return counts;
 }
 
-void DataService::publishConfigurationForPersistanceKey(const std::string& persistanceKey)
+void DataService::publishConfigurationForPersistanceKey(const std::string& persistanceKey, PublishCounts& counts)
 {
     const auto configuration = m_persistence.getConfiguration(persistanceKey);
 
@@ -288,6 +1015,93 @@ void DataService::publishConfigurationForPersistanceKey(const std::string& persi
     if (m_connectivityService.publish(outboundMessage))
     {
         m_persistence.removeConfiguration(persistanceKey);
+        ++counts.sent;
+        counts.bytes += outboundMessage->getContent().size();
+        ++counts.messages;
+    }
+    else
+    {
+        ++counts.remaining;
+    }
+}
+
+void DataService::setDirectPublish(bool enabled)
+{
+    m_directPublish = enabled;
+    if (!enabled)
+    {
+        persistDirectItems();
+    }
+}
+
+void DataService::setConnected(bool connected)
+{
+    m_connected = connected;
+    if (!connected)
+    {
+        persistDirectItems();
+    }
+}
+
+SuppressedPublishes DataService::getSuppressedPublishes() const
+{
+    SuppressedPublishes suppressed;
+    suppressed.sensorReadings = m_suppressedSensorReadings;
+    suppressed.alarms = m_suppressedAlarms;
+    suppressed.actuatorStatuses = m_suppressedActuatorStatuses;
+    suppressed.configuration = m_suppressedConfiguration;
+    return suppressed;
+}
+
+PublishCounts DataService::suppressedCounts(std::uint64_t remaining)
+{
+    PublishCounts counts;
+    counts.remaining = remaining;
+    counts.suppressed = true;
+    return counts;
+}
+
+bool DataService::hasDirectItems() const
+{
+    return m_directSensorReadings.size() != 0 || m_directAlarms.size() != 0;
+}
+
+PublishResult DataService::publishDirectly()
+{
+    const auto start = std::chrono::steady_clock::now();
+
+    PublishResult result;
+    result.alarms = publishDirectItems(m_directAlarms, false, m_alarmsBacklog);
+    result.sensorReadings =
+      publishDirectItems(m_directSensorReadings, m_crossReferenceBatching, m_sensorReadingsBacklog);
+    result.elapsed =
+      std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - start);
+
+    return result;
+}
+
+void DataService::persistDirectItems()
+{
+    std::vector<std::shared_ptr<SensorReading>> sensorReadings;
+    if (m_directSensorReadings.popBatch(sensorReadings, m_directSensorReadings.capacity()) != 0)
+    {
+        for (const auto& sensorReading : sensorReadings)
+        {
+            persist(sensorReading);
+        }
+
+        ++m_sensorReadingsBacklog;
+    }
+
+    std::vector<std::shared_ptr<Alarm>> alarms;
+    if (m_directAlarms.popBatch(alarms, m_directAlarms.capacity()) != 0)
+    {
+        for (const auto& alarm : alarms)
+        {
+            persist(alarm);
+        }
+
+        ++m_alarmsBacklog;
     }
 }
 }    // namespace wolkabout
@@ -20,19 +20,36 @@
 #include "InboundMessageHandler.h"
 #include "model/ActuatorStatus.h"
 #include "model/ConfigurationItem.h"
+#include "model/PublishResult.h"
+#include "model/ReadingEntry.h"
+#include "model/ReadingValue.h"
+#include "service/data/MessageCache.h"
+#include "service/data/PublisherPool.h"
+#include "utilities/MpscRingBuffer.h"
+#include "utilities/ReferenceRegistry.h"
 
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
 #include <functional>
+#include <future>
 #include <map>
 #include <memory>
 #include <string>
+#include <utility>
 #include <vector>
 
 namespace wolkabout
 {
+class Alarm;
 class DataProtocol;
+class PayloadSizeEstimator;
 class Persistence;
+class TypedPersistence;
 class ConnectivityService;
 class ConfigurationSetCommand;
+class SensorReading;
 
 typedef std::function<void(const std::string&, const std::string&)> ActuatorSetHandler;
 typedef std::function<void(const std::string&)> ActuatorGetHandler;
@@ -40,9 +57,35 @@ typedef std::function<void(const std::string&)> ActuatorGetHandler;
 typedef std::function<void(const ConfigurationSetCommand&)> ConfigurationSetHandler;
 typedef std::function<void()> ConfigurationGetHandler;
 
+/**
+ * @brief Bounds work done by a single call publishing sensor readings, so a large backlog does not hold up
+ *        the caller.<br>
+ *        Persistence keys take turns, each sending up to quantum readings per turn.
+ */
+struct PublishBudget
+{
+    /**
+     * @brief Time after which no more messages are published, 0 for no limit
+     */
+    std::chrono::milliseconds time{0};
+
+    /**
+     * @brief Number of readings after which no more messages are published, 0 for no limit
+     */
+    std::uint64_t items = 0;
+
+    /**
+     * @brief Number of readings of a key sent before the next key takes its turn
+     */
+    std::size_t quantum = 50;
+};
+
 class DataService : public MessageListener
 {
 public:
+    static const constexpr unsigned int PUBLISH_BATCH_ITEMS_COUNT = 50;
+    static const constexpr std::chrono::milliseconds DEFAULT_ACK_TIMEOUT{30000};
+
     DataService(std::string deviceKey, DataProtocol& protocol, Persistence& persistence,
                 ConnectivityService& connectivityService, const ActuatorSetHandler& actuatorSetHandler,
                 const ActuatorGetHandler& actuatorGetHandler, const ConfigurationSetHandler& configurationSetHandler,
@@ -56,32 +99,203 @@ public:
     virtual void addSensorReading(const std::string& reference, const std::vector<std::string>& values,
                                   unsigned long long int rtc);
 
+    virtual void addSensorReading(const std::string& reference, const ReadingValue& value, unsigned long long int rtc);
+
+    virtual void addSensorReading(ReferenceHandle handle, const ReadingValue& value, unsigned long long int rtc);
+
+    virtual void addSensorReadings(const std::vector<ReadingEntry>& readings);
+
     virtual void addAlarm(const std::string& reference, bool active, unsigned long long int rtc);
 
+    virtual void addAlarm(ReferenceHandle handle, bool active, unsigned long long int rtc);
+
     virtual void addActuatorStatus(const std::string& reference, const std::string& value, ActuatorStatus::State state);
 
     virtual void addConfiguration(const std::vector<ConfigurationItem>& configuration);
 
-    virtual void publishSensorReadings();
+    /**
+     * @brief Interns reference, so readings and alarms can be added by handle.<br>
+     *        Handles are issued by the registry of wolkabout::TypedPersistence if one is used
+     */
+    ReferenceHandle registerReference(const std::string& reference);
+
+    /**
+     * @brief Sets maximum number of sensor readings, alarms, or actuator statuses, sent in a single message
+     * @param crossReference Whether a message may hold sensor readings of different references,
+     *        which requires wolkabout::DataProtocol that does not put reference in the channel
+     */
+    void setPublishBatching(std::size_t itemsPerMessage, bool crossReference);
 
-    virtual void publishAlarms();
+    /**
+     * @brief Enables packing actuator statuses of different references into a single message.<br>
+     *        Requires wolkabout::DataProtocol whose actuator status payload carries reference of each status,
+     *        such as wolkabout::CborProtocol. JSON protocols name the actuator in the channel, so each status
+     *        is sent on its own, which is the default
+     */
+    void setActuatorStatusBatching(bool enabled);
 
-    virtual void publishActuatorStatuses();
+    /**
+     * @brief Limits size of payload of sensor reading, and alarm, messages.<br>
+     *        Batches are sized by estimated size of items, and halved if message still turns out larger
+     * @param bytes Maximum payload size, 0 for no limit
+     * @param estimator Estimator of encoded size of items, matching wolkabout::DataProtocol in use<br>
+     *        If omitted, estimator of JSON protocols is used
+     */
+    void setMaxPayloadSize(std::size_t bytes, std::shared_ptr<PayloadSizeEstimator> estimator = nullptr);
 
-    virtual void publishConfiguration();
+    /**
+     * @brief Sets number of sensor reading messages published concurrently.<br>
+     *        Readings are removed from persistence once their message is acknowledged, in order they were
+     *        persisted. Readings of a message which fails, or is not acknowledged in time, are left in persistence
+     *        along with readings of messages published after it, and are published again on the next call.<br>
+     *        Window larger than 1 creates as many publisher threads, which are kept until the window is changed,
+     *        and requires wolkabout::ConnectivityService which can publish from multiple threads
+     * @param messages Maximum number of messages in flight
+     * @param ackTimeout Time to wait for the oldest message in flight to be acknowledged
+     */
+    void setPublishWindow(std::size_t messages, std::chrono::milliseconds ackTimeout = DEFAULT_ACK_TIMEOUT);
+
+    /**
+     * @brief Sets budget of a single publishSensorReadings call
+     */
+    void setPublishBudget(PublishBudget budget);
+
+    /**
+     * @brief Sets check, made before each message of sensor readings, which stops publishSensorReadings once it
+     *        returns true, so that commands queued meanwhile are not held up until the readings are drained.<br>
+     *        Invoked from the thread which publishes
+     */
+    void setPreemptionCheck(std::function<bool()> check);
+
+    /**
+     * @brief Publishes persisted sensor readings until persistence is drained, a publish fails,
+     *        the publish budget is spent, alarms, actuator statuses or configuration are added,
+     *        or the preemption check asks for it.<br>
+     *        Persistence keys are served round robin, continuing on the next call where this one stopped.
+     *        Readings of multiple keys are packed into the same message if cross reference batching is enabled
+     * @return Number of readings published, and left in persistence, and number of messages sent
+     */
+    virtual PublishCounts publishSensorReadings();
+
+    virtual PublishCounts publishAlarms();
+
+    /**
+     * @brief Publishes persisted actuator statuses, packed into messages per publish batching if actuator status
+     *        batching is enabled, and one per message otherwise
+     */
+    virtual PublishCounts publishActuatorStatuses();
+
+    virtual PublishCounts publishConfiguration();
+
+    /**
+     * @brief Enables publishing sensor readings and alarms without storing them, while connected and no readings,
+     *        or alarms respectively, are left in persistence.<br>
+     *        Such items are held until publishDirectly, or publishing of their type, is called.
+     *        Items which fail to publish, or are held when connection is lost, are put into persistence
+     */
+    void setDirectPublish(bool enabled);
+
+    /**
+     * @brief Notifies of connection state, which is assumed to be up until notified otherwise.<br>
+     *        While connection is down, publishing is skipped without reading persistence, and items held for
+     *        direct publishing are put into persistence
+     */
+    void setConnected(bool connected);
+
+    /**
+     * @brief Returns number of publish calls skipped while connection was down, per item type. Thread safe.
+     */
+    SuppressedPublishes getSuppressedPublishes() const;
+
+    /**
+     * @return Whether sensor readings, or alarms, are held for direct publishing
+     */
+    bool hasDirectItems() const;
+
+    /**
+     * @brief Publishes sensor readings and alarms held for direct publishing, without going through persistence
+     * @return Number of items sent, and put into persistence because publish failed, per item type
+     */
+    PublishResult publishDirectly();
 
 private:
+    struct InFlightBatch
+    {
+        // index of persistence key, and number of readings of that key
+        std::vector<std::pair<std::size_t, std::size_t>> keys;
+        std::size_t items = 0;
+        std::size_t bytes = 0;
+
+        std::vector<std::shared_ptr<SensorReading>> readings;
+        std::shared_ptr<Message> message;
+
+        // readings which could not be made into a message, and are removed without being sent
+        bool discarded = false;
+
+        std::future<bool> published;
+    };
+
     std::string getSensorDelimiter(const std::string& key) const;
 
-    void publishSensorReadingsForPersistanceKey(const std::string& persistanceKey);
-    void publishAlarmsForPersistanceKey(const std::string& persistanceKey);
-    void publishActuatorStatusesForPersistanceKey(const std::string& persistanceKey);
-    void publishConfigurationForPersistanceKey(const std::string& persistanceKey);
+    /**
+     * @brief Waits for batch to be published, and removes its readings from persistence if it is
+     * @return false if publish failed or timed out
+     */
+    bool completeSensorReadingsBatch(InFlightBatch& batch, const std::vector<std::string>& keys,
+                                     std::vector<std::uint_fast64_t>& inFlightItems, PublishCounts& counts);
+    void abandon(InFlightBatch& batch);
+
+    /**
+     * @brief Reuses message of the same batch which failed to publish, or makes a new one
+     */
+    std::shared_ptr<Message> makeSensorReadingsMessage(
+      const std::vector<std::shared_ptr<SensorReading>>& sensorReadings);
+    std::shared_ptr<Message> makeAlarmsMessage(const std::vector<std::shared_ptr<Alarm>>& alarms);
+
+    std::uint_fast64_t sensorReadingsCount(const std::string& key);
+
+    static PublishCounts suppressedCounts(std::uint64_t remaining);
+
+    bool publishesSensorReadingsDirectly() const;
+    bool publishesAlarmsDirectly() const;
+
+    void putSensorReading(std::shared_ptr<SensorReading> sensorReading);
+    void putAlarm(std::shared_ptr<Alarm> alarm);
+
+    /**
+     * @brief Publishes items held for direct publishing, and puts those left unsent into persistence
+     * @param backlog Incremented if any item is put into persistence
+     */
+    template <typename T>
+    PublishCounts publishDirectItems(MpscRingBuffer<std::shared_ptr<T>>& queue, bool crossReference,
+                                     std::atomic<std::uint64_t>& backlog);
+    void persistDirectItems();
+
+    void persist(const std::shared_ptr<SensorReading>& sensorReading);
+    void persist(const std::shared_ptr<Alarm>& alarm);
+
+    /**
+     * @return Number of leading items which fit the maximum payload size, along with payloadSize bytes already taken
+     */
+    template <typename T>
+    std::size_t fitToPayload(const std::vector<std::shared_ptr<T>>& items, std::size_t& payloadSize) const;
+    bool exceedsMaxPayloadSize(const Message& message) const;
+
+    void publishAlarmsForPersistanceKey(const std::string& persistanceKey, PublishCounts& counts);
+    void publishActuatorStatusesForPersistanceKey(const std::string& persistanceKey, PublishCounts& counts);
+    void publishActuatorStatusesBatch(const std::vector<std::string>& persistanceKeys,
+                                      const std::vector<std::shared_ptr<ActuatorStatus>>& actuatorStatuses,
+                                      PublishCounts& counts);
+    void publishConfigurationForPersistanceKey(const std::string& persistanceKey, PublishCounts& counts);
 
     const std::string m_deviceKey;
 
     DataProtocol& m_protocol;
     Persistence& m_persistence;
+    TypedPersistence* m_typedPersistence;
+
+    std::unique_ptr<ReferenceRegistry> m_ownReferenceRegistry;
+    ReferenceRegistry& m_referenceRegistry;
     ConnectivityService& m_connectivityService;
 
     ActuatorSetHandler m_actuatorSetHandler;
@@ -90,7 +304,46 @@ private:
     ConfigurationSetHandler m_configurationSetHandler;
     ConfigurationGetHandler m_configurationGetHandler;
 
-    static const constexpr unsigned int PUBLISH_BATCH_ITEMS_COUNT = 50;
+    std::size_t m_publishBatchItemsCount;
+    bool m_crossReferenceBatching;
+    bool m_actuatorStatusBatching;
+
+    std::size_t m_maxPayloadSize;
+    std::shared_ptr<PayloadSizeEstimator> m_payloadSizeEstimator;
+
+    std::size_t m_publishWindow;
+    std::chrono::milliseconds m_ackTimeout;
+    std::unique_ptr<PublisherPool> m_publisherPool;
+
+    PublishBudget m_publishBudget;
+    std::function<bool()> m_preemptionCheck;
+    std::string m_nextSensorReadingsKey;
+
+    MessageCache<SensorReading> m_sensorReadingsMessageCache;
+    MessageCache<Alarm> m_alarmsMessageCache;
+
+    std::atomic_bool m_directPublish;
+    std::atomic_bool m_connected;
+
+    // number of times items were put into persistence since it was last drained, 0 if it may be bypassed.
+    // Drain clears it only if it did not change meanwhile, so items stored by another thread are not skipped
+    std::atomic<std::uint64_t> m_sensorReadingsBacklog;
+    std::atomic<std::uint64_t> m_alarmsBacklog;
+
+    std::atomic<std::uint64_t> m_suppressedSensorReadings;
+    std::atomic<std::uint64_t> m_suppressedAlarms;
+    std::atomic<std::uint64_t> m_suppressedActuatorStatuses;
+    std::atomic<std::uint64_t> m_suppressedConfiguration;
+
+    // number of alarms, actuator statuses and configurations added, which take precedence over sensor readings
+    std::atomic<std::uint64_t> m_priorityItemsAdded;
+
+    // filled by the thread which adds data, and emptied by the one which publishes it
+    MpscRingBuffer<std::shared_ptr<SensorReading>> m_directSensorReadings;
+    MpscRingBuffer<std::shared_ptr<Alarm>> m_directAlarms;
+
+    static const constexpr std::uint_fast64_t ALL_ITEMS = UINT_FAST64_MAX;
+    static const constexpr std::size_t DIRECT_ITEMS_CAPACITY = 4096;
 };
 }    // namespace wolkabout
 
@@ -0,0 +1,94 @@
+/*
+ * Copyright 2020 WolkAbout Technology s.r.o.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef MESSAGECACHE_H
+#define MESSAGECACHE_H
+
+#include "model/Message.h"
+
+#include <algorithm>
+#include <cstddef>
+#include <deque>
+#include <memory>
+#include <utility>
+#include <vector>
+
+namespace wolkabout
+{
+/**
+ * @brief Keeps messages of batches which were not published, so a retry of the same batch is not encoded again.<br>
+ *        Message is found only for a batch of the very same items, in the same order, so items which were removed
+ *        from, or evicted by, persistence in the meantime invalidate it. Cached items are held, so they can not
+ *        be mistaken for items persisted later. Oldest message is dropped once capacity is reached.
+ */
+template <typename T> class MessageCache
+{
+public:
+    explicit MessageCache(std::size_t capacity = 1) : m_capacity{std::max<std::size_t>(capacity, 1)} {}
+
+    std::shared_ptr<Message> find(const std::vector<std::shared_ptr<T>>& items) const
+    {
+        for (const auto& entry : m_entries)
+        {
+            if (entry.first == items)
+            {
+                return entry.second;
+            }
+        }
+
+        return nullptr;
+    }
+
+    void put(std::vector<std::shared_ptr<T>> items, std::shared_ptr<Message> message)
+    {
+        remove(items);
+
+        m_entries.emplace_back(std::move(items), std::move(message));
+        while (m_entries.size() > m_capacity)
+        {
+            m_entries.pop_front();
+        }
+    }
+
+    void remove(const std::vector<std::shared_ptr<T>>& items)
+    {
+        m_entries.erase(std::remove_if(m_entries.begin(), m_entries.end(),
+                                       [&](const Entry& entry) { return entry.first == items; }),
+                        m_entries.end());
+    }
+
+    void clear() { m_entries.clear(); }
+
+    void setCapacity(std::size_t capacity)
+    {
+        m_capacity = std::max<std::size_t>(capacity, 1);
+        while (m_entries.size() > m_capacity)
+        {
+            m_entries.pop_front();
+        }
+    }
+
+    std::size_t size() const { return m_entries.size(); }
+
+private:
+    using Entry = std::pair<std::vector<std::shared_ptr<T>>, std::shared_ptr<Message>>;
+
+    std::size_t m_capacity;
+    std::deque<Entry> m_entries;
+};
+}    // namespace wolkabout
+
+#endif    // MESSAGECACHE_H
@@ -0,0 +1,44 @@
+/*
+ * Copyright 2020 WolkAbout Technology s.r.o.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "service/data/PayloadSizeEstimator.h"
+
+#include "model/Alarm.h"
+#include "model/SensorReading.h"
+
+namespace wolkabout
+{
+const constexpr std::size_t PayloadSizeEstimator::MIN_ITEM_SIZE;
+const constexpr std::size_t PayloadSizeEstimator::JSON_ITEM_OVERHEAD;
+
+std::size_t PayloadSizeEstimator::estimate(const SensorReading& sensorReading) const
+{
+    std::size_t size = JSON_ITEM_OVERHEAD + sensorReading.getReference().size();
+    for (const auto& value : sensorReading.getValues())
+    {
+        // value and delimiter
+        size += value.size() + 1;
+    }
+
+    return size;
+}
+
+std::size_t PayloadSizeEstimator::estimate(const Alarm& alarm) const
+{
+    // "true" or "false"
+    return JSON_ITEM_OVERHEAD + alarm.getReference().size() + 5;
+}
+}    // namespace wolkabout
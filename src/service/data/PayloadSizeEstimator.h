@@ -0,0 +1,53 @@
+/*
+ * Copyright 2020 WolkAbout Technology s.r.o.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef PAYLOADSIZEESTIMATOR_H
+#define PAYLOADSIZEESTIMATOR_H
+
+#include <cstddef>
+
+namespace wolkabout
+{
+class Alarm;
+class SensorReading;
+
+/**
+ * @brief Estimates number of bytes items take once wolkabout::DataProtocol encodes them, so batches can be sized
+ *        without encoding them first.<br>
+ *        Default implementation estimates encoding of JSON protocols. Estimate may be off, as messages
+ *        which turn out larger than allowed are split.
+ */
+class PayloadSizeEstimator
+{
+public:
+    /**
+     * @brief Smallest number of bytes an item is expected to take, which bounds number of items read for a message
+     */
+    static const constexpr std::size_t MIN_ITEM_SIZE = 16;
+
+    virtual ~PayloadSizeEstimator() = default;
+
+    virtual std::size_t estimate(const SensorReading& sensorReading) const;
+
+    virtual std::size_t estimate(const Alarm& alarm) const;
+
+private:
+    // braces, quotes, separators and 13 digit timestamp
+    static const constexpr std::size_t JSON_ITEM_OVERHEAD = 32;
+};
+}    // namespace wolkabout
+
+#endif    // PAYLOADSIZEESTIMATOR_H
@@ -0,0 +1,87 @@
+/*
+ * Copyright 2020 WolkAbout Technology s.r.o.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "service/data/PublisherPool.h"
+
+#include "connectivity/ConnectivityService.h"
+#include "model/Message.h"
+
+#include <utility>
+
+namespace wolkabout
+{
+PublisherPool::PublisherPool(ConnectivityService& connectivityService, std::size_t workers)
+: m_connectivityService{connectivityService}, m_run{true}
+{
+    for (std::size_t i = 0; i < workers; ++i)
+    {
+        m_workers.emplace_back(&PublisherPool::run, this);
+    }
+}
+
+PublisherPool::~PublisherPool()
+{
+    {
+        std::lock_guard<std::mutex> lock{m_mutex};
+        m_run = false;
+    }
+
+    m_condition.notify_all();
+
+    for (auto& worker : m_workers)
+    {
+        worker.join();
+    }
+}
+
+std::future<bool> PublisherPool::publish(std::shared_ptr<Message> message)
+{
+    Publish publish;
+    publish.message = std::move(message);
+    auto published = publish.published.get_future();
+
+    {
+        std::lock_guard<std::mutex> lock{m_mutex};
+        m_publishes.push_back(std::move(publish));
+    }
+
+    m_condition.notify_one();
+    return published;
+}
+
+void PublisherPool::run()
+{
+    while (true)
+    {
+        Publish publish;
+
+        {
+            std::unique_lock<std::mutex> lock{m_mutex};
+            m_condition.wait(lock, [this] { return !m_run || !m_publishes.empty(); });
+
+            if (!m_run)
+            {
+                return;
+            }
+
+            publish = std::move(m_publishes.front());
+            m_publishes.pop_front();
+        }
+
+        publish.published.set_value(m_connectivityService.publish(publish.message));
+    }
+}
+}    // namespace wolkabout
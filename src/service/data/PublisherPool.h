@@ -0,0 +1,74 @@
+/*
+ * Copyright 2020 WolkAbout Technology s.r.o.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef PUBLISHERPOOL_H
+#define PUBLISHERPOOL_H
+
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <future>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace wolkabout
+{
+class ConnectivityService;
+class Message;
+
+/**
+ * @brief Fixed number of worker threads which publish messages through wolkabout::ConnectivityService,
+ *        so that up to that many publishes are in progress at once.<br>
+ *        Messages are published in order they were submitted, each by the first worker which is free.
+ */
+class PublisherPool
+{
+public:
+    PublisherPool(ConnectivityService& connectivityService, std::size_t workers);
+
+    /**
+     * @brief Stops workers once their current publish returns. Messages not yet picked up are not published
+     */
+    ~PublisherPool();
+
+    /**
+     * @return Future which becomes ready with result of the publish
+     */
+    std::future<bool> publish(std::shared_ptr<Message> message);
+
+private:
+    struct Publish
+    {
+        std::shared_ptr<Message> message;
+        std::promise<bool> published;
+    };
+
+    void run();
+
+    ConnectivityService& m_connectivityService;
+
+    std::mutex m_mutex;
+    std::condition_variable m_condition;
+    std::deque<Publish> m_publishes;
+    bool m_run;
+
+    std::vector<std::thread> m_workers;
+};
+}    // namespace wolkabout
+
+#endif    // PUBLISHERPOOL_H
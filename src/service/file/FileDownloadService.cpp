@@ -37,6 +37,7 @@
 #include "utilities/ByteUtils.h"
 #include "utilities/FileSystemUtils.h"
 #include "utilities/Logger.h"
+#include "utilities/SyncState.h"
 
 #include <algorithm>
 #include <cassert>
@@ -64,6 +65,8 @@ FileDownloadService::FileDownloadService(std::string deviceKey, JsonDownloadProt
 , m_fileRepository{fileRepository}
 , m_urlFileDownloader{std::move(urlFileDownloader)}
 , m_activeDownload{""}
+, m_fileListPublished{false}
+, m_publishedFileListHash{0}
 , m_run{true}
 , m_garbageCollector(&FileDownloadService::clearDownloads, this)
 {
@@ -442,6 +445,13 @@ void FileDownloadService::sendFileList()
     addToCommandBuffer([=] { sendFileListUpdate(); });
 }
 
+void FileDownloadService::syncFileList()
+{
+    LOG(DEBUG) << "FileDownloadService::syncFileList";
+
+    addToCommandBuffer([=] { sendFileListUpdate(true); });
+}
+
 void FileDownloadService::sendStatus(const FileUploadStatus& response)
 {
     std::shared_ptr<Message> message = m_protocol.makeMessage(m_deviceKey, response);
@@ -468,12 +478,22 @@ void FileDownloadService::sendStatus(const FileUrlDownloadStatus& response)
     m_connectivityService.publish(message);
 }
 
-void FileDownloadService::sendFileListUpdate()
+void FileDownloadService::sendFileListUpdate(bool onlyIfChanged)
 {
     LOG(DEBUG) << "FileDownloadService::sendFileListUpdate";
 
     auto fileNames = updateFileList();
 
+    auto sortedNames = fileNames;
+    std::sort(sortedNames.begin(), sortedNames.end());
+    const auto hash = SyncState::hash(sortedNames);
+
+    if (onlyIfChanged && m_fileListPublished && hash == m_publishedFileListHash)
+    {
+        LOG(DEBUG) << "File list unchanged since last published";
+        return;
+    }
+
     std::shared_ptr<Message> message = m_protocol.makeFileListUpdateMessage(m_deviceKey, FileList{fileNames});
 
     if (!message)
@@ -482,7 +502,11 @@ void FileDownloadService::sendFileListUpdate()
         return;
     }
 
-    m_connectivityService.publish(message);
+    if (m_connectivityService.publish(message))
+    {
+        m_fileListPublished = true;
+        m_publishedFileListHash = hash;
+    }
 }
 
 void FileDownloadService::requestPacket(const FilePacketRequest& request)
@@ -65,6 +65,11 @@ public:
 
     virtual void sendFileList();
 
+    /**
+     * @brief Sends file list, unless it is the same as the one last published successfully
+     */
+    virtual void syncFileList();
+
 private:
     void handle(const BinaryData& binaryData);
     void handle(const FileUploadInitiate& request);
@@ -82,7 +87,7 @@ private:
 
     void sendStatus(const FileUploadStatus& response);
     void sendStatus(const FileUrlDownloadStatus& response);
-    void sendFileListUpdate();
+    void sendFileListUpdate(bool onlyIfChanged = false);
 
     void requestPacket(const FilePacketRequest& request);
     void downloadCompleted(const std::string& fileName, const std::string& filePath, const std::string& fileHash);
@@ -115,6 +120,10 @@ private:
     std::string m_activeDownload;
     std::map<std::string, std::tuple<std::string, std::unique_ptr<FileDownloader>, bool>> m_activeDownloads;
 
+    // file list last published successfully, used only from the command buffer
+    bool m_fileListPublished;
+    std::size_t m_publishedFileListHash;
+
     std::atomic_bool m_run;
     std::condition_variable m_condition;
     std::recursive_mutex m_mutex;
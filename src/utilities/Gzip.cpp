@@ -0,0 +1,112 @@
+/*
+ * Copyright 2020 WolkAbout Technology s.r.o.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "utilities/Gzip.h"
+
+#include <zlib.h>
+
+#include <cstring>
+
+namespace wolkabout
+{
+namespace
+{
+// zlib window bits, plus 16 for gzip header and trailer
+const int GZIP_WINDOW_BITS = 15 + 16;
+const int MEMORY_LEVEL = 8;
+}    // namespace
+
+const constexpr int Gzip::DEFAULT_LEVEL;
+
+bool Gzip::compress(const std::string& data, std::string& compressed, int level)
+{
+    compressed.clear();
+
+    z_stream stream;
+    std::memset(&stream, 0, sizeof(stream));
+
+    if (deflateInit2(&stream, level, Z_DEFLATED, GZIP_WINDOW_BITS, MEMORY_LEVEL, Z_DEFAULT_STRATEGY) != Z_OK)
+    {
+        return false;
+    }
+
+    compressed.resize(deflateBound(&stream, static_cast<uLong>(data.size())));
+
+    stream.next_in = reinterpret_cast<Bytef*>(const_cast<char*>(data.data()));
+    stream.avail_in = static_cast<uInt>(data.size());
+    stream.next_out = reinterpret_cast<Bytef*>(&compressed[0]);
+    stream.avail_out = static_cast<uInt>(compressed.size());
+
+    const auto result = deflate(&stream, Z_FINISH);
+    const auto size = stream.total_out;
+    deflateEnd(&stream);
+
+    if (result != Z_STREAM_END)
+    {
+        compressed.clear();
+        return false;
+    }
+
+    compressed.resize(size);
+    return true;
+}
+
+bool Gzip::decompress(const std::string& data, std::string& decompressed)
+{
+    decompressed.clear();
+
+    z_stream stream;
+    std::memset(&stream, 0, sizeof(stream));
+
+    if (inflateInit2(&stream, GZIP_WINDOW_BITS) != Z_OK)
+    {
+        return false;
+    }
+
+    stream.next_in = reinterpret_cast<Bytef*>(const_cast<char*>(data.data()));
+    stream.avail_in = static_cast<uInt>(data.size());
+
+    char buffer[4096];
+    int result = Z_OK;
+    while (result == Z_OK)
+    {
+        stream.next_out = reinterpret_cast<Bytef*>(buffer);
+        stream.avail_out = sizeof(buffer);
+
+        result = inflate(&stream, Z_NO_FLUSH);
+        if (result == Z_OK || result == Z_STREAM_END)
+        {
+            decompressed.append(buffer, sizeof(buffer) - stream.avail_out);
+        }
+    }
+
+    inflateEnd(&stream);
+
+    if (result != Z_STREAM_END)
+    {
+        decompressed.clear();
+        return false;
+    }
+
+    return true;
+}
+
+bool Gzip::isCompressed(const std::string& data)
+{
+    return data.size() >= 2 && static_cast<unsigned char>(data[0]) == 0x1f &&
+           static_cast<unsigned char>(data[1]) == 0x8b;
+}
+}    // namespace wolkabout
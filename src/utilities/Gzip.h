@@ -0,0 +1,52 @@
+/*
+ * Copyright 2020 WolkAbout Technology s.r.o.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef GZIP_H
+#define GZIP_H
+
+#include <string>
+
+namespace wolkabout
+{
+/**
+ * @brief Gzip (RFC 1952) encoding of payloads, through zlib
+ */
+class Gzip
+{
+public:
+    Gzip() = delete;
+
+    /**
+     * @param level zlib compression level, 1 (fastest) to 9 (smallest)
+     * @return false if data could not be compressed, in which case compressed is left empty
+     */
+    static bool compress(const std::string& data, std::string& compressed, int level = DEFAULT_LEVEL);
+
+    /**
+     * @return false if data is not valid gzip, in which case decompressed is left empty
+     */
+    static bool decompress(const std::string& data, std::string& decompressed);
+
+    /**
+     * @brief Checks for gzip magic bytes, which tell compressed payloads from plain ones
+     */
+    static bool isCompressed(const std::string& data);
+
+    static const constexpr int DEFAULT_LEVEL = 6;
+};
+}    // namespace wolkabout
+
+#endif    // GZIP_H
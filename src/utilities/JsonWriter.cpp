@@ -0,0 +1,267 @@
+/*
+ * Copyright 2020 WolkAbout Technology s.r.o.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "utilities/JsonWriter.h"
+
+#include <stdexcept>
+
+namespace wolkabout
+{
+namespace
+{
+const char HEX_DIGITS[] = "0123456789abcdef";
+}    // namespace
+
+const constexpr std::size_t JsonWriter::MAX_DEPTH;
+
+JsonWriter::JsonWriter(std::string& buffer) : m_buffer{buffer}, m_empty{0}, m_depth{0}, m_afterKey{false} {}
+
+JsonWriter& JsonWriter::beginObject()
+{
+    separate();
+    m_buffer.push_back('{');
+    push();
+    return *this;
+}
+
+JsonWriter& JsonWriter::endObject()
+{
+    pop();
+    m_buffer.push_back('}');
+    return *this;
+}
+
+JsonWriter& JsonWriter::beginArray()
+{
+    separate();
+    m_buffer.push_back('[');
+    push();
+    return *this;
+}
+
+JsonWriter& JsonWriter::endArray()
+{
+    pop();
+    m_buffer.push_back(']');
+    return *this;
+}
+
+JsonWriter& JsonWriter::key(const std::string& key)
+{
+    separate();
+    m_buffer.push_back('"');
+    writeEscaped(key);
+    m_buffer.append("\":", 2);
+    m_afterKey = true;
+    return *this;
+}
+
+JsonWriter& JsonWriter::value(const std::string& value)
+{
+    separate();
+    m_buffer.push_back('"');
+    writeEscaped(value);
+    m_buffer.push_back('"');
+    return *this;
+}
+
+JsonWriter& JsonWriter::value(std::uint64_t value)
+{
+    separate();
+    writeUnsigned(value);
+    return *this;
+}
+
+JsonWriter& JsonWriter::value(std::int64_t value)
+{
+    separate();
+    if (value < 0)
+    {
+        m_buffer.push_back('-');
+        writeUnsigned(0 - static_cast<std::uint64_t>(value));
+    }
+    else
+    {
+        writeUnsigned(static_cast<std::uint64_t>(value));
+    }
+    return *this;
+}
+
+JsonWriter& JsonWriter::value(bool value)
+{
+    separate();
+    if (value)
+    {
+        m_buffer.append("true", 4);
+    }
+    else
+    {
+        m_buffer.append("false", 5);
+    }
+    return *this;
+}
+
+JsonWriter& JsonWriter::null()
+{
+    separate();
+    m_buffer.append("null", 4);
+    return *this;
+}
+
+JsonWriter& JsonWriter::beginString()
+{
+    separate();
+    m_buffer.push_back('"');
+    return *this;
+}
+
+JsonWriter& JsonWriter::appendString(const std::string& part)
+{
+    writeEscaped(part);
+    return *this;
+}
+
+JsonWriter& JsonWriter::appendString(char character)
+{
+    const auto code = static_cast<unsigned char>(character);
+    if (code >= 0x20 && character != '"' && character != '\\')
+    {
+        m_buffer.push_back(character);
+    }
+    else
+    {
+        writeEscaped(std::string(1, character));
+    }
+    return *this;
+}
+
+JsonWriter& JsonWriter::endString()
+{
+    m_buffer.push_back('"');
+    return *this;
+}
+
+void JsonWriter::separate()
+{
+    if (m_afterKey)
+    {
+        m_afterKey = false;
+        return;
+    }
+
+    if (m_depth == 0)
+    {
+        return;
+    }
+
+    const auto bit = std::uint64_t{1} << (m_depth - 1);
+    if (m_empty & bit)
+    {
+        m_empty &= ~bit;
+    }
+    else
+    {
+        m_buffer.push_back(',');
+    }
+}
+
+void JsonWriter::push()
+{
+    if (m_depth == MAX_DEPTH)
+    {
+        throw std::length_error("JSON nesting is too deep");
+    }
+
+    m_empty |= std::uint64_t{1} << m_depth;
+    ++m_depth;
+}
+
+void JsonWriter::pop()
+{
+    if (m_depth == 0)
+    {
+        throw std::logic_error("JSON object or array is not open");
+    }
+
+    --m_depth;
+    m_empty &= ~(std::uint64_t{1} << m_depth);
+}
+
+void JsonWriter::writeEscaped(const std::string& value)
+{
+    std::size_t plainStart = 0;
+    for (std::size_t i = 0; i < value.size(); ++i)
+    {
+        const auto character = static_cast<unsigned char>(value[i]);
+        if (character >= 0x20 && character != '"' && character != '\\')
+        {
+            continue;
+        }
+
+        m_buffer.append(value, plainStart, i - plainStart);
+        plainStart = i + 1;
+
+        switch (character)
+        {
+        case '"':
+            m_buffer.append("\\\"", 2);
+            break;
+        case '\\':
+            m_buffer.append("\\\\", 2);
+            break;
+        case '\b':
+            m_buffer.append("\\b", 2);
+            break;
+        case '\f':
+            m_buffer.append("\\f", 2);
+            break;
+        case '\n':
+            m_buffer.append("\\n", 2);
+            break;
+        case '\r':
+            m_buffer.append("\\r", 2);
+            break;
+        case '\t':
+            m_buffer.append("\\t", 2);
+            break;
+        default:
+        {
+            const char escaped[] = {'\\', 'u', '0', '0', HEX_DIGITS[character >> 4], HEX_DIGITS[character & 0xf]};
+            m_buffer.append(escaped, sizeof(escaped));
+            break;
+        }
+        }
+    }
+
+    m_buffer.append(value, plainStart, value.size() - plainStart);
+}
+
+void JsonWriter::writeUnsigned(std::uint64_t value)
+{
+    char digits[20];
+    std::size_t count = 0;
+    do
+    {
+        digits[count++] = static_cast<char>('0' + value % 10);
+        value /= 10;
+    } while (value != 0);
+
+    while (count > 0)
+    {
+        m_buffer.push_back(digits[--count]);
+    }
+}
+}    // namespace wolkabout
@@ -0,0 +1,77 @@
+/*
+ * Copyright 2020 WolkAbout Technology s.r.o.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef JSONWRITER_H
+#define JSONWRITER_H
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+namespace wolkabout
+{
+/**
+ * @brief Appends compact JSON to a buffer, without building intermediate objects.<br>
+ *        Strings are escaped the same way nlohmann::json::dump does, and separators are inserted automatically.
+ *        Nesting depth is limited to 64 levels.
+ */
+class JsonWriter
+{
+public:
+    explicit JsonWriter(std::string& buffer);
+
+    JsonWriter& beginObject();
+    JsonWriter& endObject();
+
+    JsonWriter& beginArray();
+    JsonWriter& endArray();
+
+    JsonWriter& key(const std::string& key);
+
+    JsonWriter& value(const std::string& value);
+    JsonWriter& value(std::uint64_t value);
+    JsonWriter& value(std::int64_t value);
+    JsonWriter& value(bool value);
+    JsonWriter& null();
+
+    /**
+     * @brief Starts string value written in parts with appendString, such as joined values
+     */
+    JsonWriter& beginString();
+    JsonWriter& appendString(const std::string& part);
+    JsonWriter& appendString(char character);
+    JsonWriter& endString();
+
+    static const constexpr std::size_t MAX_DEPTH = 64;
+
+private:
+    void separate();
+    void push();
+    void pop();
+
+    void writeEscaped(const std::string& value);
+    void writeUnsigned(std::uint64_t value);
+
+    std::string& m_buffer;
+
+    // Bit per nesting level, set while no element has been written at that level
+    std::uint64_t m_empty;
+    std::size_t m_depth;
+    bool m_afterKey;
+};
+}    // namespace wolkabout
+
+#endif    // JSONWRITER_H
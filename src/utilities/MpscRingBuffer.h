@@ -0,0 +1,215 @@
+/*
+ * Copyright 2020 WolkAbout Technology s.r.o.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef MPSCRINGBUFFER_H
+#define MPSCRINGBUFFER_H
+
+#include <atomic>
+#include <cstddef>
+#include <memory>
+#include <utility>
+#include <vector>
+
+namespace wolkabout
+{
+/**
+ * @brief Bounded lock-free multi-producer/single-consumer ring buffer.<br>
+ *        Every cell carries a sequence number which tells producers whether the cell is free,
+ *        and the consumer whether the cell has been published. Producers only contend on a single
+ *        atomic counter, and the consumer never takes a lock.
+ */
+template <typename T> class MpscRingBuffer
+{
+public:
+    /**
+     * @param capacity Requested capacity, rounded up to the nearest power of two
+     */
+    explicit MpscRingBuffer(std::size_t capacity);
+
+    MpscRingBuffer(const MpscRingBuffer&) = delete;
+    MpscRingBuffer& operator=(const MpscRingBuffer&) = delete;
+
+    /**
+     * @brief Moves item into the buffer. Safe to call from multiple threads simultaneously.
+     * @return false if buffer is full, in which case item is left untouched
+     */
+    bool tryPush(T& item);
+
+    /**
+     * @brief Moves oldest item out of the buffer. Must only be called from the consumer thread.
+     * @return false if buffer is empty
+     */
+    bool tryPop(T& item);
+
+    /**
+     * @brief Moves up to maxItems oldest items to the back of items. Must only be called from the consumer thread.
+     * @return Number of items moved
+     */
+    std::size_t popBatch(std::vector<T>& items, std::size_t maxItems);
+
+    /**
+     * @brief Checks if there is an item ready to be consumed. Must only be called from the consumer thread.
+     */
+    bool empty() const;
+
+    /**
+     * @brief Approximate number of items in the buffer
+     */
+    std::size_t size() const;
+
+    std::size_t capacity() const;
+
+private:
+    struct Cell
+    {
+        std::atomic<std::size_t> sequence;
+        T data;
+    };
+
+    static std::size_t roundUpToPowerOfTwo(std::size_t value);
+
+    const std::size_t m_capacity;
+    const std::size_t m_mask;
+    std::unique_ptr<Cell[]> m_cells;
+
+    // Producer and consumer positions are padded apart, so they do not share a cache line
+    static const constexpr std::size_t CACHE_LINE_SIZE = 64;
+
+    char m_producerPadding[CACHE_LINE_SIZE];
+    std::atomic<std::size_t> m_enqueuePosition;
+    char m_consumerPadding[CACHE_LINE_SIZE];
+    std::atomic<std::size_t> m_dequeuePosition;
+};
+
+template <typename T>
+MpscRingBuffer<T>::MpscRingBuffer(std::size_t capacity)
+: m_capacity{roundUpToPowerOfTwo(capacity)}
+, m_mask{m_capacity - 1}
+, m_cells{new Cell[m_capacity]}
+, m_enqueuePosition{0}
+, m_dequeuePosition{0}
+{
+    for (std::size_t i = 0; i < m_capacity; ++i)
+    {
+        m_cells[i].sequence.store(i, std::memory_order_relaxed);
+    }
+}
+
+template <typename T> bool MpscRingBuffer<T>::tryPush(T& item)
+{
+    std::size_t position = m_enqueuePosition.load(std::memory_order_relaxed);
+
+    for (;;)
+    {
+        Cell& cell = m_cells[position & m_mask];
+        const std::size_t sequence = cell.sequence.load(std::memory_order_acquire);
+
+        if (sequence == position)
+        {
+            if (m_enqueuePosition.compare_exchange_weak(position, position + 1, std::memory_order_relaxed))
+            {
+                cell.data = std::move(item);
+                cell.sequence.store(position + 1, std::memory_order_release);
+                return true;
+            }
+        }
+        else if (sequence < position)
+        {
+            // cell still holds an item from the previous lap
+            return false;
+        }
+        else
+        {
+            position = m_enqueuePosition.load(std::memory_order_relaxed);
+        }
+    }
+}
+
+template <typename T> bool MpscRingBuffer<T>::tryPop(T& item)
+{
+    const std::size_t position = m_dequeuePosition.load(std::memory_order_relaxed);
+    Cell& cell = m_cells[position & m_mask];
+
+    if (cell.sequence.load(std::memory_order_acquire) != position + 1)
+    {
+        return false;
+    }
+
+    item = std::move(cell.data);
+    cell.data = T();
+    cell.sequence.store(position + m_capacity, std::memory_order_release);
+    m_dequeuePosition.store(position + 1, std::memory_order_relaxed);
+
+    return true;
+}
+
+template <typename T> std::size_t MpscRingBuffer<T>::popBatch(std::vector<T>& items, std::size_t maxItems)
+{
+    std::size_t count = 0;
+    std::size_t position = m_dequeuePosition.load(std::memory_order_relaxed);
+
+    while (count < maxItems)
+    {
+        Cell& cell = m_cells[position & m_mask];
+        if (cell.sequence.load(std::memory_order_acquire) != position + 1)
+        {
+            break;
+        }
+
+        items.push_back(std::move(cell.data));
+        cell.data = T();
+        cell.sequence.store(position + m_capacity, std::memory_order_release);
+
+        ++position;
+        ++count;
+    }
+
+    m_dequeuePosition.store(position, std::memory_order_relaxed);
+    return count;
+}
+
+template <typename T> bool MpscRingBuffer<T>::empty() const
+{
+    const std::size_t position = m_dequeuePosition.load(std::memory_order_relaxed);
+    return m_cells[position & m_mask].sequence.load(std::memory_order_seq_cst) != position + 1;
+}
+
+template <typename T> std::size_t MpscRingBuffer<T>::size() const
+{
+    const std::size_t dequeuePosition = m_dequeuePosition.load(std::memory_order_relaxed);
+    const std::size_t enqueuePosition = m_enqueuePosition.load(std::memory_order_relaxed);
+
+    return enqueuePosition > dequeuePosition ? enqueuePosition - dequeuePosition : 0;
+}
+
+template <typename T> std::size_t MpscRingBuffer<T>::capacity() const
+{
+    return m_capacity;
+}
+
+template <typename T> std::size_t MpscRingBuffer<T>::roundUpToPowerOfTwo(std::size_t value)
+{
+    std::size_t result = 2;
+    while (result < value)
+    {
+        result <<= 1;
+    }
+
+    return result;
+}
+}    // namespace wolkabout
+
+#endif    // MPSCRINGBUFFER_H
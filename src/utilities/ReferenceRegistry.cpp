@@ -0,0 +1,76 @@
+/*
+ * Copyright 2020 WolkAbout Technology s.r.o.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "utilities/ReferenceRegistry.h"
+
+namespace wolkabout
+{
+const constexpr std::uint32_t ReferenceHandle::INVALID_ID;
+
+ReferenceHandle ReferenceRegistry::intern(const std::string& reference)
+{
+    std::lock_guard<std::mutex> lock{m_mutex};
+
+    ReferenceHandle handle;
+
+    auto it = m_handles.find(reference);
+    if (it != m_handles.end())
+    {
+        handle.id = it->second;
+        return handle;
+    }
+
+    handle.id = static_cast<std::uint32_t>(m_references.size());
+
+    m_references.push_back(reference);
+    m_handles.emplace(reference, handle.id);
+
+    return handle;
+}
+
+bool ReferenceRegistry::find(const std::string& reference, ReferenceHandle& handle) const
+{
+    std::lock_guard<std::mutex> lock{m_mutex};
+
+    auto it = m_handles.find(reference);
+    if (it == m_handles.end())
+    {
+        return false;
+    }
+
+    handle.id = it->second;
+    return true;
+}
+
+std::string ReferenceRegistry::resolve(ReferenceHandle handle) const
+{
+    std::lock_guard<std::mutex> lock{m_mutex};
+
+    if (!handle.isValid() || handle.id >= m_references.size())
+    {
+        return "";
+    }
+
+    return m_references[handle.id];
+}
+
+std::size_t ReferenceRegistry::size() const
+{
+    std::lock_guard<std::mutex> lock{m_mutex};
+
+    return m_references.size();
+}
+}    // namespace wolkabout
@@ -0,0 +1,78 @@
+/*
+ * Copyright 2020 WolkAbout Technology s.r.o.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef REFERENCEREGISTRY_H
+#define REFERENCEREGISTRY_H
+
+#include <cstddef>
+#include <cstdint>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace wolkabout
+{
+/**
+ * @brief Small integer standing in for a sensor, or alarm, reference registered in wolkabout::ReferenceRegistry
+ */
+struct ReferenceHandle
+{
+    static const constexpr std::uint32_t INVALID_ID = UINT32_MAX;
+
+    std::uint32_t id = INVALID_ID;
+
+    bool isValid() const { return id != INVALID_ID; }
+
+    bool operator==(const ReferenceHandle& other) const { return id == other.id; }
+    bool operator!=(const ReferenceHandle& other) const { return id != other.id; }
+};
+
+/**
+ * @brief Interns references, mapping each of them to a dense ReferenceHandle.<br>
+ *        Handles are never released, so a handle stays valid for the lifetime of the registry.<br>
+ *        This class is thread safe.
+ */
+class ReferenceRegistry
+{
+public:
+    /**
+     * @brief Returns handle of the reference, registering it if it is not registered already
+     */
+    ReferenceHandle intern(const std::string& reference);
+
+    /**
+     * @brief Looks up handle of already registered reference
+     * @return false if reference is not registered
+     */
+    bool find(const std::string& reference, ReferenceHandle& handle) const;
+
+    /**
+     * @brief Returns reference the handle stands for, or empty string for unknown handles
+     */
+    std::string resolve(ReferenceHandle handle) const;
+
+    std::size_t size() const;
+
+private:
+    mutable std::mutex m_mutex;
+
+    std::unordered_map<std::string, std::uint32_t> m_handles;
+    std::vector<std::string> m_references;
+};
+}    // namespace wolkabout
+
+#endif    // REFERENCEREGISTRY_H
@@ -0,0 +1,53 @@
+/*
+ * Copyright 2020 WolkAbout Technology s.r.o.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "utilities/SyncState.h"
+
+#include <functional>
+
+namespace wolkabout
+{
+bool SyncState::hasChanged(const std::string& key, std::size_t hash) const
+{
+    std::lock_guard<std::mutex> lock{m_mutex};
+
+    const auto it = m_hashes.find(key);
+    return it == m_hashes.end() || it->second != hash;
+}
+
+void SyncState::acknowledged(const std::string& key, std::size_t hash)
+{
+    std::lock_guard<std::mutex> lock{m_mutex};
+    m_hashes[key] = hash;
+}
+
+void SyncState::invalidate()
+{
+    std::lock_guard<std::mutex> lock{m_mutex};
+    m_hashes.clear();
+}
+
+std::size_t SyncState::hash(const std::vector<std::string>& values)
+{
+    std::size_t seed = values.size();
+    for (const auto& value : values)
+    {
+        seed ^= std::hash<std::string>{}(value) + 0x9e3779b9 + (seed << 6) + (seed >> 2);
+    }
+
+    return seed;
+}
+}    // namespace wolkabout
@@ -0,0 +1,60 @@
+/*
+ * Copyright 2020 WolkAbout Technology s.r.o.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef SYNCSTATE_H
+#define SYNCSTATE_H
+
+#include <cstddef>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace wolkabout
+{
+/**
+ * @brief Hashes of state last acknowledged by the platform, per key, so state which did not change
+ *        while disconnected is not published again on reconnect.<br>
+ *        This class is thread safe.
+ */
+class SyncState
+{
+public:
+    /**
+     * @brief Returns whether hash differs from the one last acknowledged for the key, or none was acknowledged
+     */
+    bool hasChanged(const std::string& key, std::size_t hash) const;
+
+    void acknowledged(const std::string& key, std::size_t hash);
+
+    /**
+     * @brief Forgets all acknowledged state, so all of it is considered changed
+     */
+    void invalidate();
+
+    /**
+     * @brief Hash of values, in given order
+     */
+    static std::size_t hash(const std::vector<std::string>& values);
+
+private:
+    mutable std::mutex m_mutex;
+
+    std::unordered_map<std::string, std::size_t> m_hashes;
+};
+}    // namespace wolkabout
+
+#endif    // SYNCSTATE_H
@@ -0,0 +1,186 @@
+/*
+ * Copyright 2020 WolkAbout Technology s.r.o.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "ingestion/BufferLimiter.h"
+#include "model/ReadingValue.h"
+#include "model/SensorReading.h"
+#include "persistence/inmemory/InMemoryTypedPersistence.h"
+
+#include <gtest/gtest.h>
+
+#include <chrono>
+#include <memory>
+#include <thread>
+
+class BufferLimiterTests : public ::testing::Test
+{
+public:
+    std::shared_ptr<wolkabout::BufferLimiter> makeLimiter(wolkabout::OverflowPolicy policy)
+    {
+        wolkabout::BufferLimits limits;
+        limits.maxReadings = 3;
+        limits.policy = policy;
+        limits.blockTimeout = std::chrono::milliseconds{50};
+        limits.sampleStride = 2;
+
+        auto limiter = std::make_shared<wolkabout::BufferLimiter>(limits);
+        persistence.setBufferLimiter(limiter);
+
+        return limiter;
+    }
+
+    void add(wolkabout::BufferLimiter& limiter, int value)
+    {
+        if (limiter.admit())
+        {
+            persistence.putSensorReading("REF", wolkabout::ReadingValue{value}, 0);
+        }
+    }
+
+    std::vector<std::string> storedValues()
+    {
+        std::vector<std::string> values;
+        for (const auto& reading : persistence.getSensorReadings("REF", 100))
+        {
+            values.push_back(reading->getValue());
+        }
+
+        return values;
+    }
+
+    wolkabout::InMemoryTypedPersistence persistence;
+};
+
+TEST_F(BufferLimiterTests, DropOldest)
+{
+    auto limiter = makeLimiter(wolkabout::OverflowPolicy::DROP_OLDEST);
+
+    for (int i = 0; i < 5; ++i)
+    {
+        add(*limiter, i);
+    }
+
+    EXPECT_EQ((std::vector<std::string>{"2", "3", "4"}), storedValues());
+    EXPECT_EQ(3, limiter->getCount());
+    EXPECT_EQ(2, limiter->getDropStatistics().droppedOldest);
+    EXPECT_EQ(2, limiter->getDropStatistics().total());
+}
+
+TEST_F(BufferLimiterTests, DropNewest)
+{
+    auto limiter = makeLimiter(wolkabout::OverflowPolicy::DROP_NEWEST);
+
+    for (int i = 0; i < 5; ++i)
+    {
+        add(*limiter, i);
+    }
+
+    EXPECT_EQ((std::vector<std::string>{"0", "1", "2"}), storedValues());
+    EXPECT_EQ(2, limiter->getDropStatistics().droppedNewest);
+
+    // Published readings free up space
+    persistence.removeSensorReadings("REF", 2);
+    EXPECT_EQ(1, limiter->getCount());
+
+    add(*limiter, 5);
+    EXPECT_EQ((std::vector<std::string>{"2", "5"}), storedValues());
+}
+
+TEST_F(BufferLimiterTests, Sample)
+{
+    auto limiter = makeLimiter(wolkabout::OverflowPolicy::SAMPLE);
+
+    for (int i = 0; i < 7; ++i)
+    {
+        add(*limiter, i);
+    }
+
+    // Once full, every second reading is kept, replacing the oldest one
+    EXPECT_EQ((std::vector<std::string>{"2", "3", "5"}), storedValues());
+    EXPECT_EQ(2, limiter->getDropStatistics().sampledOut);
+    EXPECT_EQ(2, limiter->getDropStatistics().droppedOldest);
+}
+
+TEST_F(BufferLimiterTests, BlockWithTimeout)
+{
+    auto limiter = makeLimiter(wolkabout::OverflowPolicy::BLOCK);
+
+    for (int i = 0; i < 4; ++i)
+    {
+        add(*limiter, i);
+    }
+
+    EXPECT_EQ((std::vector<std::string>{"0", "1", "2"}), storedValues());
+    EXPECT_EQ(1, limiter->getDropStatistics().blockTimedOut);
+
+    std::thread publisher{[&] {
+        std::this_thread::sleep_for(std::chrono::milliseconds{10});
+        persistence.removeSensorReadings("REF", 1);
+    }};
+
+    EXPECT_TRUE(limiter->admit());
+    publisher.join();
+
+    EXPECT_EQ(1, limiter->getDropStatistics().blockTimedOut);
+}
+
+TEST_F(BufferLimiterTests, ByteLimit)
+{
+    wolkabout::BufferLimits limits;
+    limits.maxBytes = 1000;
+    limits.policy = wolkabout::OverflowPolicy::DROP_OLDEST;
+
+    auto limiter = std::make_shared<wolkabout::BufferLimiter>(limits);
+    persistence.setBufferLimiter(limiter);
+
+    for (int i = 0; i < 100; ++i)
+    {
+        add(*limiter, i);
+    }
+
+    EXPECT_LE(limiter->getBytes(), limits.maxBytes);
+    EXPECT_GT(limiter->getDropStatistics().droppedOldest, 0);
+    EXPECT_EQ(limiter->getCount(), persistence.getSensorReadings("REF", 1000).size());
+
+    persistence.removeSensorReadings("REF", 1000);
+    EXPECT_EQ(0, limiter->getCount());
+    EXPECT_EQ(0, limiter->getBytes());
+}
+
+TEST_F(BufferLimiterTests, EvictionSparesReadingsInFlight)
+{
+    auto limiter = makeLimiter(wolkabout::OverflowPolicy::DROP_OLDEST);
+
+    for (int i = 0; i < 3; ++i)
+    {
+        add(*limiter, i);
+    }
+
+    // Oldest two readings are being published
+    ASSERT_EQ(2, persistence.getSensorReadings("REF", 2).size());
+
+    add(*limiter, 3);
+    add(*limiter, 4);
+
+    // Eviction skipped readings in flight
+    EXPECT_EQ((std::vector<std::string>{"0", "1", "4"}), storedValues());
+    EXPECT_EQ(2, limiter->getDropStatistics().droppedOldest);
+
+    // so removing the published ones removes exactly them
+    persistence.removeSensorReadings("REF", 2);
+    EXPECT_EQ((std::vector<std::string>{"4"}), storedValues());
+    EXPECT_EQ(1, limiter->getCount());
+}
@@ -0,0 +1,237 @@
+/*
+ * Copyright 2020 WolkAbout Technology s.r.o.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "model/ActuatorGetCommand.h"
+#include "model/ActuatorSetCommand.h"
+#include "model/ActuatorStatus.h"
+#include "model/Alarm.h"
+#include "model/ConfigurationItem.h"
+#include "model/ConfigurationSetCommand.h"
+#include "model/Message.h"
+#include "model/SensorReading.h"
+#include "protocol/cbor/CborProtocol.h"
+#include "protocol/cbor/CborReader.h"
+#include "protocol/cbor/CborWriter.h"
+
+#include <gtest/gtest.h>
+
+#include <cstdint>
+#include <limits>
+#include <memory>
+#include <string>
+#include <vector>
+
+class CborProtocolTests : public ::testing::Test
+{
+public:
+    wolkabout::CborProtocol protocol;
+};
+
+TEST_F(CborProtocolTests, IntegersAreEncodedInShortestForm)
+{
+    std::string payload;
+    wolkabout::CborWriter writer{payload};
+
+    writer.writeUnsigned(23);
+    writer.writeUnsigned(24);
+    writer.writeSigned(-500);
+    writer.writeUnsigned(1600000000000);
+    writer.writeSigned(std::numeric_limits<std::int64_t>::min());
+
+    EXPECT_EQ(std::string("\x17\x18\x18\x39\x01\xf3\x1b\x00\x00\x01\x74\x87\x6e\x80\x00", 15),
+              payload.substr(0, 15));
+
+    wolkabout::CborReader reader{payload};
+    std::uint64_t unsignedValue;
+    std::int64_t signedValue;
+
+    ASSERT_TRUE(reader.readUnsigned(unsignedValue));
+    EXPECT_EQ(23u, unsignedValue);
+    ASSERT_TRUE(reader.readUnsigned(unsignedValue));
+    EXPECT_EQ(24u, unsignedValue);
+    EXPECT_FALSE(reader.readUnsigned(unsignedValue));
+    ASSERT_TRUE(reader.readSigned(signedValue));
+    EXPECT_EQ(-500, signedValue);
+    ASSERT_TRUE(reader.readUnsigned(unsignedValue));
+    EXPECT_EQ(1600000000000u, unsignedValue);
+    ASSERT_TRUE(reader.readSigned(signedValue));
+    EXPECT_EQ(std::numeric_limits<std::int64_t>::min(), signedValue);
+    EXPECT_TRUE(reader.atEnd());
+}
+
+TEST_F(CborProtocolTests, SensorReadingsRoundTrip)
+{
+    const std::vector<std::shared_ptr<wolkabout::SensorReading>> sensorReadings{
+      std::make_shared<wolkabout::SensorReading>("23.5", "T", 1600000000000),
+      std::make_shared<wolkabout::SensorReading>("-17", "P", 1600000000100),
+      std::make_shared<wolkabout::SensorReading>("23.45678901234", "T", 1600000001000),
+      std::make_shared<wolkabout::SensorReading>("text value", "S", 1600000000500),
+      std::make_shared<wolkabout::SensorReading>(std::vector<std::string>{"1", "2.50", "true"}, "ACL", 1599999999000),
+      std::make_shared<wolkabout::SensorReading>("007", "P", 1600000000200),
+      std::make_shared<wolkabout::SensorReading>("", "S", 1600000000600),
+      std::make_shared<wolkabout::SensorReading>("1e+20", "T", 1600000000900),
+      std::make_shared<wolkabout::SensorReading>("-0.0", "S", 1600000000700),
+      std::make_shared<wolkabout::SensorReading>("0.005", "P", 1600000000300),
+      std::make_shared<wolkabout::SensorReading>("-3.000", "P", 1600000000400)};
+
+    const auto message = protocol.makeMessage("KEY", sensorReadings);
+    ASSERT_NE(nullptr, message);
+    EXPECT_EQ("d2p/cbor/sensor_reading/d/KEY", message->getChannel());
+
+    const auto parsed = protocol.parseSensorReadings(*message);
+    ASSERT_EQ(sensorReadings.size(), parsed.size());
+
+    // Readings are grouped by reference, in order of first appearance
+    const std::vector<std::size_t> order{0, 2, 7, 1, 5, 9, 10, 3, 6, 8, 4};
+    for (std::size_t i = 0; i < order.size(); ++i)
+    {
+        const auto& expected = *sensorReadings[order[i]];
+        EXPECT_EQ(expected.getReference(), parsed[i]->getReference());
+        EXPECT_EQ(expected.getValues(), parsed[i]->getValues());
+        EXPECT_EQ(expected.getRtc(), parsed[i]->getRtc());
+    }
+}
+
+TEST_F(CborProtocolTests, SensorReadingsAreSmallerThanJson)
+{
+    std::vector<std::shared_ptr<wolkabout::SensorReading>> sensorReadings;
+    std::size_t jsonSize = 0;
+    for (unsigned long long i = 0; i < 100; ++i)
+    {
+        const auto value = std::to_string(20 + i % 10) + ".25";
+        sensorReadings.push_back(std::make_shared<wolkabout::SensorReading>(value, "TEMPERATURE", 1600000000000 + i));
+
+        // {"utc":1600000000000,"data":"20.25"},
+        jsonSize += 31 + value.size();
+    }
+
+    const auto message = protocol.makeMessage("KEY", sensorReadings);
+    ASSERT_NE(nullptr, message);
+
+    EXPECT_LT(message->getContent().size() * 4, jsonSize);
+}
+
+TEST_F(CborProtocolTests, AlarmsRoundTrip)
+{
+    const std::vector<std::shared_ptr<wolkabout::Alarm>> alarms{
+      std::make_shared<wolkabout::Alarm>(true, "HIGH", 1600000000000),
+      std::make_shared<wolkabout::Alarm>(false, "HIGH", 1600000005000),
+      std::make_shared<wolkabout::Alarm>(true, "LOW", 1500000000000)};
+
+    const auto message = protocol.makeMessage("KEY", alarms);
+    ASSERT_NE(nullptr, message);
+    EXPECT_EQ("d2p/cbor/events/d/KEY", message->getChannel());
+
+    const auto parsed = protocol.parseAlarms(*message);
+    ASSERT_EQ(3u, parsed.size());
+    for (std::size_t i = 0; i < alarms.size(); ++i)
+    {
+        EXPECT_EQ(alarms[i]->getReference(), parsed[i]->getReference());
+        EXPECT_EQ(alarms[i]->getValue(), parsed[i]->getValue());
+        EXPECT_EQ(alarms[i]->getRtc(), parsed[i]->getRtc());
+    }
+}
+
+TEST_F(CborProtocolTests, ActuatorStatusesAndConfigurationRoundTrip)
+{
+    const std::vector<std::shared_ptr<wolkabout::ActuatorStatus>> actuatorStatuses{
+      std::make_shared<wolkabout::ActuatorStatus>("65", "SL", wolkabout::ActuatorStatus::State::BUSY),
+      std::make_shared<wolkabout::ActuatorStatus>("false", "SW", wolkabout::ActuatorStatus::State::READY)};
+
+    const auto statusMessage = protocol.makeMessage("KEY", actuatorStatuses);
+    ASSERT_NE(nullptr, statusMessage);
+    EXPECT_EQ("d2p/cbor/actuator_status/d/KEY", statusMessage->getChannel());
+
+    const auto parsedStatuses = protocol.parseActuatorStatuses(*statusMessage);
+    ASSERT_EQ(2u, parsedStatuses.size());
+    for (std::size_t i = 0; i < actuatorStatuses.size(); ++i)
+    {
+        EXPECT_EQ(actuatorStatuses[i]->getReference(), parsedStatuses[i]->getReference());
+        EXPECT_EQ(actuatorStatuses[i]->getValue(), parsedStatuses[i]->getValue());
+        EXPECT_EQ(actuatorStatuses[i]->getState(), parsedStatuses[i]->getState());
+    }
+
+    const std::vector<wolkabout::ConfigurationItem> configuration{
+      wolkabout::ConfigurationItem({"INFO"}, "LOG_LEVEL"), wolkabout::ConfigurationItem({"5", "3.5", "x"}, "LIMITS")};
+
+    const auto configurationMessage = protocol.makeMessage("KEY", configuration);
+    ASSERT_NE(nullptr, configurationMessage);
+    EXPECT_EQ("d2p/cbor/configuration_get/d/KEY", configurationMessage->getChannel());
+
+    const auto parsedConfiguration = protocol.parseConfiguration(*configurationMessage);
+    ASSERT_EQ(2u, parsedConfiguration.size());
+    for (std::size_t i = 0; i < configuration.size(); ++i)
+    {
+        EXPECT_EQ(configuration[i].getReference(), parsedConfiguration[i].getReference());
+        EXPECT_EQ(configuration[i].getValues(), parsedConfiguration[i].getValues());
+    }
+}
+
+TEST_F(CborProtocolTests, InboundCommands)
+{
+    EXPECT_EQ(std::vector<std::string>({"p2d/cbor/actuator_set/d/KEY/r/#", "p2d/cbor/actuator_get/d/KEY/r/#",
+                                        "p2d/cbor/configuration_set/d/KEY", "p2d/cbor/configuration_get/d/KEY"}),
+              protocol.getInboundChannelsForDevice("KEY"));
+
+    std::string value;
+    wolkabout::CborWriter{value}.writeDouble(12.5);
+
+    const wolkabout::Message actuatorSet{value, "p2d/cbor/actuator_set/d/KEY/r/SL"};
+    EXPECT_TRUE(protocol.isActuatorSetMessage(actuatorSet));
+    EXPECT_FALSE(protocol.isActuatorGetMessage(actuatorSet));
+    EXPECT_EQ("KEY", protocol.extractDeviceKeyFromChannel(actuatorSet.getChannel()));
+
+    const auto setCommand = protocol.makeActuatorSetCommand(actuatorSet);
+    ASSERT_NE(nullptr, setCommand);
+    EXPECT_EQ("SL", setCommand->getReference());
+    EXPECT_EQ("12.5", setCommand->getValue());
+
+    const auto getCommand = protocol.makeActuatorGetCommand({"", "p2d/cbor/actuator_get/d/KEY/r/SW"});
+    ASSERT_NE(nullptr, getCommand);
+    EXPECT_EQ("SW", getCommand->getReference());
+
+    std::string configuration;
+    wolkabout::CborWriter writer{configuration};
+    writer.startMap(1);
+    writer.writeText("LOG_LEVEL");
+    writer.writeText("DEBUG");
+
+    const wolkabout::Message configurationSet{configuration, "p2d/cbor/configuration_set/d/KEY"};
+    EXPECT_TRUE(protocol.isConfigurationSetMessage(configurationSet));
+
+    const auto configurationCommand = protocol.makeConfigurationSetCommand(configurationSet);
+    ASSERT_NE(nullptr, configurationCommand);
+    ASSERT_EQ(1u, configurationCommand->getValues().size());
+    EXPECT_EQ("LOG_LEVEL", configurationCommand->getValues()[0].getReference());
+    EXPECT_EQ(std::vector<std::string>{"DEBUG"}, configurationCommand->getValues()[0].getValues());
+}
+
+TEST_F(CborProtocolTests, MalformedPayloadsAreRejected)
+{
+    const auto message = protocol.makeMessage(
+      "KEY", std::vector<std::shared_ptr<wolkabout::SensorReading>>{
+               std::make_shared<wolkabout::SensorReading>("text", "REF", 1600000000000)});
+    ASSERT_NE(nullptr, message);
+
+    const auto& content = message->getContent();
+    for (std::size_t size = 0; size < content.size(); ++size)
+    {
+        EXPECT_TRUE(protocol.parseSensorReadings({content.substr(0, size), message->getChannel()}).empty());
+    }
+
+    EXPECT_EQ(nullptr, protocol.makeActuatorSetCommand({"\x7f", "p2d/cbor/actuator_set/d/KEY/r/SL"}));
+    EXPECT_EQ(nullptr, protocol.makeConfigurationSetCommand({"\x01", "p2d/cbor/configuration_set/d/KEY"}));
+}
@@ -0,0 +1,180 @@
+/*
+ * Copyright 2020 WolkAbout Technology s.r.o.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "connectivity/ConnectionManager.h"
+
+#include <gtest/gtest.h>
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <mutex>
+#include <thread>
+
+class ConnectionManagerTests : public ::testing::Test
+{
+public:
+    void onConnected()
+    {
+        std::lock_guard<std::mutex> lock{mutex};
+        ++connections;
+        condition.notify_all();
+    }
+
+    bool waitConnections(int count)
+    {
+        std::unique_lock<std::mutex> lock{mutex};
+        return condition.wait_for(lock, std::chrono::seconds(5), [&] { return connections >= count; });
+    }
+
+    std::mutex mutex;
+    std::condition_variable condition;
+    int connections = 0;
+};
+
+TEST_F(ConnectionManagerTests, BackoffGrowsExponentiallyUpToMaxInterval)
+{
+    wolkabout::ReconnectPolicy policy;
+    policy.initialInterval = std::chrono::milliseconds{100};
+    policy.maxInterval = std::chrono::milliseconds{1000};
+    policy.multiplier = 2.0;
+
+    wolkabout::ConnectionManager manager{policy, [] { return false; }, [] {}};
+
+    EXPECT_EQ(100, manager.getBackoffInterval(0).count());
+    EXPECT_EQ(200, manager.getBackoffInterval(1).count());
+    EXPECT_EQ(400, manager.getBackoffInterval(2).count());
+    EXPECT_EQ(800, manager.getBackoffInterval(3).count());
+    EXPECT_EQ(1000, manager.getBackoffInterval(4).count());
+    EXPECT_EQ(1000, manager.getBackoffInterval(1000).count());
+}
+
+TEST_F(ConnectionManagerTests, InvalidPolicyFallsBackToDefaults)
+{
+    const wolkabout::ReconnectPolicy defaults;
+
+    wolkabout::ReconnectPolicy policy;
+    policy.initialInterval = std::chrono::milliseconds{0};
+    policy.maxInterval = std::chrono::milliseconds{0};
+    policy.multiplier = 0.5;
+
+    wolkabout::ConnectionManager manager{policy, [] { return false; }, [] {}};
+
+    EXPECT_EQ(defaults.initialInterval, manager.getBackoffInterval(0));
+    EXPECT_EQ(defaults.initialInterval, manager.getBackoffInterval(10));
+
+    policy.initialInterval = std::chrono::milliseconds{100};
+    policy.maxInterval = std::chrono::milliseconds{1000};
+    policy.multiplier = -1;
+
+    wolkabout::ConnectionManager shrinking{policy, [] { return false; }, [] {}};
+
+    EXPECT_EQ(100, shrinking.getBackoffInterval(0).count());
+    EXPECT_EQ(200, shrinking.getBackoffInterval(1).count());
+}
+
+TEST_F(ConnectionManagerTests, ConnectDoesNotBlockCaller)
+{
+    std::atomic_bool release{false};
+
+    wolkabout::ConnectionManager manager{wolkabout::ReconnectPolicy{},
+                                         [&] {
+                                             while (!release)
+                                             {
+                                                 std::this_thread::sleep_for(std::chrono::milliseconds{1});
+                                             }
+                                             return true;
+                                         },
+                                         [&] { onConnected(); }};
+
+    const auto start = std::chrono::steady_clock::now();
+    manager.connect();
+    EXPECT_LT(std::chrono::steady_clock::now() - start, std::chrono::milliseconds{100});
+
+    while (manager.getState() != wolkabout::ConnectionManager::State::CONNECTING)
+    {
+        std::this_thread::yield();
+    }
+
+    release = true;
+    EXPECT_TRUE(waitConnections(1));
+    EXPECT_EQ(wolkabout::ConnectionManager::State::CONNECTED, manager.getState());
+}
+
+TEST_F(ConnectionManagerTests, RetriesWithBackoffUntilConnected)
+{
+    wolkabout::ReconnectPolicy policy;
+    policy.initialInterval = std::chrono::milliseconds{1};
+    policy.maxInterval = std::chrono::milliseconds{4};
+
+    std::atomic_int attempts{0};
+    wolkabout::ConnectionManager manager{policy, [&] { return ++attempts > 3; }, [&] { onConnected(); }};
+
+    manager.connect();
+
+    EXPECT_TRUE(waitConnections(1));
+    EXPECT_EQ(4, attempts);
+    EXPECT_EQ(0, manager.getFailedAttempts());
+}
+
+TEST_F(ConnectionManagerTests, ReconnectsOnceConnectionIsLost)
+{
+    wolkabout::ReconnectPolicy policy;
+    policy.initialInterval = std::chrono::milliseconds{1};
+
+    std::atomic_int attempts{0};
+    wolkabout::ConnectionManager manager{policy, [&] { return ++attempts != 2; }, [&] { onConnected(); }};
+
+    // lost connection is ignored until connected
+    manager.connectionLost();
+    EXPECT_EQ(wolkabout::ConnectionManager::State::DISCONNECTED, manager.getState());
+
+    manager.connect();
+    EXPECT_TRUE(waitConnections(1));
+
+    manager.connectionLost();
+    EXPECT_TRUE(waitConnections(2));
+    EXPECT_EQ(3, attempts);
+}
+
+TEST_F(ConnectionManagerTests, DisconnectStopsAttempts)
+{
+    wolkabout::ReconnectPolicy policy;
+    policy.initialInterval = std::chrono::milliseconds{1};
+    policy.maxInterval = std::chrono::milliseconds{1};
+
+    std::atomic_int attempts{0};
+    wolkabout::ConnectionManager manager{policy,
+                                         [&] {
+                                             ++attempts;
+                                             return false;
+                                         },
+                                         [&] { onConnected(); }};
+
+    manager.connect();
+    while (attempts < 3)
+    {
+        std::this_thread::yield();
+    }
+
+    manager.disconnect();
+    const int stoppedAt = attempts;
+    EXPECT_EQ(wolkabout::ConnectionManager::State::DISCONNECTED, manager.getState());
+
+    std::this_thread::sleep_for(std::chrono::milliseconds{50});
+    EXPECT_EQ(stoppedAt, attempts);
+    EXPECT_EQ(0, connections);
+}
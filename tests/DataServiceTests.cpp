@@ -20,10 +20,14 @@
 #include "model/ActuatorSetCommand.h"
 #include "model/ConfigurationSetCommand.h"
 #include "model/Message.h"
+#include "model/SensorReading.h"
 #include "service/data/DataService.h"
+#include "service/data/PayloadSizeEstimator.h"
 #undef private
 #undef protected
 
+#include "ingestion/IngestionQueue.h"
+
 #include "mocks/ConnectivityServiceMock.h"
 #include "mocks/DataProtocolMock.h"
 #include "mocks/PersistenceMock.h"
@@ -31,8 +35,18 @@
 #include <gmock/gmock.h>
 #include <gtest/gtest.h>
 
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <functional>
 #include <iostream>
+#include <map>
 #include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
 
 class DataServiceTests : public ::testing::Test
 {
@@ -192,6 +206,65 @@ TEST_F(DataServiceTests, PersistenceAddingTests)
     EXPECT_NO_THROW(dataService->addConfiguration(std::vector<wolkabout::ConfigurationItem>{}));
 }
 
+TEST_F(DataServiceTests, TypedReadingIsFormattedForPlainPersistence)
+{
+    const auto& key = "TEST_DEVICE_KEY";
+    std::unique_ptr<wolkabout::DataService> dataService;
+    EXPECT_NO_THROW(
+      dataService = std::unique_ptr<wolkabout::DataService>(new wolkabout::DataService(
+        key, *dataProtocolMock, *persistenceMock, *connectivityServiceMock, nullptr, nullptr, nullptr, nullptr)));
+
+    std::shared_ptr<wolkabout::SensorReading> reading;
+    EXPECT_CALL(*persistenceMock, putSensorReading("TEST_REF", _)).WillOnce(DoAll(SaveArg<1>(&reading), Return(true)));
+    EXPECT_NO_THROW(dataService->addSensorReading("TEST_REF", wolkabout::ReadingValue{12.5}, 100));
+
+    ASSERT_TRUE(reading);
+    EXPECT_EQ(wolkabout::StringUtils::toString(12.5), reading->getValue());
+    EXPECT_EQ("TEST_REF", reading->getReference());
+    EXPECT_EQ(100, reading->getRtc());
+
+    EXPECT_CALL(*persistenceMock, putSensorReading("TEST_REF", _)).WillOnce(DoAll(SaveArg<1>(&reading), Return(true)));
+    EXPECT_NO_THROW(dataService->addSensorReading("TEST_REF", wolkabout::ReadingValue{std::vector<int>{1, 2}}, 100));
+
+    ASSERT_TRUE(reading);
+    EXPECT_EQ((std::vector<std::string>{"1", "2"}), reading->getValues());
+}
+
+TEST_F(DataServiceTests, ReadingBatchIsStoredPerReadingForPlainPersistence)
+{
+    const auto& key = "TEST_DEVICE_KEY";
+    std::unique_ptr<wolkabout::DataService> dataService;
+    EXPECT_NO_THROW(
+      dataService = std::unique_ptr<wolkabout::DataService>(new wolkabout::DataService(
+        key, *dataProtocolMock, *persistenceMock, *connectivityServiceMock, nullptr, nullptr, nullptr, nullptr)));
+
+    EXPECT_CALL(*persistenceMock, putSensorReading("TEST_REF1", _)).WillOnce(Return(true));
+    EXPECT_CALL(*persistenceMock, putSensorReading("TEST_REF2", _)).WillOnce(Return(true));
+    EXPECT_NO_THROW(dataService->addSensorReadings({{"TEST_REF1", 1, 100}, {"TEST_REF2", 2, 100}}));
+}
+
+TEST_F(DataServiceTests, HandlesAreResolvedForPlainPersistence)
+{
+    const auto& key = "TEST_DEVICE_KEY";
+    std::unique_ptr<wolkabout::DataService> dataService;
+    EXPECT_NO_THROW(
+      dataService = std::unique_ptr<wolkabout::DataService>(new wolkabout::DataService(
+        key, *dataProtocolMock, *persistenceMock, *connectivityServiceMock, nullptr, nullptr, nullptr, nullptr)));
+
+    const auto sensor = dataService->registerReference("TEST_REF");
+    const auto alarm = dataService->registerReference("TEST_ALARM_REF");
+
+    EXPECT_CALL(*persistenceMock, putSensorReading("TEST_REF", _)).WillOnce(Return(true));
+    EXPECT_NO_THROW(dataService->addSensorReading(sensor, wolkabout::ReadingValue{1}, 100));
+
+    EXPECT_CALL(*persistenceMock, putAlarm("TEST_ALARM_REF", _)).WillOnce(Return(true));
+    EXPECT_NO_THROW(dataService->addAlarm(alarm, true, 100));
+
+    // Unknown handles are dropped
+    EXPECT_CALL(*persistenceMock, putSensorReading).Times(0);
+    EXPECT_NO_THROW(dataService->addSensorReading(wolkabout::ReferenceHandle{}, wolkabout::ReadingValue{1}, 100));
+}
+
 TEST_F(DataServiceTests, PublishingSensorsTests)
 {
     const auto& key = "TEST_DEVICE_KEY";
@@ -227,6 +300,615 @@ TEST_F(DataServiceTests, PublishingSensorsTests)
     EXPECT_NO_THROW(dataService->publishSensorReadings());
 }
 
+TEST_F(DataServiceTests, PublishingSensorsReportsCounts)
+{
+    const auto& key = "TEST_DEVICE_KEY";
+    std::unique_ptr<wolkabout::DataService> dataService;
+    EXPECT_NO_THROW(
+      dataService = std::unique_ptr<wolkabout::DataService>(new wolkabout::DataService(
+        key, *dataProtocolMock, *persistenceMock, *connectivityServiceMock, nullptr, nullptr, nullptr, nullptr)));
+
+    const auto& readings = std::vector<std::shared_ptr<wolkabout::SensorReading>>{
+      std::make_shared<wolkabout::SensorReading>("VALUE1", "REF1", 0),
+      std::make_shared<wolkabout::SensorReading>("VALUE2", "REF1", 0)};
+
+    EXPECT_CALL(*persistenceMock, getSensorReadingsKeys).WillOnce(Return(std::vector<std::string>{"KEY1"}));
+    EXPECT_CALL(*persistenceMock, getSensorReadings).WillRepeatedly(Return(readings));
+    EXPECT_CALL(*dataProtocolMock, makeMessage(key, readings))
+      .WillRepeatedly(Invoke([](const std::string&, const std::vector<std::shared_ptr<wolkabout::SensorReading>>&) {
+          return std::unique_ptr<wolkabout::Message>(new wolkabout::Message("HELLO", "HELLO"));
+      }));
+
+    // First batch goes out, second one fails
+    EXPECT_CALL(*connectivityServiceMock, publish).WillOnce(Return(true)).WillOnce(Return(false));
+
+    wolkabout::PublishCounts counts;
+    EXPECT_NO_THROW(counts = dataService->publishSensorReadings());
+    EXPECT_EQ(2, counts.sent);
+    EXPECT_EQ(2, counts.remaining);
+}
+
+TEST_F(DataServiceTests, PublishingSensorsPacksReferences)
+{
+    const auto& key = "TEST_DEVICE_KEY";
+    std::unique_ptr<wolkabout::DataService> dataService;
+    EXPECT_NO_THROW(
+      dataService = std::unique_ptr<wolkabout::DataService>(new wolkabout::DataService(
+        key, *dataProtocolMock, *persistenceMock, *connectivityServiceMock, nullptr, nullptr, nullptr, nullptr)));
+    dataService->setPublishBatching(3, true);
+
+    std::map<std::string, std::vector<std::shared_ptr<wolkabout::SensorReading>>> persisted{
+      {"REF1",
+       {std::make_shared<wolkabout::SensorReading>("1", "REF1", 0),
+        std::make_shared<wolkabout::SensorReading>("2", "REF1", 0)}},
+      {"REF2",
+       {std::make_shared<wolkabout::SensorReading>("3", "REF2", 0),
+        std::make_shared<wolkabout::SensorReading>("4", "REF2", 0)}},
+      {"REF3", {std::make_shared<wolkabout::SensorReading>("5", "REF3", 0)}}};
+
+    EXPECT_CALL(*persistenceMock, getSensorReadingsKeys)
+      .WillOnce(Return(std::vector<std::string>{"REF1", "REF2", "REF3"}));
+    EXPECT_CALL(*persistenceMock, getSensorReadings)
+      .WillRepeatedly(Invoke([&](const std::string& reference, std::uint_fast64_t count) {
+          const auto& readings = persisted[reference];
+          return std::vector<std::shared_ptr<wolkabout::SensorReading>>(
+            readings.begin(), readings.begin() + std::min<std::uint_fast64_t>(count, readings.size()));
+      }));
+    EXPECT_CALL(*persistenceMock, removeSensorReadings)
+      .WillRepeatedly(Invoke([&](const std::string& reference, std::uint_fast64_t count) {
+          auto& readings = persisted[reference];
+          readings.erase(readings.begin(), readings.begin() + count);
+      }));
+
+    std::vector<std::size_t> batchSizes;
+    EXPECT_CALL(*dataProtocolMock, makeMessage(key, A<const std::vector<std::shared_ptr<wolkabout::SensorReading>>&>()))
+      .WillRepeatedly(
+        Invoke([&](const std::string&, const std::vector<std::shared_ptr<wolkabout::SensorReading>>& readings) {
+            batchSizes.push_back(readings.size());
+            return std::unique_ptr<wolkabout::Message>(new wolkabout::Message("HELLO", "HELLO"));
+        }));
+    EXPECT_CALL(*connectivityServiceMock, publish).WillRepeatedly(Return(true));
+
+    wolkabout::PublishCounts counts;
+    EXPECT_NO_THROW(counts = dataService->publishSensorReadings());
+    EXPECT_EQ(5, counts.sent);
+    EXPECT_EQ(0, counts.remaining);
+    EXPECT_EQ(2, counts.messages);
+    EXPECT_EQ((std::vector<std::size_t>{3, 2}), batchSizes);
+}
+
+TEST_F(DataServiceTests, PublishingSensorsKeepsPayloadSize)
+{
+    class FixedSizeEstimator : public wolkabout::PayloadSizeEstimator
+    {
+    public:
+        using wolkabout::PayloadSizeEstimator::estimate;
+        std::size_t estimate(const wolkabout::SensorReading&) const override { return 10; }
+    };
+
+    const auto& key = "TEST_DEVICE_KEY";
+    std::unique_ptr<wolkabout::DataService> dataService;
+    EXPECT_NO_THROW(
+      dataService = std::unique_ptr<wolkabout::DataService>(new wolkabout::DataService(
+        key, *dataProtocolMock, *persistenceMock, *connectivityServiceMock, nullptr, nullptr, nullptr, nullptr)));
+    dataService->setMaxPayloadSize(25, std::make_shared<FixedSizeEstimator>());
+
+    std::vector<std::shared_ptr<wolkabout::SensorReading>> persisted{
+      std::make_shared<wolkabout::SensorReading>("1", "REF1", 0),
+      std::make_shared<wolkabout::SensorReading>("2", "REF1", 0),
+      std::make_shared<wolkabout::SensorReading>("3", "REF1", 0)};
+
+    EXPECT_CALL(*persistenceMock, getSensorReadingsKeys).WillOnce(Return(std::vector<std::string>{"REF1"}));
+    EXPECT_CALL(*persistenceMock, getSensorReadings)
+      .WillRepeatedly(Invoke([&](const std::string&, std::uint_fast64_t count) {
+          return std::vector<std::shared_ptr<wolkabout::SensorReading>>(
+            persisted.begin(), persisted.begin() + std::min<std::uint_fast64_t>(count, persisted.size()));
+      }));
+    EXPECT_CALL(*persistenceMock, removeSensorReadings)
+      .WillRepeatedly(Invoke([&](const std::string&, std::uint_fast64_t count) {
+          persisted.erase(persisted.begin(), persisted.begin() + count);
+      }));
+
+    // actual payload is larger than estimated
+    std::vector<std::size_t> batchSizes;
+    EXPECT_CALL(*dataProtocolMock, makeMessage(key, A<const std::vector<std::shared_ptr<wolkabout::SensorReading>>&>()))
+      .WillRepeatedly(
+        Invoke([&](const std::string&, const std::vector<std::shared_ptr<wolkabout::SensorReading>>& readings) {
+            batchSizes.push_back(readings.size());
+            return std::unique_ptr<wolkabout::Message>(
+              new wolkabout::Message(std::string(readings.size() * 10 + 10, 'X'), "HELLO"));
+        }));
+    EXPECT_CALL(*connectivityServiceMock, publish).WillRepeatedly(Return(true));
+
+    wolkabout::PublishCounts counts;
+    EXPECT_NO_THROW(counts = dataService->publishSensorReadings());
+    EXPECT_EQ(3, counts.sent);
+    EXPECT_EQ(3, counts.messages);
+    EXPECT_EQ(2, counts.splits);
+    EXPECT_EQ(60, counts.bytes);
+    EXPECT_EQ((std::vector<std::size_t>{2, 1, 2, 1, 1}), batchSizes);
+}
+
+TEST_F(DataServiceTests, PublishingSensorsKeepsMessagesInFlight)
+{
+    const auto& key = "TEST_DEVICE_KEY";
+    std::unique_ptr<wolkabout::DataService> dataService;
+    EXPECT_NO_THROW(
+      dataService = std::unique_ptr<wolkabout::DataService>(new wolkabout::DataService(
+        key, *dataProtocolMock, *persistenceMock, *connectivityServiceMock, nullptr, nullptr, nullptr, nullptr)));
+    dataService->setPublishBatching(1, false);
+    dataService->setPublishWindow(3);
+
+    std::vector<std::shared_ptr<wolkabout::SensorReading>> persisted;
+    for (const auto& value : {"1", "2", "3", "4", "5"})
+    {
+        persisted.push_back(std::make_shared<wolkabout::SensorReading>(value, "REF1", 0));
+    }
+
+    std::vector<std::string> removed;
+    EXPECT_CALL(*persistenceMock, getSensorReadingsKeys).WillOnce(Return(std::vector<std::string>{"REF1"}));
+    EXPECT_CALL(*persistenceMock, getSensorReadings)
+      .WillRepeatedly(Invoke([&](const std::string&, std::uint_fast64_t count) {
+          return std::vector<std::shared_ptr<wolkabout::SensorReading>>(
+            persisted.begin(), persisted.begin() + std::min<std::uint_fast64_t>(count, persisted.size()));
+      }));
+    EXPECT_CALL(*persistenceMock, removeSensorReadings)
+      .WillRepeatedly(Invoke([&](const std::string&, std::uint_fast64_t count) {
+          for (std::uint_fast64_t i = 0; i < count; ++i)
+          {
+              removed.push_back(persisted.front()->getValue());
+              persisted.erase(persisted.begin());
+          }
+      }));
+    EXPECT_CALL(*dataProtocolMock, makeMessage(key, A<const std::vector<std::shared_ptr<wolkabout::SensorReading>>&>()))
+      .WillRepeatedly(
+        Invoke([&](const std::string&, const std::vector<std::shared_ptr<wolkabout::SensorReading>>& readings) {
+            return std::unique_ptr<wolkabout::Message>(new wolkabout::Message(readings.front()->getValue(), "HELLO"));
+        }));
+
+    // Fourth message fails, after the fifth one is already in flight
+    std::atomic<int> publishing{0};
+    std::atomic<int> maxPublishing{0};
+    EXPECT_CALL(*connectivityServiceMock, publish)
+      .WillRepeatedly(Invoke([&](std::shared_ptr<wolkabout::Message> message, bool) {
+          const int current = ++publishing;
+          int max = maxPublishing;
+          while (current > max && !maxPublishing.compare_exchange_weak(max, current))
+          {
+          }
+
+          std::this_thread::sleep_for(std::chrono::milliseconds{20});
+          --publishing;
+          return message->getContent() != "4";
+      }));
+
+    wolkabout::PublishCounts counts;
+    EXPECT_NO_THROW(counts = dataService->publishSensorReadings());
+    EXPECT_EQ(3, counts.sent);
+    EXPECT_EQ(2, counts.remaining);
+    EXPECT_EQ((std::vector<std::string>{"1", "2", "3"}), removed);
+    EXPECT_LT(1, maxPublishing);
+}
+
+TEST_F(DataServiceTests, PublishingSensorsOverlapsWithinWindow)
+{
+    const auto& key = "TEST_DEVICE_KEY";
+    std::unique_ptr<wolkabout::DataService> dataService;
+    EXPECT_NO_THROW(
+      dataService = std::unique_ptr<wolkabout::DataService>(new wolkabout::DataService(
+        key, *dataProtocolMock, *persistenceMock, *connectivityServiceMock, nullptr, nullptr, nullptr, nullptr)));
+    dataService->setPublishBatching(1, false);
+    dataService->setPublishWindow(3, std::chrono::seconds{5});
+
+    std::vector<std::shared_ptr<wolkabout::SensorReading>> persisted;
+    EXPECT_CALL(*persistenceMock, getSensorReadingsKeys).WillRepeatedly(Return(std::vector<std::string>{"REF1"}));
+    EXPECT_CALL(*persistenceMock, getSensorReadings)
+      .WillRepeatedly(Invoke([&](const std::string&, std::uint_fast64_t count) {
+          return std::vector<std::shared_ptr<wolkabout::SensorReading>>(
+            persisted.begin(), persisted.begin() + std::min<std::uint_fast64_t>(count, persisted.size()));
+      }));
+    EXPECT_CALL(*persistenceMock, removeSensorReadings)
+      .WillRepeatedly(Invoke([&](const std::string&, std::uint_fast64_t count) {
+          persisted.erase(persisted.begin(), persisted.begin() + count);
+      }));
+    EXPECT_CALL(*dataProtocolMock, makeMessage(key, A<const std::vector<std::shared_ptr<wolkabout::SensorReading>>&>()))
+      .WillRepeatedly(
+        Invoke([&](const std::string&, const std::vector<std::shared_ptr<wolkabout::SensorReading>>& readings) {
+            return std::unique_ptr<wolkabout::Message>(new wolkabout::Message(readings.front()->getValue(), "HELLO"));
+        }));
+
+    // Each publish returns only once the whole window is publishing, so it fails unless publishes overlap
+    std::mutex mutex;
+    std::condition_variable windowFull;
+    int publishing = 0;
+    std::vector<std::thread::id> publishers;
+    EXPECT_CALL(*connectivityServiceMock, publish)
+      .WillRepeatedly(Invoke([&](std::shared_ptr<wolkabout::Message>, bool) {
+          std::unique_lock<std::mutex> lock{mutex};
+          publishers.push_back(std::this_thread::get_id());
+
+          if (++publishing % 3 == 0)
+          {
+              windowFull.notify_all();
+              return true;
+          }
+
+          const auto target = (publishing / 3 + 1) * 3;
+          return windowFull.wait_for(lock, std::chrono::seconds{1}, [&] { return publishing >= target; });
+      }));
+
+    for (int round = 0; round < 2; ++round)
+    {
+        for (const auto& value : {"1", "2", "3"})
+        {
+            persisted.push_back(std::make_shared<wolkabout::SensorReading>(value, "REF1", 0));
+        }
+
+        wolkabout::PublishCounts counts;
+        EXPECT_NO_THROW(counts = dataService->publishSensorReadings());
+        EXPECT_EQ(3, counts.sent);
+        EXPECT_EQ(0, counts.remaining);
+    }
+
+    // Publishers are created once, along with the window
+    std::sort(publishers.begin(), publishers.end());
+    EXPECT_EQ(3, std::unique(publishers.begin(), publishers.end()) - publishers.begin());
+}
+
+TEST_F(DataServiceTests, PublishingSensorsTakesTurnsWithinBudget)
+{
+    const auto& key = "TEST_DEVICE_KEY";
+    std::unique_ptr<wolkabout::DataService> dataService;
+    EXPECT_NO_THROW(
+      dataService = std::unique_ptr<wolkabout::DataService>(new wolkabout::DataService(
+        key, *dataProtocolMock, *persistenceMock, *connectivityServiceMock, nullptr, nullptr, nullptr, nullptr)));
+    dataService->setPublishBatching(2, false);
+
+    wolkabout::PublishBudget budget;
+    budget.items = 6;
+    budget.quantum = 2;
+    dataService->setPublishBudget(budget);
+
+    std::map<std::string, std::vector<std::shared_ptr<wolkabout::SensorReading>>> persisted;
+    for (int i = 0; i < 10; ++i)
+    {
+        persisted["REF1"].push_back(std::make_shared<wolkabout::SensorReading>(std::to_string(i), "REF1", 0));
+    }
+    for (int i = 0; i < 2; ++i)
+    {
+        persisted["REF2"].push_back(std::make_shared<wolkabout::SensorReading>(std::to_string(i), "REF2", 0));
+    }
+
+    EXPECT_CALL(*persistenceMock, getSensorReadingsKeys)
+      .WillRepeatedly(Return(std::vector<std::string>{"REF1", "REF2"}));
+    EXPECT_CALL(*persistenceMock, getSensorReadings)
+      .WillRepeatedly(Invoke([&](const std::string& reference, std::uint_fast64_t count) {
+          const auto& readings = persisted[reference];
+          return std::vector<std::shared_ptr<wolkabout::SensorReading>>(
+            readings.begin(), readings.begin() + std::min<std::uint_fast64_t>(count, readings.size()));
+      }));
+    EXPECT_CALL(*persistenceMock, removeSensorReadings)
+      .WillRepeatedly(Invoke([&](const std::string& reference, std::uint_fast64_t count) {
+          auto& readings = persisted[reference];
+          readings.erase(readings.begin(), readings.begin() + count);
+      }));
+
+    std::vector<std::string> batches;
+    EXPECT_CALL(*dataProtocolMock, makeMessage(key, A<const std::vector<std::shared_ptr<wolkabout::SensorReading>>&>()))
+      .WillRepeatedly(
+        Invoke([&](const std::string&, const std::vector<std::shared_ptr<wolkabout::SensorReading>>& readings) {
+            batches.push_back(readings.front()->getReference());
+            return std::unique_ptr<wolkabout::Message>(new wolkabout::Message("HELLO", "HELLO"));
+        }));
+    EXPECT_CALL(*connectivityServiceMock, publish).WillRepeatedly(Return(true));
+
+    wolkabout::PublishCounts counts;
+    EXPECT_NO_THROW(counts = dataService->publishSensorReadings());
+    EXPECT_EQ(6, counts.sent);
+    EXPECT_EQ(6, counts.remaining);
+    EXPECT_TRUE(counts.yielded);
+    EXPECT_EQ((std::vector<std::string>{"REF1", "REF2", "REF1"}), batches);
+
+    EXPECT_NO_THROW(counts = dataService->publishSensorReadings());
+    EXPECT_EQ(6, counts.sent);
+    EXPECT_EQ(0, counts.remaining);
+    EXPECT_FALSE(counts.yielded);
+}
+
+TEST_F(DataServiceTests, PublishingSensorsReusesMessageOfFailedBatch)
+{
+    const auto& key = "TEST_DEVICE_KEY";
+    std::unique_ptr<wolkabout::DataService> dataService;
+    EXPECT_NO_THROW(
+      dataService = std::unique_ptr<wolkabout::DataService>(new wolkabout::DataService(
+        key, *dataProtocolMock, *persistenceMock, *connectivityServiceMock, nullptr, nullptr, nullptr, nullptr)));
+
+    std::vector<std::shared_ptr<wolkabout::SensorReading>> persisted{
+      std::make_shared<wolkabout::SensorReading>("1", "REF1", 0),
+      std::make_shared<wolkabout::SensorReading>("2", "REF1", 0)};
+
+    EXPECT_CALL(*persistenceMock, getSensorReadingsKeys).WillRepeatedly(Return(std::vector<std::string>{"REF1"}));
+    EXPECT_CALL(*persistenceMock, getSensorReadings)
+      .WillRepeatedly(Invoke([&](const std::string&, std::uint_fast64_t count) {
+          return std::vector<std::shared_ptr<wolkabout::SensorReading>>(
+            persisted.begin(), persisted.begin() + std::min<std::uint_fast64_t>(count, persisted.size()));
+      }));
+    EXPECT_CALL(*persistenceMock, removeSensorReadings)
+      .WillRepeatedly(Invoke([&](const std::string&, std::uint_fast64_t count) {
+          persisted.erase(persisted.begin(), persisted.begin() + count);
+      }));
+
+    EXPECT_CALL(*dataProtocolMock, makeMessage(key, A<const std::vector<std::shared_ptr<wolkabout::SensorReading>>&>()))
+      .WillOnce(Return(ByMove(std::unique_ptr<wolkabout::Message>(new wolkabout::Message("HELLO", "HELLO")))));
+    EXPECT_CALL(*connectivityServiceMock, publish)
+      .WillOnce(Return(false))
+      .WillOnce(Return(false))
+      .WillOnce(Return(true));
+
+    EXPECT_EQ(2, dataService->publishSensorReadings().remaining);
+    EXPECT_EQ(2, dataService->publishSensorReadings().remaining);
+    EXPECT_EQ(2, dataService->publishSensorReadings().sent);
+    EXPECT_TRUE(persisted.empty());
+}
+
+TEST_F(DataServiceTests, PublishingSensorsIsPreemptedByAlarms)
+{
+    const auto& key = "TEST_DEVICE_KEY";
+    std::unique_ptr<wolkabout::DataService> dataService;
+    EXPECT_NO_THROW(
+      dataService = std::unique_ptr<wolkabout::DataService>(new wolkabout::DataService(
+        key, *dataProtocolMock, *persistenceMock, *connectivityServiceMock, nullptr, nullptr, nullptr, nullptr)));
+
+    dataService->setPublishBatching(1, false);
+
+    std::vector<std::shared_ptr<wolkabout::SensorReading>> persisted;
+    for (int i = 0; i < 3; ++i)
+    {
+        persisted.push_back(std::make_shared<wolkabout::SensorReading>(std::to_string(i), "REF1", 0));
+    }
+
+    EXPECT_CALL(*persistenceMock, getSensorReadingsKeys).WillRepeatedly(Return(std::vector<std::string>{"REF1"}));
+    EXPECT_CALL(*persistenceMock, getSensorReadings)
+      .WillRepeatedly(Invoke([&](const std::string&, std::uint_fast64_t count) {
+          return std::vector<std::shared_ptr<wolkabout::SensorReading>>(
+            persisted.begin(), persisted.begin() + std::min<std::uint_fast64_t>(count, persisted.size()));
+      }));
+    EXPECT_CALL(*persistenceMock, removeSensorReadings)
+      .WillRepeatedly(Invoke([&](const std::string&, std::uint_fast64_t count) {
+          persisted.erase(persisted.begin(), persisted.begin() + count);
+      }));
+
+    EXPECT_CALL(*dataProtocolMock, makeMessage(key, A<const std::vector<std::shared_ptr<wolkabout::SensorReading>>&>()))
+      .WillRepeatedly(InvokeWithoutArgs(
+        [] { return std::unique_ptr<wolkabout::Message>(new wolkabout::Message("HELLO", "HELLO")); }));
+
+    // alarm raised while the first message is being published
+    EXPECT_CALL(*connectivityServiceMock, publish).WillRepeatedly(InvokeWithoutArgs([&] {
+        if (persisted.size() == 3)
+        {
+            dataService->addAlarm("ALARM", true, 0);
+        }
+        return true;
+    }));
+
+    auto counts = dataService->publishSensorReadings();
+    EXPECT_EQ(1, counts.sent);
+    EXPECT_EQ(2, counts.remaining);
+    EXPECT_TRUE(counts.preempted);
+    EXPECT_TRUE(counts.yielded);
+
+    counts = dataService->publishSensorReadings();
+    EXPECT_EQ(2, counts.sent);
+    EXPECT_EQ(0, counts.remaining);
+    EXPECT_FALSE(counts.preempted);
+}
+
+TEST_F(DataServiceTests, PublishingSensorsYieldsToControlCommands)
+{
+    const auto& key = "TEST_DEVICE_KEY";
+    std::unique_ptr<wolkabout::DataService> dataService;
+    EXPECT_NO_THROW(
+      dataService = std::unique_ptr<wolkabout::DataService>(new wolkabout::DataService(
+        key, *dataProtocolMock, *persistenceMock, *connectivityServiceMock, nullptr, nullptr, nullptr, nullptr)));
+
+    // unlimited budget, so without preemption a single call drains all readings
+    dataService->setPublishBatching(1, false);
+
+    std::vector<std::shared_ptr<wolkabout::SensorReading>> persisted;
+    for (int i = 0; i < 100; ++i)
+    {
+        persisted.push_back(std::make_shared<wolkabout::SensorReading>(std::to_string(i), "REF1", 0));
+    }
+
+    EXPECT_CALL(*persistenceMock, getSensorReadingsKeys).WillRepeatedly(Invoke([&] {
+        return persisted.empty() ? std::vector<std::string>{} : std::vector<std::string>{"REF1"};
+    }));
+    EXPECT_CALL(*persistenceMock, getSensorReadings)
+      .WillRepeatedly(Invoke([&](const std::string&, std::uint_fast64_t count) {
+          return std::vector<std::shared_ptr<wolkabout::SensorReading>>(
+            persisted.begin(), persisted.begin() + std::min<std::uint_fast64_t>(count, persisted.size()));
+      }));
+    EXPECT_CALL(*persistenceMock, removeSensorReadings)
+      .WillRepeatedly(Invoke([&](const std::string&, std::uint_fast64_t count) {
+          persisted.erase(persisted.begin(), persisted.begin() + count);
+      }));
+
+    EXPECT_CALL(*dataProtocolMock, makeMessage(key, A<const std::vector<std::shared_ptr<wolkabout::SensorReading>>&>()))
+      .WillRepeatedly(InvokeWithoutArgs(
+        [] { return std::unique_ptr<wolkabout::Message>(new wolkabout::Message("HELLO", "HELLO")); }));
+
+    std::mutex mutex;
+    std::condition_variable condition;
+    bool drained = false;
+    std::size_t remainingWhenControlRan = 0;
+
+    wolkabout::IngestionQueue egress{[](std::vector<wolkabout::IngestionRecord>& records) {
+                                         for (auto& record : records)
+                                         {
+                                             record.command();
+                                         }
+                                     },
+                                     wolkabout::IngestionQueue::DEFAULT_CAPACITY, 1};
+
+    dataService->setPreemptionCheck([&] { return egress.hasPendingControl(); });
+
+    const auto push = [&](std::function<void()> command, wolkabout::IngestionQueue::Priority priority) {
+        wolkabout::IngestionRecord record;
+        record.type = wolkabout::IngestionRecord::Type::COMMAND;
+        record.command = std::move(command);
+        egress.push(std::move(record), priority);
+    };
+
+    // control command, such as disconnect, arrives from another thread while the first message is being published
+    EXPECT_CALL(*connectivityServiceMock, publish).WillRepeatedly(InvokeWithoutArgs([&] {
+        if (persisted.size() == 100)
+        {
+            std::thread{[&] {
+                push([&] { remainingWhenControlRan = persisted.size(); }, wolkabout::IngestionQueue::Priority::CONTROL);
+            }}.join();
+        }
+        return true;
+    }));
+
+    std::function<void()> drain = [&] {
+        if (dataService->publishSensorReadings().yielded)
+        {
+            push(drain, wolkabout::IngestionQueue::Priority::BULK);
+            return;
+        }
+
+        std::lock_guard<std::mutex> lock{mutex};
+        drained = true;
+        condition.notify_one();
+    };
+    push(drain, wolkabout::IngestionQueue::Priority::BULK);
+
+    std::unique_lock<std::mutex> lock{mutex};
+    ASSERT_TRUE(condition.wait_for(lock, std::chrono::seconds(5), [&] { return drained; }));
+
+    EXPECT_TRUE(persisted.empty());
+    EXPECT_EQ(99, remainingWhenControlRan);
+}
+
+TEST_F(DataServiceTests, PublishingDirectlyBypassesPersistence)
+{
+    const auto& key = "TEST_DEVICE_KEY";
+    std::unique_ptr<wolkabout::DataService> dataService;
+    EXPECT_NO_THROW(
+      dataService = std::unique_ptr<wolkabout::DataService>(new wolkabout::DataService(
+        key, *dataProtocolMock, *persistenceMock, *connectivityServiceMock, nullptr, nullptr, nullptr, nullptr)));
+
+    dataService->setPublishBatching(50, true);
+    dataService->setDirectPublish(true);
+    dataService->setConnected(true);
+
+    // readings are stored until persistence is drained, as it may hold readings of a previous run
+    EXPECT_CALL(*persistenceMock, putSensorReading).Times(1);
+    dataService->addSensorReading("REF1", "1", 0);
+    EXPECT_FALSE(dataService->hasDirectItems());
+    Mock::VerifyAndClearExpectations(persistenceMock.get());
+
+    dataService->m_sensorReadingsBacklog = 0;
+
+    EXPECT_CALL(*persistenceMock, putSensorReading).Times(0);
+    dataService->addSensorReading("REF1", "2", 0);
+    dataService->addSensorReading("REF2", "3", 0);
+    EXPECT_TRUE(dataService->hasDirectItems());
+
+    EXPECT_CALL(*dataProtocolMock, makeMessage(key, A<const std::vector<std::shared_ptr<wolkabout::SensorReading>>&>()))
+      .WillOnce(Return(ByMove(std::unique_ptr<wolkabout::Message>(new wolkabout::Message("HELLO", "HELLO")))));
+    EXPECT_CALL(*connectivityServiceMock, publish).WillOnce(Return(true));
+
+    const auto result = dataService->publishDirectly();
+    EXPECT_EQ(2, result.sensorReadings.sent);
+    EXPECT_EQ(1, result.sensorReadings.messages);
+    EXPECT_FALSE(dataService->hasDirectItems());
+    Mock::VerifyAndClearExpectations(persistenceMock.get());
+    Mock::VerifyAndClearExpectations(connectivityServiceMock.get());
+
+    // readings which fail to publish fall back to persistence, along with readings added after them
+    dataService->addSensorReading("REF1", "4", 0);
+
+    EXPECT_CALL(*dataProtocolMock, makeMessage(key, A<const std::vector<std::shared_ptr<wolkabout::SensorReading>>&>()))
+      .WillOnce(Return(ByMove(std::unique_ptr<wolkabout::Message>(new wolkabout::Message("HELLO", "HELLO")))));
+    EXPECT_CALL(*connectivityServiceMock, publish).WillOnce(Return(false));
+    EXPECT_CALL(*persistenceMock, putSensorReading).Times(2);
+
+    EXPECT_EQ(1, dataService->publishDirectly().sensorReadings.remaining);
+    dataService->addSensorReading("REF1", "5", 0);
+    EXPECT_FALSE(dataService->hasDirectItems());
+    Mock::VerifyAndClearExpectations(persistenceMock.get());
+
+    // held readings are stored once connection is lost
+    dataService->m_sensorReadingsBacklog = 0;
+    dataService->addSensorReading("REF1", "6", 0);
+
+    EXPECT_CALL(*persistenceMock, putSensorReading).Times(1);
+    dataService->setConnected(false);
+    EXPECT_FALSE(dataService->hasDirectItems());
+}
+
+TEST_F(DataServiceTests, PublishingWhileOfflineIsSuppressed)
+{
+    const auto& key = "TEST_DEVICE_KEY";
+    std::unique_ptr<wolkabout::DataService> dataService;
+    EXPECT_NO_THROW(
+      dataService = std::unique_ptr<wolkabout::DataService>(new wolkabout::DataService(
+        key, *dataProtocolMock, *persistenceMock, *connectivityServiceMock, nullptr, nullptr, nullptr, nullptr)));
+
+    dataService->setConnected(false);
+
+    // items left in persistence are counted, without being made into messages
+    const auto reading = std::make_shared<wolkabout::SensorReading>("1", "REF1", 0);
+    const auto alarm = std::make_shared<wolkabout::Alarm>("ON", "ALARM1", 0);
+    EXPECT_CALL(*persistenceMock, getSensorReadingsKeys)
+      .WillRepeatedly(Return(std::vector<std::string>{"REF1", "REF2"}));
+    EXPECT_CALL(*persistenceMock, getSensorReadings(_, wolkabout::DataService::ALL_ITEMS))
+      .WillRepeatedly(Return(std::vector<std::shared_ptr<wolkabout::SensorReading>>{reading, reading}));
+    EXPECT_CALL(*persistenceMock, getAlarmsKeys).WillOnce(Return(std::vector<std::string>{"ALARM1"}));
+    EXPECT_CALL(*persistenceMock, getAlarms("ALARM1", wolkabout::DataService::ALL_ITEMS))
+      .WillOnce(Return(std::vector<std::shared_ptr<wolkabout::Alarm>>{alarm}));
+    EXPECT_CALL(*persistenceMock, getActuatorStatusesKeys)
+      .WillOnce(Return(std::vector<std::string>{"ACT1", "ACT2", "ACT3"}));
+    EXPECT_CALL(*persistenceMock, getConfiguration(key))
+      .WillOnce(Return(std::make_shared<std::vector<wolkabout::ConfigurationItem>>()));
+    EXPECT_CALL(*dataProtocolMock, makeMessage(key, A<const std::vector<std::shared_ptr<wolkabout::SensorReading>>&>()))
+      .Times(0);
+    EXPECT_CALL(*connectivityServiceMock, publish).Times(0);
+
+    auto counts = dataService->publishSensorReadings();
+    EXPECT_TRUE(counts.suppressed);
+    EXPECT_EQ(4, counts.remaining);
+    EXPECT_TRUE(dataService->publishSensorReadings().suppressed);
+
+    counts = dataService->publishAlarms();
+    EXPECT_TRUE(counts.suppressed);
+    EXPECT_EQ(1, counts.remaining);
+
+    counts = dataService->publishActuatorStatuses();
+    EXPECT_TRUE(counts.suppressed);
+    EXPECT_EQ(3, counts.remaining);
+
+    counts = dataService->publishConfiguration();
+    EXPECT_TRUE(counts.suppressed);
+    EXPECT_EQ(1, counts.remaining);
+    EXPECT_EQ(0, counts.sent);
+
+    const auto suppressed = dataService->getSuppressedPublishes();
+    EXPECT_EQ(2, suppressed.sensorReadings);
+    EXPECT_EQ(1, suppressed.alarms);
+    EXPECT_EQ(1, suppressed.actuatorStatuses);
+    EXPECT_EQ(1, suppressed.configuration);
+    EXPECT_EQ(5, suppressed.total());
+    Mock::VerifyAndClearExpectations(persistenceMock.get());
+
+    dataService->setConnected(true);
+
+    EXPECT_CALL(*persistenceMock, getSensorReadingsKeys).WillOnce(Return(std::vector<std::string>{}));
+    EXPECT_FALSE(dataService->publishSensorReadings().suppressed);
+    EXPECT_EQ(5, dataService->getSuppressedPublishes().total());
+}
+
 TEST_F(DataServiceTests, PublishingAlarmsTests)
 {
     const auto& key = "TEST_DEVICE_KEY";
@@ -295,6 +977,93 @@ TEST_F(DataServiceTests, PublishingActuatorStatusTests)
     EXPECT_NO_THROW(dataService->publishActuatorStatuses());
 }
 
+TEST_F(DataServiceTests, PublishingActuatorStatusesPacksReferences)
+{
+    const auto& key = "TEST_DEVICE_KEY";
+    std::unique_ptr<wolkabout::DataService> dataService;
+    EXPECT_NO_THROW(
+      dataService = std::unique_ptr<wolkabout::DataService>(new wolkabout::DataService(
+        key, *dataProtocolMock, *persistenceMock, *connectivityServiceMock, nullptr, nullptr, nullptr, nullptr)));
+
+    dataService->setPublishBatching(2, true);
+    dataService->setActuatorStatusBatching(true);
+
+    std::map<std::string, std::shared_ptr<wolkabout::ActuatorStatus>> persisted;
+    for (const auto& reference : {"REF1", "REF2", "REF3"})
+    {
+        persisted[reference] =
+          std::make_shared<wolkabout::ActuatorStatus>("VALUE", reference, wolkabout::ActuatorStatus::State::READY);
+    }
+
+    EXPECT_CALL(*persistenceMock, getActuatorStatusesKeys)
+      .WillOnce(Return(std::vector<std::string>{"REF1", "REF2", "REF3"}));
+    EXPECT_CALL(*persistenceMock, getActuatorStatus).WillRepeatedly(Invoke([&](const std::string& reference) {
+        return persisted[reference];
+    }));
+    EXPECT_CALL(*persistenceMock, removeActuatorStatus).WillRepeatedly(Invoke([&](const std::string& reference) {
+        persisted.erase(reference);
+    }));
+
+    std::vector<std::size_t> batches;
+    EXPECT_CALL(*dataProtocolMock,
+                makeMessage(key, A<const std::vector<std::shared_ptr<wolkabout::ActuatorStatus>>&>()))
+      .WillRepeatedly(
+        Invoke([&](const std::string&, const std::vector<std::shared_ptr<wolkabout::ActuatorStatus>>& statuses) {
+            batches.push_back(statuses.size());
+            return std::unique_ptr<wolkabout::Message>(new wolkabout::Message("HELLO", "HELLO"));
+        }));
+    EXPECT_CALL(*connectivityServiceMock, publish).Times(2).WillRepeatedly(Return(true));
+
+    const auto counts = dataService->publishActuatorStatuses();
+    EXPECT_EQ(3, counts.sent);
+    EXPECT_EQ(2, counts.messages);
+    EXPECT_EQ((std::vector<std::size_t>{2, 1}), batches);
+    EXPECT_TRUE(persisted.empty());
+}
+
+TEST_F(DataServiceTests, PublishingActuatorStatusesIsNotPackedByDefault)
+{
+    const auto& key = "TEST_DEVICE_KEY";
+    std::unique_ptr<wolkabout::DataService> dataService;
+    EXPECT_NO_THROW(
+      dataService = std::unique_ptr<wolkabout::DataService>(new wolkabout::DataService(
+        key, *dataProtocolMock, *persistenceMock, *connectivityServiceMock, nullptr, nullptr, nullptr, nullptr)));
+
+    // cross reference batching of sensor readings does not extend to actuator statuses
+    dataService->setPublishBatching(2, true);
+
+    std::map<std::string, std::shared_ptr<wolkabout::ActuatorStatus>> persisted;
+    for (const auto& reference : {"REF1", "REF2"})
+    {
+        persisted[reference] =
+          std::make_shared<wolkabout::ActuatorStatus>("VALUE", reference, wolkabout::ActuatorStatus::State::READY);
+    }
+
+    EXPECT_CALL(*persistenceMock, getActuatorStatusesKeys).WillOnce(Return(std::vector<std::string>{"REF1", "REF2"}));
+    EXPECT_CALL(*persistenceMock, getActuatorStatus).WillRepeatedly(Invoke([&](const std::string& reference) {
+        return persisted[reference];
+    }));
+    EXPECT_CALL(*persistenceMock, removeActuatorStatus).WillRepeatedly(Invoke([&](const std::string& reference) {
+        persisted.erase(reference);
+    }));
+
+    std::vector<std::size_t> batches;
+    EXPECT_CALL(*dataProtocolMock,
+                makeMessage(key, A<const std::vector<std::shared_ptr<wolkabout::ActuatorStatus>>&>()))
+      .WillRepeatedly(
+        Invoke([&](const std::string&, const std::vector<std::shared_ptr<wolkabout::ActuatorStatus>>& statuses) {
+            batches.push_back(statuses.size());
+            return std::unique_ptr<wolkabout::Message>(new wolkabout::Message("HELLO", "HELLO"));
+        }));
+    EXPECT_CALL(*connectivityServiceMock, publish).Times(2).WillRepeatedly(Return(true));
+
+    const auto counts = dataService->publishActuatorStatuses();
+    EXPECT_EQ(2, counts.sent);
+    EXPECT_EQ(2, counts.messages);
+    EXPECT_EQ((std::vector<std::size_t>{1, 1}), batches);
+    EXPECT_TRUE(persisted.empty());
+}
+
 TEST_F(DataServiceTests, PublishingConfigurationsTests)
 {
     const auto& key = "TEST_DEVICE_KEY";
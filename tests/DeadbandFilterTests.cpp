@@ -0,0 +1,122 @@
+/*
+ * Copyright 2020 WolkAbout Technology s.r.o.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "ingestion/DeadbandFilter.h"
+#include "model/ReadingValue.h"
+#include "utilities/ReferenceRegistry.h"
+
+#include <gtest/gtest.h>
+
+#include <chrono>
+#include <string>
+#include <vector>
+
+class DeadbandFilterTests : public ::testing::Test
+{
+};
+
+TEST_F(DeadbandFilterTests, ChangeOnly)
+{
+    wolkabout::DeadbandFilter filter;
+    filter.setDeadband("REF", wolkabout::Deadband{});
+
+    EXPECT_TRUE(filter.pass("REF", wolkabout::ReadingValue{1}, 1));
+    EXPECT_FALSE(filter.pass("REF", wolkabout::ReadingValue{1}, 2));
+    EXPECT_TRUE(filter.pass("REF", wolkabout::ReadingValue{2}, 3));
+
+    EXPECT_TRUE(filter.pass("TEXT", wolkabout::ReadingValue{std::string{"A"}}, 1));
+    EXPECT_TRUE(filter.pass("TEXT", wolkabout::ReadingValue{std::string{"A"}}, 2));
+
+    filter.setDeadband("TEXT", wolkabout::Deadband{});
+    EXPECT_TRUE(filter.pass("TEXT", wolkabout::ReadingValue{std::string{"A"}}, 3));
+    EXPECT_FALSE(filter.pass("TEXT", wolkabout::ReadingValue{std::string{"A"}}, 4));
+    EXPECT_TRUE(filter.pass("TEXT", wolkabout::ReadingValue{std::string{"B"}}, 5));
+}
+
+TEST_F(DeadbandFilterTests, AbsoluteAndPercentBands)
+{
+    wolkabout::Deadband absolute;
+    absolute.absolute = 0.5;
+
+    wolkabout::Deadband percent;
+    percent.percent = 10;
+
+    wolkabout::DeadbandFilter filter;
+    filter.setDeadband("ABS", absolute);
+    filter.setDeadband("PCT", percent);
+
+    EXPECT_TRUE(filter.pass("ABS", wolkabout::ReadingValue{20.0}, 1));
+    EXPECT_FALSE(filter.pass("ABS", wolkabout::ReadingValue{20.3}, 2));
+    EXPECT_FALSE(filter.pass("ABS", wolkabout::ReadingValue{20.5}, 3));
+    EXPECT_TRUE(filter.pass("ABS", wolkabout::ReadingValue{20.6}, 4));
+    EXPECT_FALSE(filter.pass("ABS", wolkabout::ReadingValue{20.2}, 5));
+
+    EXPECT_TRUE(filter.pass("PCT", wolkabout::ReadingValue{100}, 1));
+    EXPECT_FALSE(filter.pass("PCT", wolkabout::ReadingValue{109}, 2));
+    EXPECT_TRUE(filter.pass("PCT", wolkabout::ReadingValue{111}, 3));
+    EXPECT_FALSE(filter.pass("PCT", wolkabout::ReadingValue{101}, 4));
+
+    EXPECT_TRUE(filter.pass("ABS", wolkabout::ReadingValue{std::vector<double>{1, 2, 3}}, 6));
+    EXPECT_FALSE(filter.pass("ABS", wolkabout::ReadingValue{std::vector<double>{1.1, 2.1, 3.1}}, 7));
+    EXPECT_TRUE(filter.pass("ABS", wolkabout::ReadingValue{std::vector<double>{1, 2, 4}}, 8));
+}
+
+TEST_F(DeadbandFilterTests, HeartbeatAndHandles)
+{
+    wolkabout::Deadband deadband;
+    deadband.absolute = 10;
+    deadband.heartbeat = std::chrono::milliseconds{1000};
+
+    wolkabout::DeadbandFilter filter;
+    filter.setDeadband("REF", deadband);
+
+    wolkabout::ReferenceRegistry registry;
+    const auto handle = registry.intern("REF");
+    const auto other = registry.intern("OTHER");
+    filter.bind(handle, "REF");
+    filter.bind(other, "OTHER");
+
+    EXPECT_TRUE(filter.pass(handle, wolkabout::ReadingValue{1}, 1000));
+    EXPECT_FALSE(filter.pass("REF", wolkabout::ReadingValue{1}, 1500));
+    EXPECT_FALSE(filter.pass(handle, wolkabout::ReadingValue{2}, 1999));
+    EXPECT_TRUE(filter.pass(handle, wolkabout::ReadingValue{2}, 2000));
+    EXPECT_FALSE(filter.pass(handle, wolkabout::ReadingValue{2}, 2500));
+
+    EXPECT_TRUE(filter.pass(other, wolkabout::ReadingValue{2}, 2500));
+    EXPECT_TRUE(filter.pass(other, wolkabout::ReadingValue{2}, 2500));
+}
+
+TEST_F(DeadbandFilterTests, RejectedReadingIsNotRemembered)
+{
+    wolkabout::Deadband deadband;
+    deadband.absolute = 5;
+
+    wolkabout::DeadbandFilter filter;
+    filter.setDeadband("REF", deadband);
+
+    wolkabout::ReferenceRegistry registry;
+    const auto handle = registry.intern("REF");
+    filter.bind(handle, "REF");
+
+    EXPECT_TRUE(filter.pass(handle, wolkabout::ReadingValue{0}, 1, [] { return true; }));
+
+    // Reading passed the band but was not admitted, so the next one is still compared to 0
+    EXPECT_FALSE(filter.pass(handle, wolkabout::ReadingValue{10}, 2, [] { return false; }));
+    EXPECT_TRUE(filter.pass(handle, wolkabout::ReadingValue{12}, 3, [] { return true; }));
+    EXPECT_FALSE(filter.pass(handle, wolkabout::ReadingValue{14}, 4, [] { return true; }));
+
+    EXPECT_FALSE(filter.pass("UNFILTERED", wolkabout::ReadingValue{1}, 5, [] { return false; }));
+}
@@ -0,0 +1,86 @@
+/*
+ * Copyright 2020 WolkAbout Technology s.r.o.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "ingestion/FlushScheduler.h"
+
+#include <gtest/gtest.h>
+
+#include <chrono>
+#include <thread>
+
+class FlushSchedulerTests : public ::testing::Test
+{
+};
+
+TEST_F(FlushSchedulerTests, DisabledPolicyNeverFlushes)
+{
+    wolkabout::FlushScheduler scheduler{wolkabout::FlushPolicy{}};
+
+    scheduler.readingsAdded(1000, 1000000);
+    scheduler.alarmsAdded(10);
+
+    EXPECT_FALSE(scheduler.readingsDue());
+    EXPECT_FALSE(scheduler.alarmsDue());
+    EXPECT_EQ(0, scheduler.getTickInterval().count());
+}
+
+TEST_F(FlushSchedulerTests, ItemAndByteThresholds)
+{
+    wolkabout::FlushPolicy policy;
+    policy.maxItems = 10;
+    policy.maxBytes = 100;
+    wolkabout::FlushScheduler scheduler{policy};
+
+    scheduler.readingsAdded(9, 50);
+    EXPECT_FALSE(scheduler.readingsDue());
+
+    scheduler.readingsAdded(1, 10);
+    EXPECT_TRUE(scheduler.readingsDue());
+
+    scheduler.readingsFlushed();
+    EXPECT_FALSE(scheduler.readingsDue());
+    EXPECT_FALSE(scheduler.hasPending());
+
+    scheduler.readingsAdded(1, 100);
+    EXPECT_TRUE(scheduler.readingsDue());
+}
+
+TEST_F(FlushSchedulerTests, AgeThresholds)
+{
+    wolkabout::FlushPolicy policy;
+    policy.maxAge = std::chrono::milliseconds{100};
+    policy.alarmDeadline = std::chrono::milliseconds{20};
+    wolkabout::FlushScheduler scheduler{policy};
+
+    EXPECT_EQ(10, scheduler.getTickInterval().count());
+
+    scheduler.readingsAdded(1, 10);
+    scheduler.alarmsAdded(1);
+    EXPECT_TRUE(scheduler.hasPending());
+    EXPECT_FALSE(scheduler.readingsDue());
+    EXPECT_FALSE(scheduler.alarmsDue());
+
+    std::this_thread::sleep_for(std::chrono::milliseconds{30});
+    EXPECT_FALSE(scheduler.readingsDue());
+    EXPECT_TRUE(scheduler.alarmsDue());
+
+    scheduler.alarmsFlushed();
+    EXPECT_FALSE(scheduler.alarmsDue());
+    EXPECT_TRUE(scheduler.hasPending());
+
+    std::this_thread::sleep_for(std::chrono::milliseconds{80});
+    EXPECT_TRUE(scheduler.readingsDue());
+}
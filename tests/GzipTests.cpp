@@ -0,0 +1,141 @@
+/*
+ * Copyright 2020 WolkAbout Technology s.r.o.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "model/Alarm.h"
+#include "model/Message.h"
+#include "model/SensorReading.h"
+#include "protocol/gzip/GzipDataProtocol.h"
+#include "utilities/Gzip.h"
+
+#include "mocks/DataProtocolMock.h"
+
+#include <gmock/gmock.h>
+#include <gtest/gtest.h>
+
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace
+{
+std::string readingsPayload(std::size_t count)
+{
+    std::string payload = "[";
+    for (std::size_t i = 0; i < count; ++i)
+    {
+        payload += (i == 0 ? "" : ",");
+        payload += R"({"utc":)" + std::to_string(1600000000000 + i * 1000) + R"(,"data":")" + std::to_string(i % 7) +
+                   R"("})";
+    }
+
+    return payload + "]";
+}
+}    // namespace
+
+class GzipTests : public ::testing::Test
+{
+};
+
+TEST_F(GzipTests, CompressedPayloadIsDecompressedToOriginal)
+{
+    const auto payload = readingsPayload(500);
+
+    std::string compressed;
+    ASSERT_TRUE(wolkabout::Gzip::compress(payload, compressed));
+    EXPECT_TRUE(wolkabout::Gzip::isCompressed(compressed));
+    EXPECT_FALSE(wolkabout::Gzip::isCompressed(payload));
+    EXPECT_LT(compressed.size() * 5, payload.size());
+
+    std::string decompressed;
+    ASSERT_TRUE(wolkabout::Gzip::decompress(compressed, decompressed));
+    EXPECT_EQ(payload, decompressed);
+}
+
+TEST_F(GzipTests, CorruptedPayloadIsNotDecompressed)
+{
+    std::string compressed;
+    ASSERT_TRUE(wolkabout::Gzip::compress(readingsPayload(100), compressed));
+
+    std::string decompressed;
+    EXPECT_FALSE(wolkabout::Gzip::decompress(compressed.substr(0, compressed.size() / 2), decompressed));
+    EXPECT_FALSE(wolkabout::Gzip::decompress("not compressed", decompressed));
+}
+
+TEST_F(GzipTests, ProtocolCompressesPayloadsAboveThreshold)
+{
+    using ::testing::_;
+    using ::testing::ByMove;
+    using ::testing::Return;
+
+    const auto payload = readingsPayload(100);
+
+    std::unique_ptr<DataProtocolMock> dataProtocolMock{new DataProtocolMock()};
+    EXPECT_CALL(*dataProtocolMock,
+                makeMessage(_, ::testing::A<const std::vector<std::shared_ptr<wolkabout::SensorReading>>&>()))
+      .WillOnce(Return(ByMove(std::unique_ptr<wolkabout::Message>(new wolkabout::Message(payload, "readings/KEY")))));
+
+    wolkabout::GzipDataProtocol protocol{std::move(dataProtocolMock), 256};
+
+    const auto message =
+      protocol.makeMessage("KEY", std::vector<std::shared_ptr<wolkabout::SensorReading>>{
+                                    std::make_shared<wolkabout::SensorReading>("1", "REF", 1600000000000)});
+
+    ASSERT_NE(nullptr, message);
+    EXPECT_EQ("readings/KEY", message->getChannel());
+    ASSERT_TRUE(wolkabout::Gzip::isCompressed(message->getContent()));
+
+    std::string decompressed;
+    ASSERT_TRUE(wolkabout::Gzip::decompress(message->getContent(), decompressed));
+    EXPECT_EQ(payload, decompressed);
+}
+
+TEST_F(GzipTests, ProtocolSkipsPayloadsBelowThreshold)
+{
+    using ::testing::_;
+    using ::testing::ByMove;
+    using ::testing::Return;
+
+    const std::string payload = R"([{"data":"ON","utc":1600000000000}])";
+
+    std::unique_ptr<DataProtocolMock> dataProtocolMock{new DataProtocolMock()};
+    EXPECT_CALL(*dataProtocolMock,
+                makeMessage(_, ::testing::A<const std::vector<std::shared_ptr<wolkabout::Alarm>>&>()))
+      .WillOnce(Return(ByMove(std::unique_ptr<wolkabout::Message>(new wolkabout::Message(payload, "events/KEY")))));
+
+    wolkabout::GzipDataProtocol protocol{std::move(dataProtocolMock), 256};
+
+    const auto message = protocol.makeMessage(
+      "KEY", std::vector<std::shared_ptr<wolkabout::Alarm>>{std::make_shared<wolkabout::Alarm>("ON", "REF", 0)});
+
+    ASSERT_NE(nullptr, message);
+    EXPECT_EQ(payload, message->getContent());
+    EXPECT_EQ("events/KEY", message->getChannel());
+}
+
+TEST_F(GzipTests, ProtocolForwardsInboundMessages)
+{
+    using ::testing::Return;
+
+    std::unique_ptr<DataProtocolMock> dataProtocolMock{new DataProtocolMock()};
+    EXPECT_CALL(*dataProtocolMock, extractReferenceFromChannel("actuators/KEY/REF")).WillOnce(Return("REF"));
+    EXPECT_CALL(*dataProtocolMock, getInboundChannels())
+      .WillOnce(Return(std::vector<std::string>{"actuators/KEY/#"}));
+
+    wolkabout::GzipDataProtocol protocol{std::move(dataProtocolMock)};
+
+    EXPECT_EQ("REF", protocol.extractReferenceFromChannel("actuators/KEY/REF"));
+    EXPECT_EQ(std::vector<std::string>{"actuators/KEY/#"}, protocol.getInboundChannels());
+}
@@ -0,0 +1,330 @@
+/*
+ * Copyright 2020 WolkAbout Technology s.r.o.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "ingestion/IngestionQueue.h"
+#include "utilities/MpscRingBuffer.h"
+
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+class IngestionQueueTests : public ::testing::Test
+{
+};
+
+TEST_F(IngestionQueueTests, RingBufferIsBounded)
+{
+    wolkabout::MpscRingBuffer<int> buffer{3};
+    EXPECT_EQ(4, buffer.capacity());
+    EXPECT_TRUE(buffer.empty());
+
+    for (int i = 0; i < 4; ++i)
+    {
+        int value = i;
+        EXPECT_TRUE(buffer.tryPush(value));
+    }
+
+    int overflow = 4;
+    EXPECT_FALSE(buffer.tryPush(overflow));
+    EXPECT_EQ(4, buffer.size());
+
+    int value = -1;
+    EXPECT_TRUE(buffer.tryPop(value));
+    EXPECT_EQ(0, value);
+    EXPECT_TRUE(buffer.tryPush(overflow));
+
+    std::vector<int> batch;
+    EXPECT_EQ(4, buffer.popBatch(batch, 10));
+    EXPECT_EQ((std::vector<int>{1, 2, 3, 4}), batch);
+    EXPECT_TRUE(buffer.empty());
+    EXPECT_FALSE(buffer.tryPop(value));
+}
+
+TEST_F(IngestionQueueTests, RingBufferMultipleProducers)
+{
+    const int producers = 4;
+    const int itemsPerProducer = 10000;
+
+    wolkabout::MpscRingBuffer<int> buffer{64};
+
+    std::vector<std::thread> threads;
+    for (int producer = 0; producer < producers; ++producer)
+    {
+        threads.emplace_back([&, producer] {
+            for (int i = 0; i < itemsPerProducer; ++i)
+            {
+                int value = producer * itemsPerProducer + i;
+                while (!buffer.tryPush(value))
+                {
+                    std::this_thread::yield();
+                }
+            }
+        });
+    }
+
+    std::vector<int> lastSeen(producers, -1);
+    int received = 0;
+    while (received < producers * itemsPerProducer)
+    {
+        int value;
+        if (!buffer.tryPop(value))
+        {
+            std::this_thread::yield();
+            continue;
+        }
+
+        // items of a single producer are consumed in order
+        const int producer = value / itemsPerProducer;
+        EXPECT_LT(lastSeen[producer], value);
+        lastSeen[producer] = value;
+        ++received;
+    }
+
+    for (auto& thread : threads)
+    {
+        thread.join();
+    }
+
+    EXPECT_TRUE(buffer.empty());
+}
+
+TEST_F(IngestionQueueTests, DeliversRecordsInBatches)
+{
+    std::mutex mutex;
+    std::condition_variable cv;
+    std::vector<std::uint32_t> ids;
+
+    wolkabout::IngestionQueue queue{[&](std::vector<wolkabout::IngestionRecord>& records) {
+                                        std::lock_guard<std::mutex> lock{mutex};
+                                        for (const auto& record : records)
+                                        {
+                                            ids.push_back(record.handle.id);
+                                        }
+                                        cv.notify_one();
+                                    },
+                                    4, 2};
+
+    for (int i = 0; i < 100; ++i)
+    {
+        wolkabout::IngestionRecord record;
+        record.type = wolkabout::IngestionRecord::Type::SENSOR_READING;
+        record.handle.id = static_cast<std::uint32_t>(i);
+        queue.push(std::move(record));
+    }
+
+    std::unique_lock<std::mutex> lock{mutex};
+    ASSERT_TRUE(cv.wait_for(lock, std::chrono::seconds(5), [&] { return ids.size() == 100; }));
+
+    for (int i = 0; i < 100; ++i)
+    {
+        EXPECT_EQ(static_cast<std::uint32_t>(i), ids[static_cast<std::size_t>(i)]);
+    }
+}
+
+TEST_F(IngestionQueueTests, CommandPushedFromWorkerIsNotLost)
+{
+    std::atomic_int executed{0};
+    std::unique_ptr<wolkabout::IngestionQueue> queue;
+
+    queue.reset(new wolkabout::IngestionQueue(
+      [&](std::vector<wolkabout::IngestionRecord>& records) {
+          for (auto& record : records)
+          {
+              record.command();
+          }
+      },
+      2));
+
+    std::function<void()> command = [&] {
+        if (++executed < 10)
+        {
+            // re-enqueue from the worker thread, more often than the queue can hold
+            for (int i = 0; i < 3; ++i)
+            {
+                wolkabout::IngestionRecord record;
+                record.type = wolkabout::IngestionRecord::Type::COMMAND;
+                record.command = [] {};
+                queue->push(std::move(record));
+            }
+
+            wolkabout::IngestionRecord record;
+            record.type = wolkabout::IngestionRecord::Type::COMMAND;
+            record.command = command;
+            queue->push(std::move(record));
+        }
+    };
+
+    wolkabout::IngestionRecord record;
+    record.type = wolkabout::IngestionRecord::Type::COMMAND;
+    record.command = command;
+    queue->push(std::move(record));
+
+    const auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(5);
+    while (executed < 10 && std::chrono::steady_clock::now() < deadline)
+    {
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+
+    EXPECT_EQ(10, executed);
+    queue->stop();
+}
+
+TEST_F(IngestionQueueTests, ControlRecordsPreemptBulkRecords)
+{
+    std::mutex mutex;
+    std::condition_variable cv;
+    const std::uint32_t bulkId = 1;
+    const std::uint32_t controlId = 2;
+    std::vector<std::uint32_t> ids;
+    std::atomic_bool release{false};
+
+    wolkabout::IngestionQueue queue{[&](std::vector<wolkabout::IngestionRecord>& records) {
+                                        while (!release)
+                                        {
+                                            std::this_thread::sleep_for(std::chrono::milliseconds(1));
+                                        }
+
+                                        std::lock_guard<std::mutex> lock{mutex};
+                                        for (const auto& record : records)
+                                        {
+                                            ids.push_back(record.handle.id);
+                                        }
+                                        cv.notify_one();
+                                    },
+                                    64, 1};
+
+    for (int i = 0; i < 10; ++i)
+    {
+        wolkabout::IngestionRecord record;
+        record.handle.id = bulkId;
+        queue.push(std::move(record));
+    }
+
+    wolkabout::IngestionRecord control;
+    control.handle.id = controlId;
+    queue.push(std::move(control), wolkabout::IngestionQueue::Priority::CONTROL);
+
+    release = true;
+
+    std::unique_lock<std::mutex> lock{mutex};
+    ASSERT_TRUE(cv.wait_for(lock, std::chrono::seconds(5), [&] { return ids.size() == 11; }));
+
+    // at most the batch being handled when control record arrived precedes it
+    const auto position = std::find(ids.begin(), ids.end(), controlId) - ids.begin();
+    EXPECT_LE(position, 1);
+
+    EXPECT_EQ(1, queue.getLatency(wolkabout::IngestionQueue::Priority::CONTROL).count);
+    EXPECT_EQ(10, queue.getLatency(wolkabout::IngestionQueue::Priority::BULK).count);
+    EXPECT_GE(queue.getLatency(wolkabout::IngestionQueue::Priority::BULK).max,
+              queue.getLatency(wolkabout::IngestionQueue::Priority::BULK).average());
+}
+
+TEST_F(IngestionQueueTests, ControlRecordsOverflowInsteadOfBlocking)
+{
+    std::mutex mutex;
+    std::condition_variable cv;
+    std::vector<std::uint32_t> ids;
+    std::atomic_bool release{false};
+
+    wolkabout::IngestionQueue queue{[&](std::vector<wolkabout::IngestionRecord>& records) {
+                                        while (!release)
+                                        {
+                                            std::this_thread::sleep_for(std::chrono::milliseconds(1));
+                                        }
+
+                                        std::lock_guard<std::mutex> lock{mutex};
+                                        for (const auto& record : records)
+                                        {
+                                            ids.push_back(record.handle.id);
+                                        }
+                                        cv.notify_one();
+                                    }};
+
+    // worker is held by the handler, so records beyond capacity of the control ring can not be taken off it
+    const auto total = static_cast<std::uint32_t>(3 * wolkabout::IngestionQueue::CONTROL_CAPACITY);
+    for (std::uint32_t i = 0; i < total; ++i)
+    {
+        wolkabout::IngestionRecord record;
+        record.handle.id = i;
+        queue.push(std::move(record), wolkabout::IngestionQueue::Priority::CONTROL);
+    }
+
+    release = true;
+
+    std::unique_lock<std::mutex> lock{mutex};
+    ASSERT_TRUE(cv.wait_for(lock, std::chrono::seconds(5), [&] { return ids.size() == total; }));
+
+    for (std::uint32_t i = 0; i < total; ++i)
+    {
+        EXPECT_EQ(i, ids[i]);
+    }
+}
+
+TEST_F(IngestionQueueTests, ProducersWaitForSpace)
+{
+    std::mutex mutex;
+    std::condition_variable cv;
+    std::vector<std::uint32_t> ids;
+    std::atomic_bool release{false};
+
+    wolkabout::IngestionQueue queue{[&](std::vector<wolkabout::IngestionRecord>& records) {
+                                        while (!release)
+                                        {
+                                            std::this_thread::sleep_for(std::chrono::milliseconds(1));
+                                        }
+
+                                        std::lock_guard<std::mutex> lock{mutex};
+                                        for (const auto& record : records)
+                                        {
+                                            ids.push_back(record.handle.id);
+                                        }
+                                        cv.notify_one();
+                                    },
+                                    2, 1};
+
+    std::atomic_bool pushed{false};
+    std::thread producer{[&] {
+        for (std::uint32_t i = 0; i < 20; ++i)
+        {
+            wolkabout::IngestionRecord record;
+            record.handle.id = i;
+            queue.push(std::move(record));
+        }
+        pushed = true;
+    }};
+
+    // handler holds the worker, so the producer is left waiting for space
+    std::this_thread::sleep_for(std::chrono::milliseconds(50));
+    EXPECT_FALSE(pushed);
+
+    release = true;
+    producer.join();
+
+    std::unique_lock<std::mutex> lock{mutex};
+    ASSERT_TRUE(cv.wait_for(lock, std::chrono::seconds(5), [&] { return ids.size() == 20; }));
+
+    for (std::uint32_t i = 0; i < 20; ++i)
+    {
+        EXPECT_EQ(i, ids[i]);
+    }
+}
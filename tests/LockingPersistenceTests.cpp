@@ -0,0 +1,107 @@
+/*
+ * Copyright 2020 WolkAbout Technology s.r.o.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "mocks/PersistenceMock.h"
+#include "model/SensorReading.h"
+#include "persistence/LockingPersistence.h"
+
+#include <gmock/gmock.h>
+#include <gtest/gtest.h>
+
+#include <atomic>
+#include <chrono>
+#include <memory>
+#include <thread>
+#include <vector>
+
+class LockingPersistenceTests : public ::testing::Test
+{
+public:
+    void SetUp() override
+    {
+        persistenceMock.reset(new ::testing::NiceMock<PersistenceMock>());
+        persistence.reset(new wolkabout::LockingPersistence(persistenceMock));
+    }
+
+    std::shared_ptr<PersistenceMock> persistenceMock;
+    std::unique_ptr<wolkabout::LockingPersistence> persistence;
+};
+
+TEST_F(LockingPersistenceTests, ForwardsCalls)
+{
+    EXPECT_CALL(*persistenceMock, putSensorReading("REF", ::testing::_)).WillOnce(::testing::Return(true));
+    EXPECT_CALL(*persistenceMock, getSensorReadingsKeys())
+      .WillOnce(::testing::Return(std::vector<std::string>{"REF"}));
+    EXPECT_CALL(*persistenceMock, removeSensorReadings("REF", 1)).Times(1);
+    EXPECT_CALL(*persistenceMock, isEmpty()).WillOnce(::testing::Return(true));
+
+    EXPECT_TRUE(persistence->putSensorReading("REF", std::make_shared<wolkabout::SensorReading>("1", "REF", 0)));
+    EXPECT_EQ(persistence->getSensorReadingsKeys(), std::vector<std::string>{"REF"});
+    persistence->removeSensorReadings("REF", 1);
+    EXPECT_TRUE(persistence->isEmpty());
+}
+
+TEST_F(LockingPersistenceTests, SerializesCalls)
+{
+    std::atomic<int> inProgress{0};
+    std::atomic<int> maxInProgress{0};
+
+    auto track = [&] {
+        const auto current = ++inProgress;
+        if (current > maxInProgress)
+        {
+            maxInProgress = current;
+        }
+
+        std::this_thread::sleep_for(std::chrono::milliseconds{1});
+        --inProgress;
+    };
+
+    ON_CALL(*persistenceMock, putSensorReading(::testing::_, ::testing::_))
+      .WillByDefault(::testing::DoAll(::testing::InvokeWithoutArgs(track), ::testing::Return(true)));
+    ON_CALL(*persistenceMock, putActuatorStatus(::testing::_, ::testing::_))
+      .WillByDefault(::testing::DoAll(::testing::InvokeWithoutArgs(track), ::testing::Return(true)));
+    ON_CALL(*persistenceMock, getSensorReadingsKeys())
+      .WillByDefault(::testing::DoAll(::testing::InvokeWithoutArgs(track),
+                                      ::testing::Return(std::vector<std::string>{})));
+
+    std::vector<std::thread> threads;
+    threads.emplace_back([&] {
+        for (int i = 0; i < 20; ++i)
+        {
+            persistence->putSensorReading("REF", std::make_shared<wolkabout::SensorReading>("1", "REF", 0));
+        }
+    });
+    threads.emplace_back([&] {
+        for (int i = 0; i < 20; ++i)
+        {
+            persistence->putActuatorStatus("ACT", nullptr);
+        }
+    });
+    threads.emplace_back([&] {
+        for (int i = 0; i < 20; ++i)
+        {
+            persistence->getSensorReadingsKeys();
+        }
+    });
+
+    for (auto& thread : threads)
+    {
+        thread.join();
+    }
+
+    EXPECT_EQ(maxInProgress, 1);
+}
@@ -0,0 +1,145 @@
+/*
+ * Copyright 2020 WolkAbout Technology s.r.o.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "model/ReadingValue.h"
+#include "model/SensorReading.h"
+#include "persistence/inmemory/InMemoryTypedPersistence.h"
+#include "utilities/StringUtils.h"
+
+#include <gtest/gtest.h>
+
+#include <memory>
+#include <string>
+#include <vector>
+
+class ReadingValueTests : public ::testing::Test
+{
+};
+
+TEST_F(ReadingValueTests, NumericValuesAreFormattedLikeStringUtils)
+{
+    using wolkabout::ReadingValue;
+    using wolkabout::StringUtils;
+
+    EXPECT_EQ(StringUtils::toString(true), ReadingValue{true}.toString());
+    EXPECT_EQ(StringUtils::toString(-42), ReadingValue{-42}.toString());
+    EXPECT_EQ(StringUtils::toString(-42l), ReadingValue{-42l}.toString());
+    EXPECT_EQ(StringUtils::toString(-42ll), ReadingValue{-42ll}.toString());
+    EXPECT_EQ(StringUtils::toString(42u), ReadingValue{42u}.toString());
+    EXPECT_EQ(StringUtils::toString(42ul), ReadingValue{42ul}.toString());
+    EXPECT_EQ(StringUtils::toString(42ull), ReadingValue{42ull}.toString());
+    EXPECT_EQ(StringUtils::toString(1.25f), ReadingValue{1.25f}.toString());
+    EXPECT_EQ(StringUtils::toString(3.14159), ReadingValue{3.14159}.toString());
+
+    const ReadingValue value{3.5};
+    EXPECT_TRUE(value.isNumeric());
+    EXPECT_FALSE(value.isMultiValue());
+    EXPECT_EQ(ReadingValue::Type::DOUBLE, value.getType());
+    EXPECT_EQ(1, value.size());
+    EXPECT_DOUBLE_EQ(3.5, value.toDouble());
+}
+
+TEST_F(ReadingValueTests, MultiValueReadings)
+{
+    using wolkabout::ReadingValue;
+
+    const ReadingValue numeric{std::vector<int>{1, 2, 3}};
+    EXPECT_TRUE(numeric.isNumeric());
+    EXPECT_TRUE(numeric.isMultiValue());
+    EXPECT_EQ((std::vector<std::string>{"1", "2", "3"}), numeric.toStrings());
+
+    // Arrays longer than MAX_NUMERIC_VALUES are kept as text
+    const ReadingValue longArray{std::vector<int>{1, 2, 3, 4, 5}};
+    EXPECT_FALSE(longArray.isNumeric());
+    EXPECT_TRUE(longArray.isMultiValue());
+    EXPECT_EQ((std::vector<std::string>{"1", "2", "3", "4", "5"}), longArray.toStrings());
+
+    const ReadingValue text{std::vector<std::string>{"A", "B"}};
+    EXPECT_FALSE(text.isNumeric());
+    EXPECT_EQ(2, text.size());
+    EXPECT_EQ("B", text.toString(1));
+
+    EXPECT_EQ(numeric, ReadingValue(std::vector<int>{1, 2, 3}));
+    EXPECT_NE(numeric, ReadingValue(std::vector<long>{1, 2, 3}));
+}
+
+TEST_F(ReadingValueTests, TypedPersistenceFormatsOnRetrieval)
+{
+    wolkabout::InMemoryTypedPersistence persistence;
+    EXPECT_TRUE(persistence.isEmpty());
+
+    EXPECT_TRUE(persistence.putSensorReading("T", wolkabout::ReadingValue{21}, 1));
+    EXPECT_TRUE(persistence.putSensorReading("T", wolkabout::ReadingValue{std::vector<double>{1.5, 2.5}}, 2));
+
+    auto plain = std::make_shared<wolkabout::SensorReading>("TEXT", "T", 3);
+    EXPECT_TRUE(persistence.putSensorReading("T", plain));
+
+    EXPECT_FALSE(persistence.isEmpty());
+    EXPECT_EQ((std::vector<std::string>{"T"}), persistence.getSensorReadingsKeys());
+
+    const auto readings = persistence.getSensorReadings("T", 10);
+    ASSERT_EQ(3, readings.size());
+
+    EXPECT_EQ("21", readings[0]->getValue());
+    EXPECT_EQ("T", readings[0]->getReference());
+    EXPECT_EQ(1, readings[0]->getRtc());
+
+    EXPECT_EQ(wolkabout::ReadingValue(std::vector<double>{1.5, 2.5}).toStrings(), readings[1]->getValues());
+    EXPECT_EQ(plain, readings[2]);
+
+    // Readings are formatted only once, retrying a publish yields the same objects
+    EXPECT_EQ(readings, persistence.getSensorReadings("T", 10));
+
+    persistence.removeSensorReadings("T", 2);
+    ASSERT_EQ(1, persistence.getSensorReadings("T", 10).size());
+
+    persistence.removeSensorReadings("T", 10);
+    EXPECT_TRUE(persistence.getSensorReadingsKeys().empty());
+    EXPECT_TRUE(persistence.isEmpty());
+}
+
+TEST_F(ReadingValueTests, TypedPersistenceStoresBatches)
+{
+    wolkabout::InMemoryTypedPersistence persistence;
+
+    EXPECT_TRUE(persistence.putSensorReadings({{"A", 1, 10}, {"B", 2.5, 10}, {"A", 3, 20}}));
+    EXPECT_EQ((std::vector<std::string>{"A", "B"}), persistence.getSensorReadingsKeys());
+
+    const auto readings = persistence.getSensorReadings("A", 10);
+    ASSERT_EQ(2, readings.size());
+    EXPECT_EQ("1", readings[0]->getValue());
+    EXPECT_EQ(10, readings[0]->getRtc());
+    EXPECT_EQ("3", readings[1]->getValue());
+    EXPECT_EQ(20, readings[1]->getRtc());
+}
+
+TEST_F(ReadingValueTests, TypedPersistenceStoresByHandle)
+{
+    wolkabout::InMemoryTypedPersistence persistence;
+
+    const auto handle = persistence.getReferenceRegistry().intern("A");
+    EXPECT_TRUE(persistence.putSensorReading(handle, wolkabout::ReadingValue{7}, 10));
+    EXPECT_TRUE(persistence.putSensorReading("A", wolkabout::ReadingValue{8}, 20));
+    EXPECT_FALSE(persistence.putSensorReading(wolkabout::ReferenceHandle{}, wolkabout::ReadingValue{9}, 30));
+
+    EXPECT_EQ((std::vector<std::string>{"A"}), persistence.getSensorReadingsKeys());
+
+    const auto readings = persistence.getSensorReadings("A", 10);
+    ASSERT_EQ(2, readings.size());
+    EXPECT_EQ("A", readings[0]->getReference());
+    EXPECT_EQ("7", readings[0]->getValue());
+    EXPECT_EQ("8", readings[1]->getValue());
+}
@@ -0,0 +1,110 @@
+/*
+ * Copyright 2020 WolkAbout Technology s.r.o.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "model/Message.h"
+#include "model/SensorReading.h"
+#include "protocol/json/JsonProtocol.h"
+#include "protocol/json/StreamingJsonProtocol.h"
+#include "utilities/JsonWriter.h"
+
+#include <gtest/gtest.h>
+
+#include <cstdint>
+#include <limits>
+#include <memory>
+#include <string>
+#include <vector>
+
+class StreamingJsonProtocolTests : public ::testing::Test
+{
+};
+
+TEST_F(StreamingJsonProtocolTests, WriterSeparatesAndEscapes)
+{
+    std::string buffer;
+    wolkabout::JsonWriter writer{buffer};
+
+    writer.beginObject()
+      .key("array")
+      .beginArray()
+      .value(std::uint64_t{0})
+      .value(std::numeric_limits<std::int64_t>::min())
+      .value(true)
+      .null()
+      .beginObject()
+      .endObject()
+      .beginArray()
+      .endArray()
+      .endArray()
+      .key("esc\"aped")
+      .value(std::string("\"\\\b\f\n\r\t\x01\x1f/\xc3\xa9", 12))
+      .key("joined")
+      .beginString()
+      .appendString("1")
+      .appendString(',')
+      .appendString("\n")
+      .endString()
+      .endObject();
+
+    EXPECT_EQ(R"({"array":[0,-9223372036854775808,true,null,{},[]],"esc\"aped":"\"\\\b\f\n\r\t\u0001\u001f/)"
+              "\xc3\xa9"
+              R"(","joined":"1,\n"})",
+              buffer);
+}
+
+TEST_F(StreamingJsonProtocolTests, WriterRejectsUnbalancedNesting)
+{
+    std::string buffer;
+    wolkabout::JsonWriter writer{buffer};
+
+    EXPECT_THROW(writer.endObject(), std::logic_error);
+
+    for (std::size_t i = 0; i < wolkabout::JsonWriter::MAX_DEPTH; ++i)
+    {
+        writer.beginArray();
+    }
+    EXPECT_THROW(writer.beginArray(), std::length_error);
+}
+
+TEST_F(StreamingJsonProtocolTests, SensorReadingMessagesMatchJsonProtocol)
+{
+    const wolkabout::JsonProtocol jsonProtocol;
+    const wolkabout::StreamingJsonProtocol streamingProtocol;
+
+    const std::vector<std::vector<std::shared_ptr<wolkabout::SensorReading>>> batches{
+      {std::make_shared<wolkabout::SensorReading>("23.5", "T", 1600000000000)},
+      {std::make_shared<wolkabout::SensorReading>("23.5", "T", 1600000000000),
+       std::make_shared<wolkabout::SensorReading>("1013", "P", 1600000000001),
+       std::make_shared<wolkabout::SensorReading>("24", "T", 1600000000002),
+       std::make_shared<wolkabout::SensorReading>("", "A", 0),
+       std::make_shared<wolkabout::SensorReading>(std::vector<std::string>{"1", "-2", "3.5"}, "ACL", 1600000000003)},
+      {std::make_shared<wolkabout::SensorReading>("quote \" backslash \\ newline \n", "S\"TR", 1),
+       std::make_shared<wolkabout::SensorReading>("\xc5\xa1\xc4\x8d", "UTF", 2)}};
+
+    for (const auto& batch : batches)
+    {
+        const auto expected = jsonProtocol.makeMessage("DEVICE_KEY", batch);
+        const auto actual = streamingProtocol.makeMessage("DEVICE_KEY", batch);
+
+        ASSERT_NE(nullptr, expected);
+        ASSERT_NE(nullptr, actual);
+        EXPECT_EQ(expected->getChannel(), actual->getChannel());
+        EXPECT_EQ(expected->getContent(), actual->getContent());
+    }
+
+    EXPECT_EQ(nullptr,
+              streamingProtocol.makeMessage("DEVICE_KEY", std::vector<std::shared_ptr<wolkabout::SensorReading>>{}));
+}
@@ -0,0 +1,58 @@
+/*
+ * Copyright 2020 WolkAbout Technology s.r.o.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "utilities/SyncState.h"
+
+#include <gtest/gtest.h>
+
+#include <string>
+#include <vector>
+
+class SyncStateTests : public ::testing::Test
+{
+};
+
+TEST_F(SyncStateTests, StateIsChangedUntilAcknowledged)
+{
+    wolkabout::SyncState state;
+
+    const auto hash = wolkabout::SyncState::hash({"VALUE", "0"});
+    EXPECT_TRUE(state.hasChanged("actuator/REF1", hash));
+
+    state.acknowledged("actuator/REF1", hash);
+    EXPECT_FALSE(state.hasChanged("actuator/REF1", hash));
+    EXPECT_TRUE(state.hasChanged("actuator/REF1", wolkabout::SyncState::hash({"OTHER", "0"})));
+    EXPECT_TRUE(state.hasChanged("actuator/REF2", hash));
+}
+
+TEST_F(SyncStateTests, InvalidateForgetsAcknowledgedState)
+{
+    wolkabout::SyncState state;
+
+    const auto hash = wolkabout::SyncState::hash({"ITEM1", "ITEM2"});
+    state.acknowledged("configuration", hash);
+
+    state.invalidate();
+    EXPECT_TRUE(state.hasChanged("configuration", hash));
+}
+
+TEST_F(SyncStateTests, HashDependsOnOrderAndSplitOfValues)
+{
+    EXPECT_EQ(wolkabout::SyncState::hash({"A", "B"}), wolkabout::SyncState::hash({"A", "B"}));
+    EXPECT_NE(wolkabout::SyncState::hash({"A", "B"}), wolkabout::SyncState::hash({"B", "A"}));
+    EXPECT_NE(wolkabout::SyncState::hash({"AB"}), wolkabout::SyncState::hash({"A", "B"}));
+    EXPECT_NE(wolkabout::SyncState::hash({}), wolkabout::SyncState::hash({""}));
+}
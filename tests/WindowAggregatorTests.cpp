@@ -0,0 +1,97 @@
+/*
+ * Copyright 2020 WolkAbout Technology s.r.o.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "ingestion/WindowAggregator.h"
+#include "model/ReadingEntry.h"
+#include "model/ReadingValue.h"
+#include "utilities/ReferenceRegistry.h"
+
+#include <gtest/gtest.h>
+
+#include <chrono>
+#include <string>
+#include <vector>
+
+class WindowAggregatorTests : public ::testing::Test
+{
+};
+
+TEST_F(WindowAggregatorTests, EmitsStatisticsPerWindow)
+{
+    wolkabout::Aggregation aggregation;
+    aggregation.window = std::chrono::milliseconds{1000};
+
+    wolkabout::WindowAggregator aggregator;
+    aggregator.setAggregation("REF", aggregation);
+
+    std::vector<wolkabout::ReadingEntry> closed;
+
+    EXPECT_TRUE(aggregator.add("REF", wolkabout::ReadingValue{4}, 1100, closed));
+    EXPECT_TRUE(aggregator.add("REF", wolkabout::ReadingValue{1}, 1500, closed));
+    EXPECT_TRUE(aggregator.add("REF", wolkabout::ReadingValue{7.5}, 1999, closed));
+    EXPECT_TRUE(closed.empty());
+
+    EXPECT_TRUE(aggregator.add("REF", wolkabout::ReadingValue{10}, 2000, closed));
+    ASSERT_EQ(1, closed.size());
+    EXPECT_EQ("REF", closed[0].reference);
+    EXPECT_EQ(1000, closed[0].rtc);
+    EXPECT_TRUE(closed[0].value.isMultiValue());
+    EXPECT_DOUBLE_EQ(1, closed[0].value.toDouble(0));
+    EXPECT_DOUBLE_EQ(7.5, closed[0].value.toDouble(1));
+    EXPECT_DOUBLE_EQ(12.5 / 3, closed[0].value.toDouble(2));
+    EXPECT_DOUBLE_EQ(3, closed[0].value.toDouble(3));
+
+    aggregator.closeExpired(2999, closed);
+    EXPECT_EQ(1, closed.size());
+
+    aggregator.closeExpired(3000, closed);
+    ASSERT_EQ(2, closed.size());
+    EXPECT_EQ(2000, closed[1].rtc);
+    EXPECT_EQ((std::vector<std::string>{"10", "10", "10", "1"}), closed[1].value.toStrings());
+
+    aggregator.closeExpired(10000, closed);
+    EXPECT_EQ(2, closed.size());
+}
+
+TEST_F(WindowAggregatorTests, PassesOtherReadings)
+{
+    wolkabout::Aggregation aggregation;
+    aggregation.window = std::chrono::milliseconds{100};
+    aggregation.statistics = {wolkabout::Statistic::COUNT, wolkabout::Statistic::MAX};
+
+    wolkabout::WindowAggregator aggregator;
+    aggregator.setAggregation("REF", aggregation);
+
+    std::vector<wolkabout::ReadingEntry> closed;
+
+    EXPECT_FALSE(aggregator.add("OTHER", wolkabout::ReadingValue{1}, 10, closed));
+    EXPECT_FALSE(aggregator.add("REF", wolkabout::ReadingValue{std::string{"TEXT"}}, 10, closed));
+    EXPECT_FALSE(aggregator.add("REF", wolkabout::ReadingValue{std::vector<int>{1, 2}}, 10, closed));
+
+    wolkabout::ReferenceRegistry registry;
+    const auto other = registry.intern("OTHER");
+    const auto handle = registry.intern("REF");
+    aggregator.bind(handle, "REF");
+    aggregator.bind(other, "OTHER");
+
+    EXPECT_FALSE(aggregator.add(other, wolkabout::ReadingValue{1}, 10, closed));
+    EXPECT_TRUE(aggregator.add(handle, wolkabout::ReadingValue{3}, 10, closed));
+    EXPECT_TRUE(aggregator.add("REF", wolkabout::ReadingValue{5}, 20, closed));
+
+    aggregator.closeExpired(100, closed);
+    ASSERT_EQ(1, closed.size());
+    EXPECT_EQ((std::vector<std::string>{"2", "5"}), closed[0].value.toStrings());
+}
@@ -23,6 +23,7 @@
 #include "model/ConfigurationSetCommand.h"
 #include "model/Message.h"
 #include "protocol/DataProtocol.h"
+#include "service/data/DataService.h"
 #undef private
 #undef protected
 
@@ -30,13 +31,19 @@
 #include "mocks/ActuatorStatusProviderMock.h"
 #include "mocks/ConfigurationHandlerMock.h"
 #include "mocks/ConfigurationProviderMock.h"
+#include "mocks/ConnectivityServiceMock.h"
 #include "mocks/DataProtocolMock.h"
 #include "mocks/PersistenceMock.h"
+#include "persistence/inmemory/InMemoryTypedPersistence.h"
 
 #include <gmock/gmock.h>
 #include <gtest/gtest.h>
 
+#include <algorithm>
 #include <iostream>
+#include <memory>
+#include <string>
+#include <vector>
 
 class WolkBuilderTests : public ::testing::Test
 {
@@ -272,3 +279,127 @@ TEST_F(WolkBuilderTests, NullChecks)
 
     EXPECT_THROW(builder->build(), std::logic_error);
 }
+
+TEST_F(WolkBuilderTests, BufferLimits)
+{
+    const auto& testDevice =
+      std::make_shared<wolkabout::Device>("TEST_KEY", "TEST_PASSWORD", std::vector<std::string>());
+
+    wolkabout::BufferLimits limits;
+    limits.maxReadings = 100;
+    limits.policy = wolkabout::OverflowPolicy::DROP_NEWEST;
+
+    std::shared_ptr<wolkabout::WolkBuilder> builder;
+    ASSERT_NO_THROW(builder = std::make_shared<wolkabout::WolkBuilder>(*testDevice));
+    ASSERT_NO_THROW(builder->withBufferLimits(limits));
+
+    std::shared_ptr<PersistenceMock> persistenceMock;
+    persistenceMock.reset(new ::testing::NiceMock<PersistenceMock>());
+    ASSERT_NO_THROW(builder->withPersistence(persistenceMock));
+
+    // Limits are only enforced by typed persistence
+    EXPECT_THROW(builder->build(), std::logic_error);
+}
+
+TEST_F(WolkBuilderTests, InvalidBufferLimits)
+{
+    const auto& testDevice =
+      std::make_shared<wolkabout::Device>("TEST_KEY", "TEST_PASSWORD", std::vector<std::string>());
+
+    std::shared_ptr<wolkabout::WolkBuilder> builder;
+    ASSERT_NO_THROW(builder = std::make_shared<wolkabout::WolkBuilder>(*testDevice));
+
+    wolkabout::BufferLimits unlimited;
+    unlimited.policy = wolkabout::OverflowPolicy::BLOCK;
+    EXPECT_THROW(builder->withBufferLimits(unlimited), std::logic_error);
+
+    wolkabout::BufferLimits sample;
+    sample.maxReadings = 100;
+    sample.policy = wolkabout::OverflowPolicy::SAMPLE;
+    sample.sampleStride = 0;
+    EXPECT_THROW(builder->withBufferLimits(sample), std::logic_error);
+
+    wolkabout::BufferLimits block;
+    block.maxReadings = 100;
+    block.policy = wolkabout::OverflowPolicy::BLOCK;
+    block.blockTimeout = std::chrono::milliseconds{0};
+    EXPECT_THROW(builder->withBufferLimits(block), std::logic_error);
+
+    block.blockTimeout = std::chrono::milliseconds{10};
+    EXPECT_NO_THROW(builder->withBufferLimits(block));
+}
+
+TEST_F(WolkBuilderTests, InvalidAggregation)
+{
+    const auto& testDevice =
+      std::make_shared<wolkabout::Device>("TEST_KEY", "TEST_PASSWORD", std::vector<std::string>());
+
+    std::shared_ptr<wolkabout::WolkBuilder> builder;
+    ASSERT_NO_THROW(builder = std::make_shared<wolkabout::WolkBuilder>(*testDevice));
+
+    wolkabout::Aggregation noWindow;
+    EXPECT_THROW(builder->withAggregation("REF", noWindow), std::logic_error);
+
+    wolkabout::Aggregation noStatistics;
+    noStatistics.window = std::chrono::seconds{1};
+    noStatistics.statistics.clear();
+    EXPECT_THROW(builder->withAggregation("REF", noStatistics), std::logic_error);
+
+    wolkabout::Aggregation tooManyStatistics;
+    tooManyStatistics.window = std::chrono::seconds{1};
+    tooManyStatistics.statistics = {wolkabout::Statistic::MIN, wolkabout::Statistic::MAX,
+                                    wolkabout::Statistic::AVERAGE, wolkabout::Statistic::COUNT,
+                                    wolkabout::Statistic::MIN};
+    EXPECT_THROW(builder->withAggregation("REF", tooManyStatistics), std::logic_error);
+
+    wolkabout::Aggregation valid;
+    valid.window = std::chrono::seconds{1};
+    EXPECT_NO_THROW(builder->withAggregation("REF", valid));
+}
+
+TEST_F(WolkBuilderTests, ActuatorStatusesOfDefaultProtocolAreNotPacked)
+{
+    const auto& testDevice =
+      std::make_shared<wolkabout::Device>("TEST_KEY", "TEST_PASSWORD", std::vector<std::string>{"A1", "A2"});
+
+    std::shared_ptr<wolkabout::WolkBuilder> builder;
+    ASSERT_NO_THROW(builder = std::make_shared<wolkabout::WolkBuilder>(*testDevice));
+    ASSERT_NO_THROW(builder->actuationHandler([](const std::string&, const std::string&) {}));
+    ASSERT_NO_THROW(builder->actuatorStatusProvider([](const std::string& reference) {
+        return wolkabout::ActuatorStatus(reference, wolkabout::ActuatorStatus::State::READY);
+    }));
+
+    const auto& wolk = builder->build();
+
+    // default protocol names the actuator in the channel, so each status needs a message of its own
+    EXPECT_FALSE(wolk->m_dataService->m_actuatorStatusBatching);
+
+    // data service set up as the built one, with the built protocol, publishing to a mock instead of the broker
+    ::testing::NiceMock<ConnectivityServiceMock> connectivityServiceMock;
+    wolkabout::InMemoryTypedPersistence persistence;
+    wolkabout::DataService dataService{testDevice->getKey(), *wolk->m_dataProtocol, persistence,
+                                       connectivityServiceMock, nullptr, nullptr, nullptr, nullptr};
+    dataService.setPublishBatching(wolk->m_dataService->m_publishBatchItemsCount,
+                                   wolk->m_dataService->m_crossReferenceBatching);
+    dataService.setActuatorStatusBatching(wolk->m_dataService->m_actuatorStatusBatching);
+
+    std::vector<std::string> channels;
+    EXPECT_CALL(connectivityServiceMock, publish)
+      .WillRepeatedly(::testing::Invoke([&](std::shared_ptr<wolkabout::Message> message, bool) {
+          channels.push_back(message->getChannel());
+          return true;
+      }));
+
+    dataService.addActuatorStatus("A1", "1", wolkabout::ActuatorStatus::State::READY);
+    dataService.addActuatorStatus("A2", "2", wolkabout::ActuatorStatus::State::READY);
+
+    const auto counts = dataService.publishActuatorStatuses();
+    EXPECT_EQ(2, counts.sent);
+    EXPECT_EQ(2, counts.messages);
+
+    // both statuses reach the wire, each on the channel of its actuator
+    ASSERT_EQ(2, channels.size());
+    std::sort(channels.begin(), channels.end());
+    EXPECT_EQ("A1", channels[0].substr(channels[0].rfind('/') + 1));
+    EXPECT_EQ("A2", channels[1].substr(channels[1].rfind('/') + 1));
+}
@@ -71,9 +71,23 @@ public:
     void waitEvents(int eventCount = 1, std::chrono::milliseconds period = std::chrono::milliseconds{500})
     {
         std::unique_lock<std::mutex> lock{mutex};
-        eventsToWait = eventCount;
+        eventsToWait += eventCount;
         EXPECT_TRUE(cv.wait_for(lock, period, [this] { return eventsToWait <= 0; }));
     }
+
+    // Waits until work queued on the egress lane, the control lane, and the egress lane again, is done
+    void waitForLanes(wolkabout::Wolk& wolk)
+    {
+        wolk.addToEgressQueue(
+          [&] {
+              wolk.addToControlQueue([&] {
+                  wolk.addToEgressQueue([&] { onEvent(); }, wolkabout::IngestionQueue::Priority::CONTROL);
+              });
+          },
+          wolkabout::IngestionQueue::Priority::CONTROL);
+
+        waitEvents(1);
+    }
 };
 
 TEST_F(WolkTests, Notifies)
@@ -158,7 +172,7 @@ TEST_F(WolkTests, WhenConnected_PublishFileList)
     ON_CALL(dynamic_cast<ConnectivityServiceMock&>(*(wolk->m_connectivityService)), connect)
       .WillByDefault(testing::Return(true));
 
-    EXPECT_CALL(dynamic_cast<FileDownloadServiceMock&>(*(wolk->m_fileDownloadService)), sendFileList)
+    EXPECT_CALL(dynamic_cast<FileDownloadServiceMock&>(*(wolk->m_fileDownloadService)), syncFileList)
       .WillOnce(testing::InvokeWithoutArgs(this, &WolkTests::onEvent));
 
     EXPECT_NO_FATAL_FAILURE(wolk->connect());
@@ -166,6 +180,123 @@ TEST_F(WolkTests, WhenConnected_PublishFileList)
     waitEvents(1);
 }
 
+TEST_F(WolkTests, WhenReconnected_PublishOnlyChangedState)
+{
+    builder = std::make_shared<wolkabout::WolkBuilder>(*device);
+
+    std::string actuatorValue = "1";
+    std::string configurationValue = "10";
+    builder->actuationHandler([](const std::string&, const std::string&) {});
+    builder->actuatorStatusProvider([&](const std::string& reference) {
+        return wolkabout::ActuatorStatus(reference == "A2" ? actuatorValue : "0",
+                                         wolkabout::ActuatorStatus::State::READY);
+    });
+    builder->configurationHandler([](const std::vector<wolkabout::ConfigurationItem>&) {});
+    builder->configurationProvider([&]() -> std::vector<wolkabout::ConfigurationItem> {
+        return {wolkabout::ConfigurationItem({configurationValue}, "HB")};
+    });
+    ASSERT_NO_THROW(builder->withoutKeepAlive());
+
+    const auto& wolk = builder->build();
+
+    auto connectivityServiceMock =
+      std::unique_ptr<ConnectivityServiceMock>(new ::testing::NiceMock<ConnectivityServiceMock>());
+    auto dataProtocolMock = std::unique_ptr<DataProtocolMock>(new ::testing::NiceMock<DataProtocolMock>());
+    auto persistenceMock = std::unique_ptr<PersistenceMock>(new ::testing::NiceMock<PersistenceMock>());
+    auto dataServiceMock = std::unique_ptr<DataServiceMock>(new ::testing::NiceMock<DataServiceMock>(
+      device->getKey(), *dataProtocolMock, *persistenceMock, *connectivityServiceMock));
+
+    wolk->m_dataService = std::move(dataServiceMock);
+    wolk->m_connectivityService = std::move(connectivityServiceMock);
+    wolk->m_fileDownloadService =
+      std::make_shared<::testing::NiceMock<FileDownloadServiceMock>>(device->getKey(), m_downloadProtocol, "", 0,
+                                                                     *wolk->m_connectivityService,
+                                                                     *m_fileRepositoryMock, nullptr);
+
+    std::vector<std::string> actuatorStatuses;
+    int configurations = 0;
+    EXPECT_CALL(dynamic_cast<DataServiceMock&>(*(wolk->m_dataService)), addActuatorStatus)
+      .WillRepeatedly(
+        testing::Invoke([&](const std::string& reference, const std::string&, wolkabout::ActuatorStatus::State) {
+            actuatorStatuses.push_back(reference);
+        }));
+    EXPECT_CALL(dynamic_cast<DataServiceMock&>(*(wolk->m_dataService)), addConfiguration)
+      .WillRepeatedly(testing::InvokeWithoutArgs([&] { ++configurations; }));
+
+    wolk->notifyConnected();
+    waitForLanes(*wolk);
+    EXPECT_EQ((std::vector<std::string>{"A1", "A2", "A3"}), actuatorStatuses);
+    EXPECT_EQ(1, configurations);
+
+    // Acknowledged state is not published again
+    actuatorStatuses.clear();
+    configurations = 0;
+    wolk->notifyConnected();
+    waitForLanes(*wolk);
+    EXPECT_TRUE(actuatorStatuses.empty());
+    EXPECT_EQ(0, configurations);
+
+    actuatorStatuses.clear();
+    configurations = 0;
+    actuatorValue = "2";
+    configurationValue = "20";
+    wolk->notifyConnected();
+    waitForLanes(*wolk);
+    EXPECT_EQ((std::vector<std::string>{"A2"}), actuatorStatuses);
+    EXPECT_EQ(1, configurations);
+}
+
+TEST_F(WolkTests, ResyncStatePublishesAcknowledgedState)
+{
+    builder = std::make_shared<wolkabout::WolkBuilder>(*device);
+
+    builder->actuationHandler([](const std::string&, const std::string&) {});
+    builder->actuatorStatusProvider([](const std::string&) {
+        return wolkabout::ActuatorStatus("0", wolkabout::ActuatorStatus::State::READY);
+    });
+    builder->configurationHandler([](const std::vector<wolkabout::ConfigurationItem>&) {});
+    builder->configurationProvider([]() -> std::vector<wolkabout::ConfigurationItem> {
+        return {wolkabout::ConfigurationItem({"10"}, "HB")};
+    });
+    ASSERT_NO_THROW(builder->withoutKeepAlive());
+
+    const auto& wolk = builder->build();
+
+    auto connectivityServiceMock =
+      std::unique_ptr<ConnectivityServiceMock>(new ::testing::NiceMock<ConnectivityServiceMock>());
+    auto dataProtocolMock = std::unique_ptr<DataProtocolMock>(new ::testing::NiceMock<DataProtocolMock>());
+    auto persistenceMock = std::unique_ptr<PersistenceMock>(new ::testing::NiceMock<PersistenceMock>());
+    auto dataServiceMock = std::unique_ptr<DataServiceMock>(new ::testing::NiceMock<DataServiceMock>(
+      device->getKey(), *dataProtocolMock, *persistenceMock, *connectivityServiceMock));
+
+    wolk->m_dataService = std::move(dataServiceMock);
+    wolk->m_connectivityService = std::move(connectivityServiceMock);
+    wolk->m_fileDownloadService =
+      std::make_shared<::testing::NiceMock<FileDownloadServiceMock>>(device->getKey(), m_downloadProtocol, "", 0,
+                                                                     *wolk->m_connectivityService,
+                                                                     *m_fileRepositoryMock, nullptr);
+
+    int actuatorStatuses = 0;
+    int configurations = 0;
+    EXPECT_CALL(dynamic_cast<DataServiceMock&>(*(wolk->m_dataService)), addActuatorStatus)
+      .WillRepeatedly(testing::InvokeWithoutArgs([&] { ++actuatorStatuses; }));
+    EXPECT_CALL(dynamic_cast<DataServiceMock&>(*(wolk->m_dataService)), addConfiguration)
+      .WillRepeatedly(testing::InvokeWithoutArgs([&] { ++configurations; }));
+    EXPECT_CALL(dynamic_cast<FileDownloadServiceMock&>(*(wolk->m_fileDownloadService)), sendFileList).Times(1);
+
+    wolk->notifyConnected();
+    waitForLanes(*wolk);
+    EXPECT_EQ(3, actuatorStatuses);
+    EXPECT_EQ(1, configurations);
+
+    actuatorStatuses = 0;
+    configurations = 0;
+    wolk->resyncState();
+    waitForLanes(*wolk);
+    EXPECT_EQ(3, actuatorStatuses);
+    EXPECT_EQ(1, configurations);
+}
+
 TEST_F(WolkTests, DisconnectTest)
 {
     builder = std::make_shared<wolkabout::WolkBuilder>(*noActuatorsDevice);
@@ -199,14 +330,23 @@ TEST_F(WolkTests, AddingSensors)
 
     wolk->m_dataService = std::move(dataServiceMock);
 
-    EXPECT_CALL(
-      dynamic_cast<DataServiceMock&>(*(wolk->m_dataService)),
-      addSensorReading(Matcher<const std::string&>(_), Matcher<const std::string&>(_), Matcher<unsigned long long>(_)))
+    const wolkabout::ReadingValue singleValue{100};
+    const wolkabout::ReadingValue multiValue{std::vector<int>{1, 2, 3}};
+
+    // readings added by reference are interned and reach the data service by handle
+    const auto firstHandle = wolk->m_dataService->registerReference("TEST_REF1");
+    const auto secondHandle = wolk->m_dataService->registerReference("TEST_REF2");
+
+    EXPECT_CALL(dynamic_cast<DataServiceMock&>(*(wolk->m_dataService)),
+                addSensorReading(Matcher<wolkabout::ReferenceHandle>(firstHandle),
+                                 Matcher<const wolkabout::ReadingValue&>(singleValue),
+                                 Matcher<unsigned long long>(_)))
       .Times(1)
       .WillRepeatedly(testing::InvokeWithoutArgs(this, &WolkTests::onEvent));
 
     EXPECT_CALL(dynamic_cast<DataServiceMock&>(*(wolk->m_dataService)),
-                addSensorReading(Matcher<const std::string&>(_), Matcher<const std::vector<std::string>&>(_),
+                addSensorReading(Matcher<wolkabout::ReferenceHandle>(secondHandle),
+                                 Matcher<const wolkabout::ReadingValue&>(multiValue),
                                  Matcher<unsigned long long>(_)))
       .Times(1)
       .WillRepeatedly(testing::InvokeWithoutArgs(this, &WolkTests::onEvent));
@@ -219,6 +359,56 @@ TEST_F(WolkTests, AddingSensors)
     waitEvents(2);
 }
 
+TEST_F(WolkTests, AddingSensorBatches)
+{
+    builder = std::make_shared<wolkabout::WolkBuilder>(*noActuatorsDevice);
+    ASSERT_NO_THROW(builder->withoutKeepAlive());
+    const auto& wolk = builder->build();
+
+    auto connectivityServiceMock =
+      std::unique_ptr<ConnectivityServiceMock>(new ::testing::NiceMock<ConnectivityServiceMock>());
+    auto dataProtocolMock = std::unique_ptr<DataProtocolMock>(new ::testing::NiceMock<DataProtocolMock>());
+    auto persistenceMock = std::unique_ptr<PersistenceMock>(new ::testing::NiceMock<PersistenceMock>());
+    auto dataServiceMock = std::unique_ptr<DataServiceMock>(new ::testing::NiceMock<DataServiceMock>(
+      noActuatorsDevice->getKey(), *dataProtocolMock, *persistenceMock, *connectivityServiceMock));
+
+    wolk->m_dataService = std::move(dataServiceMock);
+
+    std::vector<std::vector<wolkabout::ReadingEntry>> batches;
+    EXPECT_CALL(dynamic_cast<DataServiceMock&>(*(wolk->m_dataService)), addSensorReadings)
+      .Times(2)
+      .WillRepeatedly(testing::Invoke([&](const std::vector<wolkabout::ReadingEntry>& readings) {
+          batches.push_back(readings);
+          onEvent();
+      }));
+
+    EXPECT_CALL(dynamic_cast<DataServiceMock&>(*(wolk->m_dataService)),
+                addSensorReading(Matcher<wolkabout::ReferenceHandle>(_), Matcher<const wolkabout::ReadingValue&>(_),
+                                 Matcher<unsigned long long>(_)))
+      .Times(0);
+
+    EXPECT_NO_FATAL_FAILURE(wolk->addSensorReadings({{"TEST_REF1", 1}, {"TEST_REF2", "TEXT", 5}}));
+    EXPECT_NO_FATAL_FAILURE(wolk->addSnapshot(10, {{"TEST_REF1", 2}, {"TEST_REF2", 2.5}}));
+    // Empty test
+    EXPECT_NO_FATAL_FAILURE(wolk->addSensorReadings({}));
+
+    waitEvents(2);
+
+    ASSERT_EQ(2, batches.size());
+
+    ASSERT_EQ(2, batches[0].size());
+    EXPECT_EQ(wolkabout::ReadingValue{1}, batches[0][0].value);
+    EXPECT_NE(0, batches[0][0].rtc);
+    EXPECT_EQ(wolkabout::ReadingValue{"TEXT"}, batches[0][1].value);
+    EXPECT_EQ(5, batches[0][1].rtc);
+
+    ASSERT_EQ(2, batches[1].size());
+    EXPECT_EQ("TEST_REF1", batches[1][0].reference);
+    EXPECT_EQ("TEST_REF2", batches[1][1].reference);
+    EXPECT_EQ(10, batches[1][0].rtc);
+    EXPECT_EQ(10, batches[1][1].rtc);
+}
+
 TEST_F(WolkTests, AddAlarms)
 {
     builder = std::make_shared<wolkabout::WolkBuilder>(*noActuatorsDevice);
@@ -234,7 +424,8 @@ TEST_F(WolkTests, AddAlarms)
 
     wolk->m_dataService = std::move(dataServiceMock);
 
-    EXPECT_CALL(dynamic_cast<DataServiceMock&>(*(wolk->m_dataService)), addAlarm)
+    EXPECT_CALL(dynamic_cast<DataServiceMock&>(*(wolk->m_dataService)),
+                addAlarm(Matcher<wolkabout::ReferenceHandle>(_), _, _))
       .Times(1)
       .WillRepeatedly(testing::InvokeWithoutArgs(this, &WolkTests::onEvent));
 
@@ -243,6 +434,117 @@ TEST_F(WolkTests, AddAlarms)
     waitEvents(1);
 }
 
+TEST_F(WolkTests, AddingByHandle)
+{
+    builder = std::make_shared<wolkabout::WolkBuilder>(*noActuatorsDevice);
+    ASSERT_NO_THROW(builder->withoutKeepAlive());
+    const auto& wolk = builder->build();
+
+    auto connectivityServiceMock =
+      std::unique_ptr<ConnectivityServiceMock>(new ::testing::NiceMock<ConnectivityServiceMock>());
+    auto dataProtocolMock = std::unique_ptr<DataProtocolMock>(new ::testing::NiceMock<DataProtocolMock>());
+    auto persistenceMock = std::unique_ptr<PersistenceMock>(new ::testing::NiceMock<PersistenceMock>());
+    auto dataServiceMock = std::unique_ptr<DataServiceMock>(new ::testing::NiceMock<DataServiceMock>(
+      noActuatorsDevice->getKey(), *dataProtocolMock, *persistenceMock, *connectivityServiceMock));
+
+    wolk->m_dataService = std::move(dataServiceMock);
+
+    const auto sensor = wolk->registerReference("TEST_REF1");
+    const auto alarm = wolk->registerReference("TEST_ALARM_REF1");
+    EXPECT_TRUE(sensor.isValid());
+    EXPECT_NE(sensor, alarm);
+    EXPECT_EQ(sensor, wolk->registerReference("TEST_REF1"));
+
+    const wolkabout::ReadingValue value{25};
+
+    EXPECT_CALL(dynamic_cast<DataServiceMock&>(*(wolk->m_dataService)),
+                addSensorReading(Matcher<wolkabout::ReferenceHandle>(sensor),
+                                 Matcher<const wolkabout::ReadingValue&>(value), Matcher<unsigned long long>(_)))
+      .Times(1)
+      .WillRepeatedly(testing::InvokeWithoutArgs(this, &WolkTests::onEvent));
+
+    EXPECT_CALL(dynamic_cast<DataServiceMock&>(*(wolk->m_dataService)),
+                addAlarm(Matcher<wolkabout::ReferenceHandle>(alarm), true, _))
+      .Times(1)
+      .WillRepeatedly(testing::InvokeWithoutArgs(this, &WolkTests::onEvent));
+
+    EXPECT_NO_FATAL_FAILURE(wolk->addSensorReading(sensor, 25));
+    EXPECT_NO_FATAL_FAILURE(wolk->addAlarm(alarm, true));
+
+    waitEvents(2);
+}
+
+TEST_F(WolkTests, PublishReportsResult)
+{
+    builder = std::make_shared<wolkabout::WolkBuilder>(*noActuatorsDevice);
+    ASSERT_NO_THROW(builder->withoutKeepAlive());
+    const auto& wolk = builder->build();
+
+    auto connectivityServiceMock =
+      std::unique_ptr<ConnectivityServiceMock>(new ::testing::NiceMock<ConnectivityServiceMock>());
+    auto dataProtocolMock = std::unique_ptr<DataProtocolMock>(new ::testing::NiceMock<DataProtocolMock>());
+    auto persistenceMock = std::unique_ptr<PersistenceMock>(new ::testing::NiceMock<PersistenceMock>());
+    auto dataServiceMock = std::unique_ptr<DataServiceMock>(new ::testing::NiceMock<DataServiceMock>(
+      noActuatorsDevice->getKey(), *dataProtocolMock, *persistenceMock, *connectivityServiceMock));
+
+    wolk->m_dataService = std::move(dataServiceMock);
+
+    wolkabout::PublishCounts readings;
+    readings.sent = 50;
+    readings.remaining = 10;
+
+    wolkabout::PublishCounts alarms;
+    alarms.sent = 2;
+
+    EXPECT_CALL(dynamic_cast<DataServiceMock&>(*(wolk->m_dataService)), publishSensorReadings)
+      .WillOnce(testing::Return(readings));
+    EXPECT_CALL(dynamic_cast<DataServiceMock&>(*(wolk->m_dataService)), publishAlarms).WillOnce(testing::Return(alarms));
+
+    auto future = wolk->publishWithResult();
+    ASSERT_EQ(std::future_status::ready, future.wait_for(std::chrono::seconds(1)));
+
+    const auto result = future.get();
+    EXPECT_EQ(50, result.sensorReadings.sent);
+    EXPECT_EQ(10, result.sensorReadings.remaining);
+    EXPECT_EQ(2, result.alarms.sent);
+    EXPECT_EQ(0, result.actuatorStatuses.sent);
+    EXPECT_TRUE(result.stalled());
+}
+
+TEST_F(WolkTests, FlushPolicyPublishesOnThresholds)
+{
+    wolkabout::FlushPolicy policy;
+    policy.maxItems = 3;
+    policy.alarmDeadline = std::chrono::milliseconds{50};
+
+    builder = std::make_shared<wolkabout::WolkBuilder>(*noActuatorsDevice);
+    ASSERT_NO_THROW(builder->withoutKeepAlive().withFlushPolicy(policy));
+    const auto& wolk = builder->build();
+
+    auto connectivityServiceMock =
+      std::unique_ptr<ConnectivityServiceMock>(new ::testing::NiceMock<ConnectivityServiceMock>());
+    auto dataProtocolMock = std::unique_ptr<DataProtocolMock>(new ::testing::NiceMock<DataProtocolMock>());
+    auto persistenceMock = std::unique_ptr<PersistenceMock>(new ::testing::NiceMock<PersistenceMock>());
+    auto dataServiceMock = std::unique_ptr<DataServiceMock>(new ::testing::NiceMock<DataServiceMock>(
+      noActuatorsDevice->getKey(), *dataProtocolMock, *persistenceMock, *connectivityServiceMock));
+
+    wolk->m_dataService = std::move(dataServiceMock);
+
+    EXPECT_CALL(dynamic_cast<DataServiceMock&>(*(wolk->m_dataService)), publishSensorReadings)
+      .Times(1)
+      .WillOnce(testing::DoAll(testing::InvokeWithoutArgs(this, &WolkTests::onEvent),
+                               testing::Return(wolkabout::PublishCounts{})));
+    EXPECT_CALL(dynamic_cast<DataServiceMock&>(*(wolk->m_dataService)), publishAlarms)
+      .Times(1)
+      .WillOnce(testing::DoAll(testing::InvokeWithoutArgs(this, &WolkTests::onEvent),
+                               testing::Return(wolkabout::PublishCounts{})));
+
+    EXPECT_NO_FATAL_FAILURE(wolk->addSensorReadings({{"TEST_REF1", 1}, {"TEST_REF2", 2}, {"TEST_REF3", 3}}));
+    EXPECT_NO_FATAL_FAILURE(wolk->addAlarm("TEST_ALARM_REF1", true));
+
+    waitEvents(2);
+}
+
 TEST_F(WolkTests, HandleActuatorCommands)
 {
     builder = std::make_shared<wolkabout::WolkBuilder>(*device);
@@ -32,15 +32,21 @@ public:
     MOCK_METHOD(void, addSensorReading, (const std::string&, const std::string&, unsigned long long int), (override));
     MOCK_METHOD(void, addSensorReading, (const std::string&, const std::vector<std::string>&, unsigned long long int),
                 (override));
+    MOCK_METHOD(void, addSensorReading, (const std::string&, const wolkabout::ReadingValue&, unsigned long long int),
+                (override));
+    MOCK_METHOD(void, addSensorReading,
+                (wolkabout::ReferenceHandle, const wolkabout::ReadingValue&, unsigned long long int), (override));
+    MOCK_METHOD(void, addSensorReadings, (const std::vector<wolkabout::ReadingEntry>&), (override));
     MOCK_METHOD(void, addActuatorStatus, (const std::string&, const std::string&, wolkabout::ActuatorStatus::State),
                 (override));
     MOCK_METHOD(void, addAlarm, (const std::string&, bool, unsigned long long int), (override));
+    MOCK_METHOD(void, addAlarm, (wolkabout::ReferenceHandle, bool, unsigned long long int), (override));
     MOCK_METHOD(void, addConfiguration, (const std::vector<wolkabout::ConfigurationItem>&), (override));
 
-    MOCK_METHOD(void, publishSensorReadings, (), (override));
-    MOCK_METHOD(void, publishActuatorStatuses, (), (override));
-    MOCK_METHOD(void, publishAlarms, (), (override));
-    MOCK_METHOD(void, publishConfiguration, (), (override));
+    MOCK_METHOD(wolkabout::PublishCounts, publishSensorReadings, (), (override));
+    MOCK_METHOD(wolkabout::PublishCounts, publishActuatorStatuses, (), (override));
+    MOCK_METHOD(wolkabout::PublishCounts, publishAlarms, (), (override));
+    MOCK_METHOD(wolkabout::PublishCounts, publishConfiguration, (), (override));
 };
 
 #endif    // WOLKABOUTCONNECTOR_DATASERVICEMOCK_H
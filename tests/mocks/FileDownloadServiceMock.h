@@ -36,6 +36,7 @@ public:
 
     MOCK_METHOD(void, messageReceived, (std::shared_ptr<wolkabout::Message>), (override));
     MOCK_METHOD(void, sendFileList, (), (override));
+    MOCK_METHOD(void, syncFileList, (), (override));
 };
 
 #endif    // WOLKABOUTCONNECTOR_FILEDOWNLOADSERVICEMOCK_H